@@ -0,0 +1,139 @@
+/* 
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org 
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+
+#include "iCub/tactileGrasp/AllocationCounter.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+using iCub::tactileGrasp::AllocationCounter;
+using iCub::tactileGrasp::AllocationGuard;
+
+
+#ifdef TACTILEGRASP_CHECK_ALLOCATIONS
+namespace {
+    /** True while the calling thread is counting its allocations. */
+    thread_local bool counting = false;
+    /** Number of allocations performed by the calling thread while counting. */
+    thread_local unsigned long allocations = 0;
+
+    void *countedAlloc(std::size_t size) {
+        if (counting) {
+            ++allocations;
+        }
+        return std::malloc(size ? size : 1);
+    }
+}
+
+void *operator new(std::size_t size) {
+    void *p = countedAlloc(size);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void *operator new[](std::size_t size) {
+    void *p = countedAlloc(size);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept {
+    return countedAlloc(size);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept {
+    return countedAlloc(size);
+}
+
+void operator delete(void *p) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void *p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void *p, std::size_t) noexcept {
+    std::free(p);
+}
+#endif
+
+
+/* *********************************************************************************************************************** */
+/* ******* Start counting allocations                                       ********************************************** */
+void AllocationCounter::start(void) {
+#ifdef TACTILEGRASP_CHECK_ALLOCATIONS
+    allocations = 0;
+    counting = true;
+#endif
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Stop counting allocations                                        ********************************************** */
+unsigned long AllocationCounter::stop(void) {
+#ifdef TACTILEGRASP_CHECK_ALLOCATIONS
+    counting = false;
+    return allocations;
+#else
+    return 0;
+#endif
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Check whether allocation counting is compiled in                 ********************************************** */
+bool AllocationCounter::isEnabled(void) {
+#ifdef TACTILEGRASP_CHECK_ALLOCATIONS
+    return true;
+#else
+    return false;
+#endif
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Scoped allocation check                                          ********************************************** */
+AllocationGuard::AllocationGuard(const char *aTag)
+    : tag(aTag) {
+        AllocationCounter::start();
+}
+
+AllocationGuard::~AllocationGuard() {
+    unsigned long n = AllocationCounter::stop();
+    if (n > 0) {
+        // Use stdio as iostreams may allocate
+        std::fprintf(stderr, "%sPerformed %lu heap allocations in the control tick. Aborting. \n", tag, n);
+        std::abort();
+    }
+}
+/* *********************************************************************************************************************** */
@@ -0,0 +1,461 @@
+/* 
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org 
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+#include "iCub/tactileGrasp/AsyncLog.h"
+
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+
+#include <yarp/os/Time.h>
+#include <yarp/os/Value.h>
+
+using std::cerr;
+using std::cout;
+
+using iCub::tactileGrasp::AsyncLog;
+using iCub::tactileGrasp::LogLevel;
+
+using yarp::os::Value;
+
+
+/* *********************************************************************************************************************** */
+/* ******* Constructor                                                      ********************************************** */   
+AsyncLog::AsyncLog() : RateThread(20), cells(NULL), mask(0), enqueuePos(0), dequeuePos(0), dropped(0), droppedReported(0), 
+    level(LogLevel::Info), rateLimit(0), console(true), file(NULL), draining(false) {
+        for (int i = 0; i < RateSlots; ++i) {
+            rateSlots[i].format = NULL;
+            rateSlots[i].windowStart = 0;
+            rateSlots[i].count = 0;
+            rateSlots[i].suppressed = 0;
+        }
+
+        // Default ring, until configured
+        mask = 255;
+        cells = new Cell[mask + 1];
+        for (size_t i = 0; i <= mask; ++i) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+
+        dbgTag = "AsyncLog: ";
+}
+
+AsyncLog::~AsyncLog() {
+    if (file) {
+        fclose(file);
+    }
+    delete[] cells;
+}
+
+AsyncLog &AsyncLog::get(void) {
+    static AsyncLog instance;
+    return instance;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Configure the log                                                ********************************************** */   
+bool AsyncLog::configure(yarp::os::ResourceFinder &rf) {
+    yarp::os::Bottle &confLog = rf.findGroup("log");
+
+    std::string levelName = confLog.check("level", Value("info")).asString().c_str();
+    if (levelName == "off") {
+        level = LogLevel::Off;
+    } else if (levelName == "error") {
+        level = LogLevel::Error;
+    } else if (levelName == "warning") {
+        level = LogLevel::Warning;
+    } else if (levelName == "info") {
+        level = LogLevel::Info;
+    } else if (levelName == "debug") {
+        level = LogLevel::Debug;
+    } else {
+        cerr << dbgTag << "Invalid [log] level " << levelName << ". Expected off, error, warning, info or debug. \n";
+        return false;
+    }
+    rateLimit = std::max(0, confLog.check("rateLimit", Value(10)).asInt());
+    console = (confLog.check("console", Value("on")).asString() == "on");
+    setRate(std::max(1, confLog.check("flushPeriod", Value(20)).asInt()));
+
+    // Ring size, rounded up to a power of two
+    int bufferSize = std::max(2, confLog.check("bufferSize", Value(1024)).asInt());
+    size_t size = 2;
+    while (size < static_cast<size_t>(bufferSize)) {
+        size <<= 1;
+    }
+    flushMutex.lock();
+    drain();
+    delete[] cells;
+    mask = size - 1;
+    cells = new Cell[size];
+    for (size_t i = 0; i < size; ++i) {
+        cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    enqueuePos = 0;
+    dequeuePos = 0;
+    flushMutex.unlock();
+
+    // Log file
+    std::string path = confLog.check("file", Value("")).asString().c_str();
+    if (!path.empty()) {
+        file = fopen(path.c_str(), "a");
+        if (!file) {
+            cerr << dbgTag << "Could not open the log file " << path << ". \n";
+            return false;
+        }
+    }
+
+    cout << dbgTag << "Logging at level " << levelName << (path.empty() ? "" : " to ") << path << " with up to " << rateLimit 
+        << " messages per second per call site. \n";
+
+    return true;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Log thread                                                       ********************************************** */   
+bool AsyncLog::threadInit(void) {
+    draining = true;
+    return true;
+}
+
+void AsyncLog::run(void) {
+    flushMutex.lock();
+    drain();
+    flushMutex.unlock();
+}
+
+void AsyncLog::threadRelease(void) {
+    // The producers write their own messages from now on
+    draining = false;
+    flushMutex.lock();
+    drain();
+    flushMutex.unlock();
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Log a vector                                                     ********************************************** */   
+void AsyncLog::logVector(const int &i_level, const std::string &i_tag, const char *i_text, const double *i_values, const size_t &i_count) {
+    AsyncLog &logger = get();
+    if (!logger.isEnabled(i_level)) {
+        return;
+    }
+    Cell *cell = logger.claim(i_level, i_tag, i_text);
+    if (cell) {
+        LogRecord &record = cell->record;
+        record.vector = true;
+        record.nArgs = static_cast<int>(std::min(i_count, static_cast<size_t>(MaxArgs)));
+        for (int i = 0; i < record.nArgs; ++i) {
+            record.args[i].type = LogArg::Real;
+            record.args[i].d = i_values[i];
+        }
+        logger.commit(cell);
+    }
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Reserve a slot                                                   ********************************************** */   
+AsyncLog::Cell *AsyncLog::claim(const int &i_level, const std::string &i_tag, const char *i_format) {
+    double now = yarp::os::Time::now();
+
+    // Rate limit of the call site
+    unsigned long suppressed = 0;
+    if (rateLimit > 0) {
+        RateSlot *slot = findRateSlot(i_format);
+        if (slot) {
+            long long now_us = static_cast<long long>(now * 1e6);
+            if (now_us - slot->windowStart.load(std::memory_order_relaxed) >= 1000000) {
+                slot->windowStart.store(now_us, std::memory_order_relaxed);
+                slot->count.store(0, std::memory_order_relaxed);
+            }
+            if (slot->count.fetch_add(1, std::memory_order_relaxed) >= rateLimit) {
+                slot->suppressed.fetch_add(1, std::memory_order_relaxed);
+                return NULL;
+            }
+            suppressed = slot->suppressed.exchange(0, std::memory_order_relaxed);
+        }
+    }
+
+    // Bounded multi-producer ring
+    size_t pos = enqueuePos.load(std::memory_order_relaxed);
+    Cell *cell = NULL;
+    for (;;) {
+        cell = &cells[pos & mask];
+        size_t sequence = cell->sequence.load(std::memory_order_acquire);
+        intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+        if (difference == 0) {
+            if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (difference < 0) {
+            // Full: never wait for the writer
+            dropped.fetch_add(1 + suppressed, std::memory_order_relaxed);
+            return NULL;
+        } else {
+            pos = enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    LogRecord &record = cell->record;
+    record.time = now;
+    record.level = i_level;
+    record.format = i_format;
+    record.vector = false;
+    record.nArgs = 0;
+    record.suppressed = suppressed;
+    strncpy(record.tag, i_tag.c_str(), MaxTag - 1);
+    record.tag[MaxTag - 1] = '\0';
+    record.stringsUsed = 0;
+
+    return cell;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Hand a slot to the writer                                        ********************************************** */   
+void AsyncLog::commit(Cell *io_cell) {
+    size_t pos = io_cell->sequence.load(std::memory_order_relaxed);
+    io_cell->sequence.store(pos + 1, std::memory_order_release);
+
+    if (!draining.load(std::memory_order_relaxed)) {
+        flushMutex.lock();
+        drain();
+        flushMutex.unlock();
+    }
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Write the ready messages                                         ********************************************** */   
+void AsyncLog::drain(void) {
+    bool written = false;
+    for (;;) {
+        Cell &cell = cells[dequeuePos & mask];
+        if (cell.sequence.load(std::memory_order_acquire) != dequeuePos + 1) {
+            break;
+        }
+
+        const LogRecord &record = cell.record;
+        size_t length = format(record);
+        if (console) {
+            fwrite(line, 1, length, (record.level <= LogLevel::Warning) ? stderr : stdout);
+        }
+        if (file) {
+            fprintf(file, "%.6f ", record.time);
+            fwrite(line, 1, length, file);
+        }
+        written = true;
+
+        // Free the slot for the next round of the ring
+        cell.sequence.store(dequeuePos + mask + 1, std::memory_order_release);
+        ++dequeuePos;
+    }
+
+    unsigned long nDropped = dropped.load(std::memory_order_relaxed);
+    if (nDropped != droppedReported) {
+        int length = snprintf(line, sizeof(line), "%s%lu log messages dropped because the log buffer was full. \n", dbgTag.c_str(), nDropped - droppedReported);
+        length = std::min(length, static_cast<int>(sizeof(line)) - 1);
+        if (console) {
+            fwrite(line, 1, length, stderr);
+        }
+        if (file) {
+            fwrite(line, 1, length, file);
+        }
+        droppedReported = nDropped;
+        written = true;
+    }
+
+    if (written) {
+        if (console) {
+            fflush(stdout);
+        }
+        if (file) {
+            fflush(file);
+        }
+    }
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Format a message                                                 ********************************************** */   
+size_t AsyncLog::format(const LogRecord &i_record) {
+    // Room for the new line
+    const size_t size = sizeof(line) - 2;
+    size_t length = 0;
+
+    if (i_record.level == LogLevel::Debug) {
+        append(length, "DEBUG: ");
+    }
+    append(length, "%s", i_record.tag);
+
+    if (i_record.vector) {
+        append(length, "%s", i_record.format);
+        for (int i = 0; i < i_record.nArgs; ++i) {
+            append(length, " %g", i_record.args[i].d);
+        }
+    } else {
+        // Walk the format, formatting each conversion with the type of its conversion character
+        int arg = 0;
+        const char *c = i_record.format;
+        while (*c && (length < size - 1)) {
+            if (*c != '%') {
+                line[length++] = *c++;
+                continue;
+            }
+            if (c[1] == '%') {
+                line[length++] = '%';
+                c += 2;
+                continue;
+            }
+
+            // Copy the flags, width and precision, dropping the length modifiers
+            char spec[32];
+            size_t s = 0;
+            spec[s++] = *c++;
+            while (*c && strchr("-+ #0123456789.", *c) && (s < sizeof(spec) - 4)) {
+                spec[s++] = *c++;
+            }
+            while (*c && strchr("hlLqjzt", *c)) {
+                ++c;
+            }
+            char conversion = *c;
+            if (!conversion) {
+                break;
+            }
+            ++c;
+
+            if (arg >= i_record.nArgs) {
+                append(length, "<missing>");
+                continue;
+            }
+            const LogArg &value = i_record.args[arg++];
+            if (strchr("diouxXc", conversion)) {
+                spec[s++] = 'l';
+                spec[s++] = 'l';
+                spec[s++] = conversion;
+                spec[s] = '\0';
+                long long integer = (value.type == LogArg::Real) ? static_cast<long long>(value.d) : ((value.type == LogArg::Integer) ? value.i : 0);
+                if (conversion == 'c') {
+                    spec[s - 3] = 'c';
+                    spec[s - 2] = '\0';
+                    append(length, spec, static_cast<int>(integer));
+                } else {
+                    append(length, spec, integer);
+                }
+            } else if (strchr("eEfFgGaA", conversion)) {
+                spec[s++] = conversion;
+                spec[s] = '\0';
+                double real = (value.type == LogArg::Integer) ? static_cast<double>(value.i) : ((value.type == LogArg::Real) ? value.d : 0.0);
+                append(length, spec, real);
+            } else if (conversion == 's') {
+                spec[s++] = 's';
+                spec[s] = '\0';
+                if (value.type == LogArg::String) {
+                    append(length, spec, i_record.strings + value.s);
+                } else if (value.type == LogArg::Integer) {
+                    append(length, "%lld", value.i);
+                } else {
+                    append(length, "%g", value.d);
+                }
+            } else {
+                append(length, "<invalid>");
+            }
+        }
+    }
+
+    if (i_record.suppressed > 0) {
+        append(length, " (%lu similar messages suppressed)", i_record.suppressed);
+    }
+
+    line[length++] = '\n';
+    line[length] = '\0';
+    return length;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Rate limit state of a call site                                  ********************************************** */   
+AsyncLog::RateSlot *AsyncLog::findRateSlot(const char *i_format) {
+    size_t hash = (reinterpret_cast<uintptr_t>(i_format) >> 3) % RateSlots;
+    for (int probe = 0; probe < 8; ++probe) {
+        RateSlot &slot = rateSlots[(hash + probe) % RateSlots];
+        const char *format = slot.format.load(std::memory_order_acquire);
+        if (format == i_format) {
+            return &slot;
+        }
+        if (!format) {
+            const char *expected = NULL;
+            if (slot.format.compare_exchange_strong(expected, i_format) || (expected == i_format)) {
+                return &slot;
+            }
+        }
+    }
+
+    return NULL;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Argument packing                                                 ********************************************** */   
+void AsyncLog::addArg(LogRecord &io_record, const long long &i_value) {
+    if (io_record.nArgs < MaxArgs) {
+        LogArg &arg = io_record.args[io_record.nArgs++];
+        arg.type = LogArg::Integer;
+        arg.i = i_value;
+    }
+}
+
+void AsyncLog::addArg(LogRecord &io_record, const double &i_value) {
+    if (io_record.nArgs < MaxArgs) {
+        LogArg &arg = io_record.args[io_record.nArgs++];
+        arg.type = LogArg::Real;
+        arg.d = i_value;
+    }
+}
+
+void AsyncLog::addArg(LogRecord &io_record, const char *i_value) {
+    if (io_record.nArgs < MaxArgs) {
+        LogArg &arg = io_record.args[io_record.nArgs++];
+        arg.type = LogArg::String;
+        // Copy what fits of the string
+        int available = MaxStrings - io_record.stringsUsed;
+        if (available <= 0) {
+            arg.type = LogArg::Integer;
+            arg.i = 0;
+            return;
+        }
+        arg.s = io_record.stringsUsed;
+        strncpy(io_record.strings + arg.s, (i_value ? i_value : "(null)"), available - 1);
+        io_record.strings[arg.s + available - 1] = '\0';
+        io_record.stringsUsed += static_cast<int>(strlen(io_record.strings + arg.s)) + 1;
+    }
+}
+/* *********************************************************************************************************************** */
@@ -0,0 +1,242 @@
+/* 
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org 
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+#include "iCub/tactileGrasp/ContactPredictor.h"
+
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+
+#include <yarp/os/Value.h>
+
+using std::cerr;
+using std::cout;
+
+using iCub::tactileGrasp::ContactPredictor;
+
+using yarp::os::Value;
+
+
+/* *********************************************************************************************************************** */
+/* ******* Constructor                                                      ********************************************** */   
+ContactPredictor::ContactPredictor() {
+    enabled = false;
+    window = 4;
+    minRatio = 0.3;
+    leadTime = 0.01;
+    actuationDelay = 0.02;
+    calibrate = true;
+    confirmTime = 0.1;
+    creepScale = 0.2;
+
+    pipelineLatency = 0.0;
+    latencySamples = 0;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Configure the predictor                                          ********************************************** */   
+bool ContactPredictor::configure(yarp::os::Searchable &rf, const int &i_nFingers) {
+    using yarp::os::Bottle;
+
+    Bottle &confPrediction = rf.findGroup("prediction");
+    enabled = (confPrediction.check("enabled", Value("off")).asString() == "on");
+    window = confPrediction.check("window", Value(4)).asInt();
+    minRatio = confPrediction.check("minRatio", Value(0.3)).asDouble();
+    leadTime = confPrediction.check("leadTime", Value(0.01)).asDouble();
+    actuationDelay = confPrediction.check("actuationDelay", Value(0.02)).asDouble();
+    calibrate = (confPrediction.check("calibrate", Value("on")).asString() == "on");
+    confirmTime = confPrediction.check("confirmTime", Value(0.1)).asDouble();
+    creepScale = confPrediction.check("creepScale", Value(0.2)).asDouble();
+    if ((window < 2) || (window > 16)) {
+        cerr << "ContactPredictor: The [prediction] window must be between 2 and 16 samples. \n";
+        return false;
+    }
+    if ((creepScale < 0.0) || (creepScale > 1.0)) {
+        cerr << "ContactPredictor: The [prediction] creepScale must be between 0 and 1. \n";
+        return false;
+    }
+
+    times.assign(i_nFingers * window, 0.0);
+    values.assign(i_nFingers * window, 0.0);
+    fingers.resize(i_nFingers);
+    pipelineLatency = 0.0;
+    latencySamples = 0;
+    reset();
+    resetStats();
+
+    if (enabled) {
+        cout << "ContactPredictor: Stopping the fingers " << leadTime << " s ahead of the forecast contacts, with an actuation delay of " 
+            << actuationDelay << " s" << (calibrate ? " plus the measured skin-to-command latency. \n" : ". \n");
+    }
+
+    return true;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Forecast the crossing of a fingertip                             ********************************************** */   
+double ContactPredictor::update(const int &i_finger, const double &i_time, const double &i_maxTaxel, const double &i_threshold) {
+    FingerForecast &finger = fingers[i_finger];
+    if (i_threshold <= 0.0) {
+        return 1.0;
+    }
+
+    // History of the maximum taxel
+    double *fingerTimes = &times[i_finger * window];
+    double *fingerValues = &values[i_finger * window];
+    fingerTimes[finger.head] = i_time;
+    fingerValues[finger.head] = i_maxTaxel;
+    finger.head = (finger.head + 1) % window;
+    if (finger.count < window) {
+        ++finger.count;
+    }
+
+    // Actual crossing
+    if (i_maxTaxel >= i_threshold) {
+        if (finger.stopping) {
+            double error = finger.predictedCross - i_time;
+            finger.errorSum += error;
+            finger.absErrorSum += std::fabs(error);
+            finger.maxAbsError = std::max(finger.maxAbsError, std::fabs(error));
+            ++finger.confirmed;
+            finger.stopping = false;
+        }
+        finger.creeping = false;
+        finger.crossed = true;
+        return 1.0;
+    }
+    if (finger.crossed) {
+        // Wait for the fingertip to leave the object before forecasting again
+        if (i_maxTaxel < minRatio * i_threshold) {
+            finger.crossed = false;
+        }
+        return 1.0;
+    }
+
+    // Unconfirmed forecast: let the finger creep on to the contact
+    if (finger.stopping) {
+        if (i_time <= finger.stopUntil) {
+            return 0.0;
+        }
+        finger.stopping = false;
+        finger.creeping = true;
+        ++finger.expired;
+    }
+    if (finger.creeping) {
+        // Until the crossing, unless the object went away
+        if (i_maxTaxel >= minRatio * i_threshold) {
+            return creepScale;
+        }
+        finger.creeping = false;
+    }
+
+    if ((finger.count < 2) || (i_maxTaxel < minRatio * i_threshold)) {
+        return 1.0;
+    }
+
+    // Least squares slope of the history, with the times relative to the last sample
+    double meanTime = 0.0;
+    double meanValue = 0.0;
+    for (int s = 0; s < finger.count; ++s) {
+        meanTime += fingerTimes[s] - i_time;
+        meanValue += fingerValues[s];
+    }
+    meanTime /= finger.count;
+    meanValue /= finger.count;
+    double covariance = 0.0;
+    double variance = 0.0;
+    for (int s = 0; s < finger.count; ++s) {
+        double dt = fingerTimes[s] - i_time - meanTime;
+        covariance += dt * (fingerValues[s] - meanValue);
+        variance += dt * dt;
+    }
+    if ((variance <= 0.0) || (covariance <= 0.0)) {
+        return 1.0;
+    }
+    double slope = covariance / variance;
+
+    double timeToCross = (i_threshold - i_maxTaxel) / slope;
+    if (timeToCross <= leadTime + getBudget()) {
+        finger.stopping = true;
+        finger.predictedCross = i_time + timeToCross;
+        finger.stopUntil = finger.predictedCross + confirmTime;
+        ++finger.predictions;
+        return 0.0;
+    }
+
+    return 1.0;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Calibrate the latency budget                                     ********************************************** */   
+void ContactPredictor::recordLatency(const double &i_latency) {
+    if (latencySamples == 0) {
+        pipelineLatency = i_latency;
+    } else {
+        pipelineLatency += 0.1 * (i_latency - pipelineLatency);
+    }
+    ++latencySamples;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Reset                                                            ********************************************** */   
+void ContactPredictor::reset(void) {
+    for (size_t i = 0; i < fingers.size(); ++i) {
+        fingers[i].count = 0;
+        fingers[i].head = 0;
+        fingers[i].stopping = false;
+        fingers[i].creeping = false;
+        fingers[i].crossed = false;
+        fingers[i].predictedCross = -1.0;
+        fingers[i].stopUntil = -1.0;
+    }
+}
+
+void ContactPredictor::resetStats(void) {
+    for (size_t i = 0; i < fingers.size(); ++i) {
+        fingers[i].predictions = 0;
+        fingers[i].confirmed = 0;
+        fingers[i].expired = 0;
+        fingers[i].errorSum = 0.0;
+        fingers[i].absErrorSum = 0.0;
+        fingers[i].maxAbsError = 0.0;
+    }
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Forecast errors                                                  ********************************************** */   
+double ContactPredictor::getMeanError(const int &i_finger) const {
+    const FingerForecast &finger = fingers[i_finger];
+    return (finger.confirmed > 0) ? finger.errorSum / finger.confirmed : 0.0;
+}
+
+double ContactPredictor::getMeanAbsError(const int &i_finger) const {
+    const FingerForecast &finger = fingers[i_finger];
+    return (finger.confirmed > 0) ? finger.absErrorSum / finger.confirmed : 0.0;
+}
+/* *********************************************************************************************************************** */
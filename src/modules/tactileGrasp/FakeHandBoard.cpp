@@ -0,0 +1,764 @@
+/* 
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org 
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+
+#include "iCub/tactileGrasp/FakeHandBoard.h"
+
+#include <iostream>
+#include <cstdlib>
+#include <cmath>
+
+#include <yarp/os/Time.h>
+#include <yarp/os/Bottle.h>
+#include <yarp/dev/Drivers.h>
+
+using std::cerr;
+using std::cout;
+using std::string;
+using std::vector;
+
+using iCub::tactileGrasp::FakeHandBoard;
+using iCub::tactileGrasp::SimFingerEvents;
+
+using yarp::os::Bottle;
+using yarp::os::Value;
+using yarp::os::Time;
+
+
+namespace {
+    /** Maximum number of velocity commands waiting for the actuation latency. */
+    const int maxPendingCommands = 64;
+}
+
+
+/* *********************************************************************************************************************** */
+/* ******* Updater thread                                                   ********************************************** */
+FakeHandBoard::Updater::Updater(FakeHandBoard &aBoard, const int aPeriod)
+    : RateThread(aPeriod), board(aBoard) {}
+
+void FakeHandBoard::Updater::run(void) {
+    board.update();
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Constructor                                                      ********************************************** */   
+FakeHandBoard::FakeHandBoard() {
+    nJoints = 0;
+    lastUpdate = 0.0;
+    commandLatency = 0.0;
+    pendingHead = 0;
+    pendingCount = 0;
+    stiffness = 0.0;
+    maxPenetration = 0.0;
+    noise = 0.0;
+    skinPeriod = 0.0;
+    lastSkin = 0.0;
+    skinSize = 0;
+    publishRaw = false;
+    rawBaseline = 0.0;
+    rawDrift = 0.0;
+    rawStart = 0.0;
+    trialStart = -1.0;
+    updater = NULL;
+
+    dbgTag = "FakeHandBoard: ";
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Destructor                                                       ********************************************** */   
+FakeHandBoard::~FakeHandBoard() {
+    close();
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Register the device                                              ********************************************** */   
+void FakeHandBoard::registerDevice(void) {
+    yarp::dev::Drivers::factory().add(new yarp::dev::DriverCreatorOf<FakeHandBoard>("fakeHandBoard", "controlboard", "iCub::tactileGrasp::FakeHandBoard"));
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Open the device                                                  ********************************************** */   
+bool FakeHandBoard::open(yarp::os::Searchable &config) {
+    cout << dbgTag << "Opening. \n";
+
+    // Kinematics
+    nJoints = config.check("axes", Value(16)).asInt();
+    positions.assign(nJoints, 0.0);
+    velocities.assign(nJoints, 0.0);
+    targets.assign(nJoints, 0.0);
+    refSpeeds.assign(nJoints, config.check("refSpeed", Value(50.0)).asDouble());
+    refAccelerations.assign(nJoints, 1e6);
+    modes.assign(nJoints, ModeIdle);
+    // Arm joints are free, finger joints flex between 0 and 90 degrees, the ring and little fingers up to 250
+    minLimits.assign(nJoints, -180.0);
+    maxLimits.assign(nJoints, 180.0);
+    for (int j = 8; j < nJoints; ++j) {
+        minLimits[j] = 0.0;
+        maxLimits[j] = (j == 15) ? 250.0 : 90.0;
+    }
+
+    // Actuation latency
+    commandLatency = config.check("commandLatency", Value(0.005)).asDouble();
+    pendingCommands.resize(maxPendingCommands);
+    for (int i = 0; i < maxPendingCommands; ++i) {
+        pendingCommands[i].velocities.assign(nJoints, 0.0);
+    }
+    pendingHead = 0;
+    pendingCount = 0;
+
+    // Fingers
+    Bottle *confJoints = config.find("fingerJoints").asList();
+    if (!confJoints) {
+        cerr << dbgTag << "No fingerJoints specified. \n";
+        return false;
+    }
+    int nFingers = confJoints->size();
+    fingerJoints.clear();
+    fingerJointStart.resize(nFingers);
+    fingerJointCount.resize(nFingers);
+    for (int i = 0; i < nFingers; ++i) {
+        Bottle *joints = confJoints->get(i).asList();
+        fingerJointStart[i] = fingerJoints.size();
+        for (int j = 0; joints && (j < joints->size()); ++j) {
+            fingerJoints.push_back(joints->get(j).asInt());
+        }
+        fingerJointCount[i] = fingerJoints.size() - fingerJointStart[i];
+    }
+
+    // Fingertip taxels
+    tipOffsets.resize(nFingers);
+    tipCounts.resize(nFingers);
+    Bottle *confTips = config.find("fingertips").asList();
+    skinSize = 192;
+    for (int i = 0; i < nFingers; ++i) {
+        Bottle *tip = (confTips && (i < confTips->size())) ? confTips->get(i).asList() : NULL;
+        tipOffsets[i] = tip ? tip->get(0).asInt() : 12*i;
+        tipCounts[i] = tip ? tip->get(1).asInt() : 12;
+        if (tipOffsets[i] + tipCounts[i] > skinSize) {
+            skinSize = tipOffsets[i] + tipCounts[i];
+        }
+    }
+
+    // Virtual object
+    if (!readList(config, "touchThresholds", touchThresholds) || (static_cast<int>(touchThresholds.size()) != nFingers)) {
+        cerr << dbgTag << "One touch threshold per finger is required. \n";
+        return false;
+    }
+    if (!readList(config, "contactAngles", contactAngles)) {
+        contactAngles.assign(nFingers, -1.0);
+    }
+    contactAngles.resize(nFingers, -1.0);
+    stiffness = config.check("stiffness", Value(8.0)).asDouble();
+    maxPenetration = config.check("maxPenetration", Value(15.0)).asDouble();
+    noise = config.check("noise", Value(0.0)).asDouble();
+    skinPeriod = config.check("skinPeriod", Value(0.02)).asDouble();
+    events.resize(nFingers);
+    for (int i = 0; i < nFingers; ++i) {
+        events[i].crossTime = -1.0;
+        events[i].crossAngle = 0.0;
+        events[i].stopTime = -1.0;
+        events[i].restAngle = 0.0;
+    }
+
+    // Skin port
+    string skinPort = config.check("skinPort", Value("/fakeHandBoard/skin_comp:o")).asString().c_str();
+    if (!portSkinOut.open(skinPort.c_str())) {
+        cerr << dbgTag << "Could not open the skin port " << skinPort << ". \n";
+        return false;
+    }
+    string rawSkinPort = config.check("rawSkinPort", Value("")).asString().c_str();
+    publishRaw = !rawSkinPort.empty();
+    rawBaseline = config.check("rawBaseline", Value(240.0)).asDouble();
+    rawDrift = config.check("rawDrift", Value(0.0)).asDouble();
+    rawStart = Time::now();
+    if (publishRaw && !portRawSkinOut.open(rawSkinPort.c_str())) {
+        cerr << dbgTag << "Could not open the raw skin port " << rawSkinPort << ". \n";
+        portSkinOut.close();
+        return false;
+    }
+
+    // Start integrating
+    lastUpdate = Time::now();
+    lastSkin = lastUpdate;
+    updater = new Updater(*this, config.check("updatePeriod", Value(1)).asInt());
+    if (!updater->start()) {
+        cerr << dbgTag << "Could not start the update thread. \n";
+        delete updater;
+        updater = NULL;
+        return false;
+    }
+
+    cout << dbgTag << "Simulating " << nJoints << " joints and " << nFingers << " fingertips. \n";
+
+    return true;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Close the device                                                 ********************************************** */   
+bool FakeHandBoard::close(void) {
+    if (updater) {
+        updater->stop();
+        delete updater;
+        updater = NULL;
+
+        portSkinOut.interrupt();
+        portSkinOut.close();
+        if (publishRaw) {
+            portRawSkinOut.interrupt();
+            portRawSkinOut.close();
+        }
+    }
+
+    return true;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Read a list of doubles                                           ********************************************** */   
+bool FakeHandBoard::readList(yarp::os::Searchable &config, const char *i_key, std::vector<double> &o_values) {
+    Bottle *list = config.find(i_key).asList();
+    if (!list) {
+        return false;
+    }
+
+    o_values.resize(list->size());
+    for (int i = 0; i < list->size(); ++i) {
+        o_values[i] = list->get(i).asDouble();
+    }
+
+    return true;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Update the simulation                                            ********************************************** */   
+void FakeHandBoard::update(void) {
+    mutex.lock();
+    double now = Time::now();
+    integrate(now);
+    if (now - lastSkin >= skinPeriod) {
+        lastSkin = now;
+        publishSkin(now);
+    }
+    mutex.unlock();
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Integrate the kinematics                                         ********************************************** */   
+void FakeHandBoard::integrate(const double &i_now) {
+    double dt = i_now - lastUpdate;
+    lastUpdate = i_now;
+
+    // Apply the velocity commands whose actuation latency has elapsed
+    while ((pendingCount > 0) && (pendingCommands[pendingHead].applyTime <= i_now)) {
+        for (int j = 0; j < nJoints; ++j) {
+            velocities[j] = pendingCommands[pendingHead].velocities[j];
+            modes[j] = ModeVelocity;
+        }
+        pendingHead = (pendingHead + 1) % maxPendingCommands;
+        --pendingCount;
+    }
+
+    for (int j = 0; j < nJoints; ++j) {
+        if (modes[j] == ModeVelocity) {
+            positions[j] += velocities[j] * dt;
+        } else if (modes[j] == ModePosition) {
+            double step = refSpeeds[j] * dt;
+            double error = targets[j] - positions[j];
+            if (std::fabs(error) <= step) {
+                positions[j] = targets[j];
+            } else {
+                positions[j] += (error > 0) ? step : -step;
+            }
+        }
+        positions[j] = std::max(minLimits[j], std::min(maxLimits[j], positions[j]));
+    }
+
+    // The object blocks the distal joint of the fingers touching it
+    for (size_t i = 0; i < contactAngles.size(); ++i) {
+        if ((contactAngles[i] >= 0) && (fingerJointCount[i] > 0)) {
+            int distal = fingerJoints[fingerJointStart[i] + fingerJointCount[i] - 1];
+            positions[distal] = std::min(positions[distal], contactAngles[i] + maxPenetration);
+        }
+    }
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Publish a skin frame                                             ********************************************** */   
+void FakeHandBoard::publishSkin(const double &i_now) {
+    yarp::sig::Vector &skin = portSkinOut.prepare();
+    skin.resize(skinSize);
+    skin.zero();
+    // The raw skin of the untouched taxels is the drifting baseline
+    double baseline = std::min(255.0, std::max(0.0, rawBaseline + rawDrift*(i_now - rawStart)));
+    yarp::sig::Vector *raw = NULL;
+    if (publishRaw) {
+        raw = &portRawSkinOut.prepare();
+        raw->resize(skinSize);
+        for (int t = 0; t < skinSize; ++t) {
+            (*raw)[t] = baseline;
+        }
+    }
+
+    for (size_t i = 0; i < contactAngles.size(); ++i) {
+        double response = 0.0;
+        if ((contactAngles[i] >= 0) && (fingerJointCount[i] > 0)) {
+            int distal = fingerJoints[fingerJointStart[i] + fingerJointCount[i] - 1];
+            double penetration = positions[distal] - contactAngles[i];
+            if (penetration > 0) {
+                response = stiffness * penetration;
+            }
+        }
+
+        // The first taxel is the most pressed one
+        double maxTaxel = 0.0;
+        for (int t = 0; t < tipCounts[i]; ++t) {
+            double weight = std::max(0.1, 1.0 - 0.07*t);
+            double value = response * weight + noise * (2.0 * std::rand() / RAND_MAX - 1.0);
+            if (raw) {
+                (*raw)[tipOffsets[i] + t] = std::min(255.0, std::max(0.0, baseline - value));
+            }
+            value = std::max(0.0, value);
+            skin[tipOffsets[i] + t] = value;
+            maxTaxel = std::max(maxTaxel, value);
+        }
+
+        // Record the threshold crossing
+        if ((trialStart >= 0) && (events[i].crossTime < 0) && (maxTaxel >= touchThresholds[i]) && (response > 0)) {
+            int distal = fingerJoints[fingerJointStart[i] + fingerJointCount[i] - 1];
+            events[i].crossTime = i_now;
+            events[i].crossAngle = positions[distal];
+        }
+    }
+
+    skinStamp.update(i_now);
+    portSkinOut.setEnvelope(skinStamp);
+    portSkinOut.write();
+    if (raw) {
+        portRawSkinOut.setEnvelope(skinStamp);
+        portRawSkinOut.write();
+    }
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Record the finger stops                                          ********************************************** */   
+void FakeHandBoard::recordStops(const double *i_velocities, const double &i_now) {
+    if (trialStart < 0) {
+        return;
+    }
+
+    for (size_t i = 0; i < events.size(); ++i) {
+        if ((events[i].crossTime >= 0) && (events[i].stopTime < 0)) {
+            bool stopped = true;
+            for (int j = fingerJointStart[i]; j < fingerJointStart[i] + fingerJointCount[i]; ++j) {
+                stopped = stopped && (i_velocities[fingerJoints[j]] == 0.0);
+            }
+            if (stopped) {
+                events[i].stopTime = i_now;
+            }
+        }
+    }
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Trials                                                           ********************************************** */   
+void FakeHandBoard::startTrial(const std::vector<double> &i_contactAngles) {
+    mutex.lock();
+    for (size_t i = 0; i < contactAngles.size(); ++i) {
+        contactAngles[i] = (i < i_contactAngles.size()) ? i_contactAngles[i] : -1.0;
+        events[i].crossTime = -1.0;
+        events[i].crossAngle = 0.0;
+        events[i].stopTime = -1.0;
+        events[i].restAngle = 0.0;
+    }
+    trialStart = 0.0;
+    mutex.unlock();
+}
+
+bool FakeHandBoard::isTrialDone(void) {
+    bool done = true;
+
+    mutex.lock();
+    integrate(Time::now());
+    for (size_t i = 0; i < contactAngles.size(); ++i) {
+        if ((contactAngles[i] >= 0) && (fingerJointCount[i] > 0)) {
+            done = done && (events[i].stopTime >= 0);
+            for (int j = fingerJointStart[i]; j < fingerJointStart[i] + fingerJointCount[i]; ++j) {
+                done = done && (velocities[fingerJoints[j]] == 0.0);
+            }
+        }
+    }
+    // Wait for all the commands to be applied
+    done = done && (pendingCount == 0);
+    mutex.unlock();
+
+    return done;
+}
+
+double FakeHandBoard::getTrialEvents(std::vector<SimFingerEvents> &o_events) {
+    mutex.lock();
+    for (size_t i = 0; i < events.size(); ++i) {
+        if (fingerJointCount[i] > 0) {
+            events[i].restAngle = positions[fingerJoints[fingerJointStart[i] + fingerJointCount[i] - 1]];
+        }
+    }
+    o_events = events;
+    double start = (trialStart > 0) ? trialStart : -1.0;
+    mutex.unlock();
+
+    return start;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* IEncoders                                                        ********************************************** */   
+bool FakeHandBoard::getAxes(int *ax) {
+    *ax = nJoints;
+    return true;
+}
+
+bool FakeHandBoard::resetEncoder(int j) {
+    return setEncoder(j, 0.0);
+}
+
+bool FakeHandBoard::resetEncoders() {
+    for (int j = 0; j < nJoints; ++j) {
+        setEncoder(j, 0.0);
+    }
+    return true;
+}
+
+bool FakeHandBoard::setEncoder(int j, double val) {
+    if ((j < 0) || (j >= nJoints)) {
+        return false;
+    }
+    mutex.lock();
+    positions[j] = val;
+    mutex.unlock();
+    return true;
+}
+
+bool FakeHandBoard::setEncoders(const double *vals) {
+    for (int j = 0; j < nJoints; ++j) {
+        setEncoder(j, vals[j]);
+    }
+    return true;
+}
+
+bool FakeHandBoard::getEncoder(int j, double *v) {
+    if ((j < 0) || (j >= nJoints)) {
+        return false;
+    }
+    mutex.lock();
+    integrate(Time::now());
+    *v = positions[j];
+    mutex.unlock();
+    return true;
+}
+
+bool FakeHandBoard::getEncoders(double *encs) {
+    mutex.lock();
+    integrate(Time::now());
+    for (int j = 0; j < nJoints; ++j) {
+        encs[j] = positions[j];
+    }
+    mutex.unlock();
+    return true;
+}
+
+bool FakeHandBoard::getEncoderSpeeds(double *spds) {
+    mutex.lock();
+    for (int j = 0; j < nJoints; ++j) {
+        spds[j] = (modes[j] == ModeVelocity) ? velocities[j] : 0.0;
+    }
+    mutex.unlock();
+    return true;
+}
+
+bool FakeHandBoard::getEncoderSpeed(int j, double *sp) {
+    if ((j < 0) || (j >= nJoints)) {
+        return false;
+    }
+    mutex.lock();
+    *sp = (modes[j] == ModeVelocity) ? velocities[j] : 0.0;
+    mutex.unlock();
+    return true;
+}
+
+bool FakeHandBoard::getEncoderAccelerations(double *accs) {
+    for (int j = 0; j < nJoints; ++j) {
+        accs[j] = 0.0;
+    }
+    return true;
+}
+
+bool FakeHandBoard::getEncoderAcceleration(int j, double *acc) {
+    *acc = 0.0;
+    return ((j >= 0) && (j < nJoints));
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* IPositionControl                                                 ********************************************** */   
+bool FakeHandBoard::setPositionMode() {
+    mutex.lock();
+    for (int j = 0; j < nJoints; ++j) {
+        modes[j] = ModePosition;
+        targets[j] = positions[j];
+    }
+    mutex.unlock();
+    return true;
+}
+
+bool FakeHandBoard::positionMove(int j, double ref) {
+    if ((j < 0) || (j >= nJoints)) {
+        return false;
+    }
+    mutex.lock();
+    integrate(Time::now());
+    modes[j] = ModePosition;
+    targets[j] = std::max(minLimits[j], std::min(maxLimits[j], ref));
+    mutex.unlock();
+    return true;
+}
+
+bool FakeHandBoard::positionMove(const double *refs) {
+    for (int j = 0; j < nJoints; ++j) {
+        positionMove(j, refs[j]);
+    }
+    return true;
+}
+
+bool FakeHandBoard::relativeMove(int j, double delta) {
+    if ((j < 0) || (j >= nJoints)) {
+        return false;
+    }
+    mutex.lock();
+    double ref = ((modes[j] == ModePosition) ? targets[j] : positions[j]) + delta;
+    mutex.unlock();
+    return positionMove(j, ref);
+}
+
+bool FakeHandBoard::relativeMove(const double *deltas) {
+    for (int j = 0; j < nJoints; ++j) {
+        relativeMove(j, deltas[j]);
+    }
+    return true;
+}
+
+bool FakeHandBoard::checkMotionDone(int j, bool *flag) {
+    if ((j < 0) || (j >= nJoints)) {
+        return false;
+    }
+    mutex.lock();
+    integrate(Time::now());
+    *flag = (modes[j] != ModePosition) || (positions[j] == targets[j]);
+    mutex.unlock();
+    return true;
+}
+
+bool FakeHandBoard::checkMotionDone(bool *flag) {
+    mutex.lock();
+    integrate(Time::now());
+    *flag = true;
+    for (int j = 0; j < nJoints; ++j) {
+        *flag = *flag && ((modes[j] != ModePosition) || (positions[j] == targets[j]));
+    }
+    mutex.unlock();
+    return true;
+}
+
+bool FakeHandBoard::setRefSpeed(int j, double sp) {
+    if ((j < 0) || (j >= nJoints)) {
+        return false;
+    }
+    mutex.lock();
+    refSpeeds[j] = std::fabs(sp);
+    mutex.unlock();
+    return true;
+}
+
+bool FakeHandBoard::setRefSpeeds(const double *spds) {
+    for (int j = 0; j < nJoints; ++j) {
+        setRefSpeed(j, spds[j]);
+    }
+    return true;
+}
+
+bool FakeHandBoard::setRefAcceleration(int j, double acc) {
+    if ((j < 0) || (j >= nJoints)) {
+        return false;
+    }
+    mutex.lock();
+    refAccelerations[j] = acc;
+    mutex.unlock();
+    return true;
+}
+
+bool FakeHandBoard::setRefAccelerations(const double *accs) {
+    for (int j = 0; j < nJoints; ++j) {
+        setRefAcceleration(j, accs[j]);
+    }
+    return true;
+}
+
+bool FakeHandBoard::getRefSpeed(int j, double *ref) {
+    if ((j < 0) || (j >= nJoints)) {
+        return false;
+    }
+    mutex.lock();
+    *ref = refSpeeds[j];
+    mutex.unlock();
+    return true;
+}
+
+bool FakeHandBoard::getRefSpeeds(double *spds) {
+    mutex.lock();
+    for (int j = 0; j < nJoints; ++j) {
+        spds[j] = refSpeeds[j];
+    }
+    mutex.unlock();
+    return true;
+}
+
+bool FakeHandBoard::getRefAcceleration(int j, double *acc) {
+    if ((j < 0) || (j >= nJoints)) {
+        return false;
+    }
+    mutex.lock();
+    *acc = refAccelerations[j];
+    mutex.unlock();
+    return true;
+}
+
+bool FakeHandBoard::getRefAccelerations(double *accs) {
+    mutex.lock();
+    for (int j = 0; j < nJoints; ++j) {
+        accs[j] = refAccelerations[j];
+    }
+    mutex.unlock();
+    return true;
+}
+
+bool FakeHandBoard::stop(int j) {
+    if ((j < 0) || (j >= nJoints)) {
+        return false;
+    }
+    mutex.lock();
+    integrate(Time::now());
+    velocities[j] = 0.0;
+    targets[j] = positions[j];
+    mutex.unlock();
+    return true;
+}
+
+bool FakeHandBoard::stop() {
+    mutex.lock();
+    integrate(Time::now());
+    // Drop the commands still waiting for the actuation latency
+    pendingCount = 0;
+    for (int j = 0; j < nJoints; ++j) {
+        velocities[j] = 0.0;
+        targets[j] = positions[j];
+    }
+    mutex.unlock();
+    return true;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* IVelocityControl                                                 ********************************************** */   
+bool FakeHandBoard::setVelocityMode() {
+    mutex.lock();
+    for (int j = 0; j < nJoints; ++j) {
+        modes[j] = ModeVelocity;
+        velocities[j] = 0.0;
+    }
+    mutex.unlock();
+    return true;
+}
+
+bool FakeHandBoard::velocityMove(int j, double sp) {
+    if ((j < 0) || (j >= nJoints)) {
+        return false;
+    }
+    mutex.lock();
+    integrate(Time::now());
+    modes[j] = ModeVelocity;
+    velocities[j] = sp;
+    mutex.unlock();
+    return true;
+}
+
+bool FakeHandBoard::velocityMove(const double *sp) {
+    mutex.lock();
+    double now = Time::now();
+    integrate(now);
+
+    // The first command moving a finger starts the trial
+    if (trialStart == 0.0) {
+        for (size_t i = 0; i < fingerJoints.size(); ++i) {
+            if (sp[fingerJoints[i]] != 0.0) {
+                trialStart = now;
+                break;
+            }
+        }
+    }
+    recordStops(sp, now);
+
+    // Queue the command until the actuation latency has elapsed
+    if (pendingCount == maxPendingCommands) {
+        // Drop the oldest command
+        pendingHead = (pendingHead + 1) % maxPendingCommands;
+        --pendingCount;
+    }
+    PendingCommand &command = pendingCommands[(pendingHead + pendingCount) % maxPendingCommands];
+    command.applyTime = now + commandLatency;
+    for (int j = 0; j < nJoints; ++j) {
+        command.velocities[j] = sp[j];
+    }
+    ++pendingCount;
+    mutex.unlock();
+
+    return true;
+}
+/* *********************************************************************************************************************** */
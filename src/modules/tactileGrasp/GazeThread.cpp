@@ -25,7 +25,9 @@
 
 #include <yarp/sig/Vector.h>
 #include <yarp/os/Property.h>
+#include <yarp/os/Time.h>
 
+using std::cerr;
 using std::cout;
 using std::string;
 
@@ -36,11 +38,26 @@ using yarp::os::Value;
 using yarp::dev::ICartesianControl;
 using yarp::dev::IGazeControl;
 
-GazeThread::GazeThread(const int aPeriod, const yarp::os::ResourceFinder &aRf)
-    : RateThread(aPeriod) {
+GazeThread::GazeThread(const int aPeriod, const yarp::os::ResourceFinder &aRf, StartupTimer *aStartup)
+    : RateThread(aPeriod), commandsSent(0), commandsSuppressed(0), loopMonitor(aPeriod/1000.0) {
         period = aPeriod;
         rf = aRf;
 
+        async = true;
+        deadband = 0.0;
+        hasFixation = false;
+        for (int h = 0; h < MaxHands; ++h) {
+            iCart[h] = NULL;
+            startup_context_id_cart[h] = 0;
+        }
+        iGaze = NULL;
+        parallelStartup = true;
+        startup = (aStartup ? aStartup : &localStartup);
+        lastFixation.resize(3, 0.0);
+        handPosition.resize(3, 0.0);
+        fixation.resize(3, 0.0);
+        handOrientation.resize(4, 0.0);
+
         dbgTag = "GazeThread: ";
 }
 
@@ -48,41 +65,93 @@ bool GazeThread::threadInit() {
     using yarp::os::Property;
     using yarp::os::Bottle;
     using std::stringstream;
+    using yarp::os::Time;
 
     cout << dbgTag << "Starting thread. \n";
+    double initStart = Time::now();
 
     /* ******* Extract configuration files          ******* */
     string robotName = rf.check("robot", Value("icub"), "The robot name.").asString().c_str();
     string whichHand = rf.check("whichHand", Value("right"), "The hand to be used for the grasping.").asString().c_str();
+    // With both hands the gaze follows the point between them
+    hands.clear();
+    if (whichHand == "both") {
+        hands.push_back("left");
+        hands.push_back("right");
+    } else {
+        hands.push_back(whichHand);
+    }
+
+    Bottle &confGaze = rf.findGroup("gaze");
+    async = (confGaze.check("async", Value("on")).asString() == "on");
+    deadband = confGaze.check("deadband", Value(0.01)).asDouble();
+    hasFixation = false;
+    cout << dbgTag << "Tracking the " << whichHand << " hand" << (hands.size() > 1 ? "s " : " ") << (async ? "asynchronously" : "synchronously") << " with a deadband of " << deadband << " m. \n";
+    parallelStartup = (rf.findGroup("startup").check("parallel", Value("on")).asString() == "on");
     
     
-    /* ****** Cartesian controller stuff                      ****** */
-    Property optCart;
-    optCart.put("device", "cartesiancontrollerclient");
-    optCart.put("remote", ("/" + robotName + "/cartesianController/" + whichHand + "_arm").c_str());
-    optCart.put("local", ("/cartesian_client/" + whichHand + "_arm").c_str());
-    
-    if (!clientCart.open(optCart))
+    /* ****** Cartesian and gaze controller clients         ****** */
+    if (static_cast<int>(hands.size()) > MaxHands) {
+        cerr << dbgTag << "Too many hands. \n";
         return false;
-    // open the view
-    clientCart.view(iCart);
-    // latch the controller context in order to preserve it after closing the module
-    iCart->storeContext(&startup_context_id_cart);
-    // print out some info about the controller
-    Bottle info;
-    iCart->getInfo(info);
-    stringstream ss;
-    ss << "Cartesian controller info = " << info.toString().c_str();
-    cout << ss;
+    }
+    std::vector<DriverOpener *> cartOpeners(hands.size(), static_cast<DriverOpener *>(NULL));
+    for (size_t h = 0; h < hands.size(); ++h) {
+        Property optCart;
+        optCart.put("device", "cartesiancontrollerclient");
+        optCart.put("remote", ("/" + robotName + "/cartesianController/" + hands[h] + "_arm").c_str());
+        optCart.put("local", ("/cartesian_client/" + hands[h] + "_arm").c_str());
+
+        cartOpeners[h] = new DriverOpener(clientCart[h], optCart, hands[h] + " cartesian driver", startup);
+    }
 
-    /* ****** Gaze controller stuff                               ****** */
     Property optGaze;
     optGaze.put("device", "gazecontrollerclient");
     optGaze.put("remote", "/iKinGazeCtrl");
     optGaze.put("local", "/client/gaze");
 
-    if (!clientGaze.open(optGaze))
+    // All the clients wait for their server to answer: open them at the same time
+    for (size_t h = 0; h < hands.size(); ++h) {
+        cartOpeners[h]->launch(parallelStartup);
+    }
+    double gazeStart = Time::now();
+    bool ok = clientGaze.open(optGaze);
+    startup->record("gaze driver", gazeStart);
+    if (!ok) {
+        cerr << dbgTag << "Could not open the gaze controller client. \n";
+    }
+    for (size_t h = 0; h < hands.size(); ++h) {
+        if (!cartOpeners[h]->wait()) {
+            cerr << dbgTag << "Could not open the " << hands[h] << " cartesian controller client. \n";
+            ok = false;
+        }
+        delete cartOpeners[h];
+    }
+    if (!ok) {
+        for (size_t h = 0; h < hands.size(); ++h) {
+            clientCart[h].close();
+        }
+        clientGaze.close();
         return false;
+    }
+
+    /* ****** Cartesian controller stuff                      ****** */
+    Bottle info;
+    stringstream ss;
+    for (size_t h = 0; h < hands.size(); ++h) {
+        // open the view
+        clientCart[h].view(iCart[h]);
+        // latch the controller context in order to preserve it after closing the module
+        iCart[h]->storeContext(&startup_context_id_cart[h]);
+        // print out some info about the controller
+        info.clear();
+        iCart[h]->getInfo(info);
+        ss.str(std::string());
+        ss << "Cartesian controller info = " << info.toString().c_str();
+        cout << ss.str() << "\n";
+    }
+
+    /* ****** Gaze controller stuff                               ****** */
     // open the view
     clientGaze.view(iGaze);
     // latch the controller context in order to preserve it after closing the module
@@ -92,11 +161,12 @@ bool GazeThread::threadInit() {
     iGaze->getInfo(info);
     ss.str(std::string());
     ss << "Gaze controller info = " << info.toString().c_str();
-    cout << ss;
+    cout << ss.str() << "\n";
 
     // Store initial gaze
     iGaze->getFixationPoint(startGaze);
 
+    startup->record("gaze thread", initStart);
 
     cout << dbgTag << "Done. \n";
     
@@ -110,10 +180,12 @@ void GazeThread::threadRelease() {
     iGaze->lookAtFixationPoint(startGaze);
 
     // Stop cartesian and gaze controller
-    if (iCart) {
-        iCart->stopControl();
-        // restore the controller context as it was before opening the module
-        iCart->restoreContext(startup_context_id_cart);
+    for (size_t h = 0; h < hands.size(); ++h) {
+        if (iCart[h]) {
+            iCart[h]->stopControl();
+            // restore the controller context as it was before opening the module
+            iCart[h]->restoreContext(startup_context_id_cart[h]);
+        }
     }
     if (iGaze) {
         iGaze->stopControl();
@@ -121,30 +193,80 @@ void GazeThread::threadRelease() {
         iGaze->restoreContext(startup_context_id_gaze);
     }
 
-    clientCart.close();
+    for (size_t h = 0; h < hands.size(); ++h) {
+        clientCart[h].close();
+    }
     clientGaze.close();
 
     cout << dbgTag << "Done. \n";
 }
 
 void GazeThread::run() {
+    loopMonitor.tickStarted(getIterations());
+
     lookAtObject();
+
+    loopMonitor.tickEnded();
+}
+
+void GazeThread::getLoopStats(yarp::os::Bottle &o_stats) {
+    using yarp::os::Bottle;
+
+    loopMonitor.getStats(*this, o_stats);
+
+    Bottle &sent = o_stats.addList();
+    sent.addString("sent");
+    sent.addInt(static_cast<int>(commandsSent.load()));
+    Bottle &suppressed = o_stats.addList();
+    suppressed.addString("suppressed");
+    suppressed.addInt(static_cast<int>(commandsSuppressed.load()));
+}
+
+void GazeThread::resetLoopStats(void) {
+    loopMonitor.reset(*this);
+    commandsSent = 0;
+    commandsSuppressed = 0;
 }
 
 /* *********************************************************************************************************************** */
 /* ******* Look at object                                                   ********************************************** */
 bool GazeThread::lookAtObject() {
-    using yarp::sig::Vector;
-
-    Vector position(3), orientation(4);
-    
-    // Get pose
-    iCart->getPose(position, orientation);
+    // Get pose, averaged over the tracked hands
+    fixation[0] = fixation[1] = fixation[2] = 0.0;
+    for (size_t h = 0; h < hands.size(); ++h) {
+        if (!iCart[h]->getPose(handPosition, handOrientation)) {
+            return false;
+        }
+        fixation[0] += handPosition[0] / hands.size();
+        fixation[1] += handPosition[1] / hands.size();
+        fixation[2] += handPosition[2] / hands.size();
+    }
      
     // Look at object
-    position[0] -= 0.1;
-    iGaze->lookAtFixationPoint(position);                 // move the gaze to the desired fixation point
-    bool ok = iGaze->waitMotionDone();                        // wait until the operation is done
+    fixation[0] -= 0.1;
+
+    // Do not resend the same fixation point while the hand is still
+    if (hasFixation) {
+        double dx = fixation[0] - lastFixation[0];
+        double dy = fixation[1] - lastFixation[1];
+        double dz = fixation[2] - lastFixation[2];
+        if (dx*dx + dy*dy + dz*dz <= deadband*deadband) {
+            ++commandsSuppressed;
+            return true;
+        }
+    }
+
+    bool ok = iGaze->lookAtFixationPoint(fixation);         // move the gaze to the desired fixation point
+    if (ok) {
+        lastFixation[0] = fixation[0];
+        lastFixation[1] = fixation[1];
+        lastFixation[2] = fixation[2];
+        hasFixation = true;
+        ++commandsSent;
+    }
+    if (ok && !async) {
+        ok = iGaze->waitMotionDone();                           // wait until the operation is done
+    }
 
     return ok;
 }
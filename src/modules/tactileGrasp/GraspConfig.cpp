@@ -0,0 +1,265 @@
+/* 
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org 
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+#include "iCub/tactileGrasp/GraspConfig.h"
+#include "iCub/tactileGrasp/TactileGraspEnums.h"
+
+#include <iostream>
+#include <algorithm>
+
+using std::cerr;
+
+using iCub::tactileGrasp::GraspConfig;
+using iCub::tactileGrasp::GraspConfigStore;
+
+
+/* *********************************************************************************************************************** */
+/* ******* Constructor                                                      ********************************************** */   
+GraspConfig::GraspConfig() {
+    version = 0;
+    hasGrasp = false;
+    hasStop = false;
+    mode = GraspType::Grasp;
+    modeSelections = 0;
+    jointOffset = 0;
+    nJoints = 0;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Set the velocities of all the joints                             ********************************************** */   
+bool GraspConfig::setVelocities(const int &i_type, const std::vector<double> &i_vel) {
+    size_t nVelocities = velocities.grasp.size();
+    if (i_vel.size() < nVelocities) {
+        cerr << "GraspConfig: The hand model needs " << nVelocities << " velocities from joint " << jointOffset << ". \n";
+        return false;
+    }
+
+    switch (i_type) {
+        case GraspType::Stop :
+            std::copy(i_vel.begin(), i_vel.begin() + nVelocities, velocities.stop.begin());
+            hasStop = true;
+            break;
+        case GraspType::Grasp :
+            std::copy(i_vel.begin(), i_vel.begin() + nVelocities, velocities.grasp.begin());
+            hasGrasp = true;
+            break;
+
+        default:
+            cerr << "GraspConfig: Unknown velocity type specified. \n";
+            return false;
+            break;
+    }
+
+    return true;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Set the velocity of a joint                                      ********************************************** */   
+bool GraspConfig::setVelocity(const int &i_type, const int &i_joint, const double &i_vel) {
+    int velocity = i_joint - jointOffset;
+    if ((velocity < 0) || (velocity >= static_cast<int>(velocities.grasp.size())) || ((nJoints > 0) && (i_joint >= nJoints))) {
+        cerr << "GraspConfig: Invalid joint specified. \n";
+        return false;
+    }
+
+    switch (i_type) {
+        case GraspType::Stop :
+            velocities.stop[velocity] = i_vel;
+            break;
+        case GraspType::Grasp :
+            velocities.grasp[velocity] = i_vel;
+            break;
+
+        default:
+            cerr << "GraspConfig: Unknown velocity type specified. \n";
+            return false;
+            break;
+    }
+
+    return true;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Set the touch threshold of a finger                              ********************************************** */   
+bool GraspConfig::setTouchThreshold(const int &i_finger, const double &i_threshold) {
+    if ((i_finger < 0) || (i_finger >= static_cast<int>(touchThresholds.size()))) {
+        cerr << "GraspConfig: The specified finger is out of range. \n";
+        return false;
+    }
+
+    touchThresholds[i_finger] = i_threshold;
+    // A disabled finger has no hysteresis
+    releaseThresholds[i_finger] = (i_threshold > 0.0) ? std::max(0.0, i_threshold - releaseMargins[i_finger]) : i_threshold;
+
+    return true;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Set the grasp mode                                               ********************************************** */   
+bool GraspConfig::setMode(const int &i_type) {
+    switch (i_type) {
+        case GraspType::Grasp :
+        case GraspType::Crush :
+        case GraspType::Regulate :
+            mode = i_type;
+            ++modeSelections;
+            break;
+
+        default:
+            cerr << "GraspConfig: Unknown grasp mode specified. \n";
+            return false;
+            break;
+    }
+
+    return true;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Copy a configuration                                             ********************************************** */   
+void GraspConfig::copyFrom(const GraspConfig &i_config) {
+    bool sameSizes = (velocities.grasp.size() == i_config.velocities.grasp.size())
+        && (velocities.stop.size() == i_config.velocities.stop.size())
+        && (touchThresholds.size() == i_config.touchThresholds.size())
+        && (releaseThresholds.size() == i_config.releaseThresholds.size())
+        && (releaseMargins.size() == i_config.releaseMargins.size());
+    if (!sameSizes) {
+        *this = i_config;
+        return;
+    }
+
+    version = i_config.version;
+    std::copy(i_config.velocities.grasp.begin(), i_config.velocities.grasp.end(), velocities.grasp.begin());
+    std::copy(i_config.velocities.stop.begin(), i_config.velocities.stop.end(), velocities.stop.begin());
+    hasGrasp = i_config.hasGrasp;
+    hasStop = i_config.hasStop;
+    std::copy(i_config.touchThresholds.begin(), i_config.touchThresholds.end(), touchThresholds.begin());
+    std::copy(i_config.releaseThresholds.begin(), i_config.releaseThresholds.end(), releaseThresholds.begin());
+    std::copy(i_config.releaseMargins.begin(), i_config.releaseMargins.end(), releaseMargins.begin());
+    mode = i_config.mode;
+    modeSelections = i_config.modeSelections;
+    jointOffset = i_config.jointOffset;
+    nJoints = i_config.nJoints;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Snapshot store                                                   ********************************************** */   
+GraspConfigStore::GraspConfigStore() : current(NULL), hazard(NULL) {
+}
+
+GraspConfigStore::~GraspConfigStore() {
+    delete current.load();
+    for (size_t i = 0; i < retired.size(); ++i) {
+        delete retired[i];
+    }
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Publish the initial snapshot                                     ********************************************** */   
+void GraspConfigStore::reset(const GraspConfig &i_config) {
+    writeMutex.lock();
+    GraspConfig *previous = current.exchange(new GraspConfig(i_config));
+    if (previous) {
+        retired.push_back(previous);
+    }
+    reclaim();
+    writeMutex.unlock();
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Start a change                                                   ********************************************** */   
+GraspConfig *GraspConfigStore::edit(void) {
+    writeMutex.lock();
+    // The writers are serialised, so the latest snapshot cannot be deleted meanwhile
+    GraspConfig *latest = current.load();
+    return (latest ? new GraspConfig(*latest) : new GraspConfig());
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* End a change                                                     ********************************************** */   
+void GraspConfigStore::publish(GraspConfig *io_config, const bool &i_commit) {
+    if (i_commit) {
+        GraspConfig *latest = current.load();
+        io_config->version = (latest ? latest->version + 1 : 1);
+        GraspConfig *previous = current.exchange(io_config);
+        if (previous) {
+            retired.push_back(previous);
+        }
+    } else {
+        delete io_config;
+    }
+    reclaim();
+    writeMutex.unlock();
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Read the latest snapshot                                         ********************************************** */   
+const GraspConfig *GraspConfigStore::acquire(void) {
+    GraspConfig *snapshot = current.load();
+    // Announce the snapshot, then check that it was not replaced before the announcement could be seen
+    for (;;) {
+        hazard.store(snapshot);
+        GraspConfig *latest = current.load();
+        if (latest == snapshot) {
+            return snapshot;
+        }
+        snapshot = latest;
+    }
+}
+
+void GraspConfigStore::release(void) {
+    hazard.store(NULL, std::memory_order_release);
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Delete the retired snapshots                                     ********************************************** */   
+void GraspConfigStore::reclaim(void) {
+    GraspConfig *inUse = hazard.load();
+    size_t kept = 0;
+    for (size_t i = 0; i < retired.size(); ++i) {
+        if (retired[i] == inUse) {
+            retired[kept++] = retired[i];
+        } else {
+            delete retired[i];
+        }
+    }
+    retired.resize(kept);
+}
+/* *********************************************************************************************************************** */
@@ -0,0 +1,790 @@
+/* 
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org 
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+
+#include "iCub/tactileGrasp/GraspController.h"
+#include "iCub/tactileGrasp/AsyncLog.h"
+
+#include <iostream>
+#include <cmath>
+#include <algorithm>
+
+#include <yarp/os/Time.h>
+
+using std::cerr;
+using std::cout;
+
+using iCub::tactileGrasp::GraspController;
+
+using yarp::os::Value;
+
+
+/* *********************************************************************************************************************** */
+/* ******* Read the grasp velocities                                        ********************************************** */   
+bool iCub::tactileGrasp::readGraspVelocities(yarp::os::Searchable &rf, GraspVelocity &o_velocities) {
+    using yarp::os::Bottle;
+
+    Bottle &confVelocity = rf.findGroup("velocity");
+    if (!confVelocity.isNull()) {
+        // Velocities
+        Bottle *confVelGrasp = confVelocity.find("grasp").asList();
+        if (confVelGrasp && (confVelGrasp->size() > 0)) {
+            o_velocities.grasp.assign(confVelGrasp->size(), 0.0);
+            o_velocities.stop.assign(confVelGrasp->size(), 0.0);
+            for (int i = 0; i < confVelGrasp->size(); ++i) {
+                // Grasp velocities
+                o_velocities.grasp[i] = confVelGrasp->get(i).asDouble();
+
+                // Stop velocities
+                if (o_velocities.grasp[i] > 0) {
+                    o_velocities.stop[i] = confVelocity.check("stop", Value(0.0)).asDouble();
+                }
+            }
+        } else {
+            cerr << "TactileGrasp: No grasp velocities were found in the specified configuration file. \n";
+            return false;
+        }
+    } else {
+        cerr << "TactileGrasp: Could not find the velocities parameter group [velocity] in the given configuration file. \n";
+        return false;
+    }
+
+    return true;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Constructor                                                      ********************************************** */   
+GraspController::GraspController() {
+    nFingers = 0;
+    nJoints = 0;
+
+    skinSize = 0;
+    hasPalm = false;
+    palmContact = false;
+    palmTrigger = false;
+    palmTriggered = false;
+    validateKernel = false;
+    debounce = 1;
+
+    regulation.kp = 0.0;
+    regulation.ki = 0.0;
+    regulation.maxScale = 1.0;
+    regulation.minScale = 0.0;
+    regulation.tolerance = 0.0;
+    lastControlTime = -1.0;
+
+    dbgTag = "GraspController: ";
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Configure the controller                                         ********************************************** */
+bool GraspController::configure(yarp::os::Searchable &rf) {
+    using yarp::os::Bottle;
+
+    // Build grasp parameters
+    Bottle &confGrasp = rf.findGroup("graspTh");
+    if (!confGrasp.isNull()) {
+        // Individual touch thresholds per fingertip
+        Bottle *confTouchThr = confGrasp.find("touchThresholds").asList();
+
+        if (confTouchThr && !confTouchThr->isNull()) {
+            // Generate parameter vectors
+            nFingers = confTouchThr->size();
+            fingers.resize(nFingers);
+            maxTaxels.resize(nFingers);
+            patches.resize(nFingers);
+            config.touchThresholds.resize(nFingers);
+            for (int i = 0; i < nFingers; ++i) {
+                patches[i].threshold = confTouchThr->get(i).asDouble();
+                config.touchThresholds[i] = patches[i].threshold;
+                fingers[i].maxTaxel = 0.0;
+                fingers[i].contact = false;
+                fingers[i].contactOnset = false;
+                fingers[i].pendingSamples = 0;
+                fingers[i].switches = 0;
+                fingers[i].slipPending = false;
+                fingers[i].slipOnset = false;
+                fingers[i].tightenUntil = -1.0;
+                fingers[i].predictedScale = 1.0;
+            }
+        } else {
+            cerr << dbgTag << "Could not find the touch thresholds in the specified configuration file under the [graspTh] parameter group. \n";
+            return false;
+        }
+
+        // Hand model
+        if (!hand.configure(rf)) {
+            return false;
+        }
+        if (nFingers > hand.getFingerCount()) {
+            cerr << dbgTag << "There are more touch thresholds than fingers in the " << hand.getName() << " hand model. \n";
+            return false;
+        }
+        // The velocities are sized once, so that the settings are later copied without allocating
+        config.jointOffset = hand.getJointOffset();
+        config.velocities.grasp.assign(hand.getVelocityCount(), 0.0);
+        config.velocities.stop.assign(hand.getVelocityCount(), 0.0);
+
+        // Palm contact and kernel validation
+        palmTrigger = (confGrasp.check("palmTrigger", Value("off")).asString() == "on");
+        validateKernel = (confGrasp.check("validateKernel", Value("off")).asString() == "on");
+        if (!configureSkinLayout(rf, confGrasp.check("palmThreshold", Value(10.0)).asDouble())) {
+            return false;
+        }
+
+        // Filtering and hysteresis of the contact decisions
+        if (!configureFiltering(rf)) {
+            return false;
+        }
+
+        // Pressure regulation
+        if (!configureRegulation(rf)) {
+            return false;
+        }
+
+        // Slip detection
+        if (!slip.configure(rf, nFingers, hand.getTaxelPositions())) {
+            return false;
+        }
+        for (int i = 0; slip.isEnabled() && (i < nFingers); ++i) {
+            if (patches[i].count > slip.getTaxelCount()) {
+                cerr << dbgTag << "Fingertip " << i << " has more taxels than the taxel positions of the " << hand.getName() << " hand model. \n";
+                return false;
+            }
+        }
+
+        // Contact prediction
+        if (!predictor.configure(rf, nFingers)) {
+            return false;
+        }
+    } else {
+        cerr << dbgTag << "Could not find grasp configuration [graspTh] group in the specified configuration file. \n";
+        return false;
+    }
+
+
+    /* ******* Build finger to joint map.           ******* */
+    if (!generateJointMap()) {
+        return false;
+    }
+
+
+    // Print out debug information
+#ifndef NODEBUG
+    cout << "\n";
+    cout << "DEBUG: " << dbgTag << " Configured joints and thresholds: \n";
+    for (size_t i = 0; i < fingers.size(); ++i) {
+        cout << "DEBUG: " << dbgTag << "\tFinger ID: " << i << "\t Touch threshold: " << patches[i].threshold << "\t Joints: ";
+        for (int j = commandOffsets[i]; j < commandOffsets[i + 1]; ++j) {
+            cout << commands[j].joint << " ";
+        }
+        cout << "\n";
+    }
+    cout << "\n";
+#endif
+
+    return true;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Set the number of controlled joints                              ********************************************** */
+bool GraspController::setJointCount(const int &i_nJoints) {
+    nJoints = i_nJoints;
+    config.nJoints = nJoints;
+    // Preallocate the commanded velocities
+    graspVelocities.assign(nJoints, 0.0);
+
+    // Check the finger joints against the velocity interface
+    return generateJointMap();
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Reset the grasp                                                  ********************************************** */
+void GraspController::resetGrasp(void) {
+    palmTriggered = false;
+
+    integrals.assign(nFingers, 0.0);
+    lastControlTime = -1.0;
+
+    slip.reset();
+    predictor.reset();
+    for (int i = 0; i < nFingers; ++i) {
+        fingers[i].slipPending = false;
+        fingers[i].tightenUntil = -1.0;
+        fingers[i].predictedScale = 1.0;
+    }
+}
+/* *********************************************************************************************************************** */
+
+/* *********************************************************************************************************************** */
+/* ******* Clear the contact switch counts                                  ********************************************** */
+void GraspController::resetContactSwitches(void) {
+    for (int i = 0; i < nFingers; ++i) {
+        fingers[i].switches = 0;
+    }
+}
+/* *********************************************************************************************************************** */
+
+/* *********************************************************************************************************************** */
+/* ******* Select the grasp mode                                            ********************************************** */
+bool GraspController::setMode(const int &i_type) {
+    GraspConfig edited(config);
+    if (!edited.setMode(i_type)) {
+        return false;
+    }
+    applyConfig(edited);
+
+    return true;
+}
+/* *********************************************************************************************************************** */
+
+/* *********************************************************************************************************************** */
+/* ******* Regulate the pressure of a finger                                ********************************************** */
+double GraspController::regulate(const int &i_finger, const double &i_dt) {
+    double error = targetPressures[i_finger] - fingers[i_finger].maxTaxel;
+
+    // Settled: hold the finger and the integral
+    if (fingers[i_finger].contact && (std::fabs(error) <= regulation.tolerance)) {
+        return 0.0;
+    }
+
+    double integral = integrals[i_finger] + error*i_dt;
+    double scale = regulation.kp*error + regulation.ki*integral;
+    if (scale > regulation.maxScale) {
+        scale = regulation.maxScale;
+        if (error > 0.0) {
+            integral = integrals[i_finger];
+        }
+    } else if (scale < regulation.minScale) {
+        scale = regulation.minScale;
+        if (error < 0.0) {
+            integral = integrals[i_finger];
+        }
+    }
+    integrals[i_finger] = integral;
+
+    return scale;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Consume the contact onset of a finger                            ********************************************** */
+bool GraspController::takeContactOnset(const int &i_finger) {
+    bool onset = fingers[i_finger].contactOnset;
+    fingers[i_finger].contactOnset = false;
+
+    return onset;
+}
+
+bool GraspController::takeSlipOnset(const int &i_finger) {
+    bool onset = fingers[i_finger].slipOnset;
+    fingers[i_finger].slipOnset = false;
+
+    return onset;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Detect contact on each finger.                                   ********************************************** */
+bool GraspController::detectContact(const yarp::sig::Vector &i_skinComp) {
+    if (i_skinComp.size() < skinSize) {
+        AsyncLog::log(LogLevel::Error, dbgTag, "Skin data is too short for the configured skin layout. ");
+        return false;
+    }
+
+    // Filter the taxels, then reduce all the patches in one pass
+    const yarp::sig::Vector &skin = taxelFilter.filter(i_skinComp);
+    SkinPatchKernel::reduce(skin.data(), &patches[0], patches.size(), &patchStats[0]);
+    if (validateKernel) {
+        validatePatchStats(skin);
+    }
+
+    updateContacts();
+    detectSlip(skin.data());
+
+    return true;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Detect contacts from the active taxels                           ********************************************** */
+bool GraspController::detectContactSparse(const yarp::sig::Vector &i_skinComp, const std::vector<unsigned int> &i_taxels) {
+    if (i_skinComp.size() < skinSize) {
+        AsyncLog::log(LogLevel::Error, dbgTag, "Skin data is too short for the configured skin layout. ");
+        return false;
+    }
+
+    // The compensated skin is never negative: a patch with no positive threshold is always active, as in the dense path
+    for (size_t p = 0; p < patchStats.size(); ++p) {
+        patchStats[p].max = 0.0;
+        patchStats[p].sum = 0.0;
+        patchStats[p].nActive = (patches[p].threshold > 0.0) ? 0 : patches[p].count;
+    }
+
+    // Only visit the reported taxels. The filter takes the others as zero while they are not reported.
+    bool filtered = taxelFilter.isEnabled();
+    for (size_t k = 0; k < i_taxels.size(); ++k) {
+        unsigned int t = i_taxels[k];
+        int p = (t < taxelPatches.size()) ? taxelPatches[t] : -1;
+        if (p >= 0) {
+            double value = filtered ? taxelFilter.filter(t, i_skinComp[t]) : i_skinComp[t];
+            patchStats[p].max = std::max(patchStats[p].max, value);
+            patchStats[p].sum += value;
+            if ((patches[p].threshold > 0.0) && (value >= patches[p].threshold)) {
+                ++patchStats[p].nActive;
+            }
+        }
+    }
+
+    updateContacts();
+    if (filtered) {
+        // The slips are tracked on the whole patch of the fingers in contact
+        if (slip.isEnabled()) {
+            for (int i = 0; i < nFingers; ++i) {
+                if (fingers[i].contact) {
+                    for (int k = 0; k < patches[i].count; ++k) {
+                        taxelFilter.filter(patches[i].offset + k, i_skinComp[patches[i].offset + k]);
+                    }
+                }
+            }
+        }
+        taxelFilter.next();
+        detectSlip(taxelFilter.getOutput().data());
+    } else {
+        detectSlip(i_skinComp.data());
+    }
+
+    return true;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Update the contact states                                        ********************************************** */
+void GraspController::updateContacts(void) {
+    // A finger gets in contact when any of its taxels reaches the touch threshold, and is released when all of them are
+    // below the release threshold. The state only changes after debounce samples in a row agree.
+    for (int i = 0; i < nFingers; ++i) {
+        FingerState &finger = fingers[i];
+        bool contact = finger.contact ? (patchStats[i].max >= config.releaseThresholds[i]) : (patchStats[i].nActive > 0);
+        finger.maxTaxel = patchStats[i].max;
+        if (contact == finger.contact) {
+            finger.pendingSamples = 0;
+        } else if (++finger.pendingSamples >= debounce) {
+            finger.pendingSamples = 0;
+            finger.contactOnset = finger.contactOnset || contact;
+            finger.contact = contact;
+            ++finger.switches;
+        }
+    }
+    if (hasPalm) {
+        palmContact = (patchStats[nFingers].nActive > 0);
+        palmTriggered = palmTriggered || palmContact;
+    }
+
+    if (AsyncLog::get().isEnabled(LogLevel::Debug)) {
+        for (int i = 0; i < nFingers; ++i) {
+            maxTaxels[i] = fingers[i].maxTaxel;
+        }
+        AsyncLog::logVector(LogLevel::Debug, dbgTag, "Maximum contact detected:", maxTaxels.data(), maxTaxels.size());
+    }
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Track the slips                                                  ********************************************** */
+void GraspController::detectSlip(const double *i_skin) {
+    if (!slip.isEnabled()) {
+        return;
+    }
+
+    double start = yarp::os::Time::now();
+    for (int i = 0; i < nFingers; ++i) {
+        if (fingers[i].contact) {
+            if (slip.update(i, i_skin + patches[i].offset, patches[i].count)) {
+                // The tightening starts at the next velocity command
+                fingers[i].slipPending = true;
+                AsyncLog::log(LogLevel::Info, dbgTag, "Finger %d is slipping. Tightening. ", i);
+            }
+        } else {
+            slip.release(i);
+        }
+    }
+    slip.recordCost(yarp::os::Time::now() - start);
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Forecast the contacts                                            ********************************************** */
+void GraspController::predictContacts(const double &i_time) {
+    if (!predictor.isEnabled()) {
+        return;
+    }
+
+    for (int i = 0; i < nFingers; ++i) {
+        double scale = predictor.update(i, i_time, fingers[i].maxTaxel, patches[i].threshold);
+        if ((scale <= 0.0) && (fingers[i].predictedScale > 0.0) && !fingers[i].contact) {
+            AsyncLog::log(LogLevel::Info, dbgTag, "Finger %d is forecast to touch in %g ms. Stopping. ", i, 
+                1000.0 * (predictor.getPredictedCross(i) - i_time));
+        }
+        fingers[i].predictedScale = scale;
+    }
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Compute the grasp velocities                                     ********************************************** */
+const std::vector<double> &GraspController::computeVelocities(const double &i_time) {
+    double dt = (lastControlTime >= 0.0) ? std::max(0.0, i_time - lastControlTime) : 0.0;
+    lastControlTime = i_time;
+
+    // Loop all fingers
+    for (int i = 0; i < nFingers; ++i) {
+        // A slipping finger is tightened for a while
+        if (fingers[i].slipPending) {
+            fingers[i].slipPending = false;
+            fingers[i].slipOnset = true;
+            fingers[i].tightenUntil = i_time + slip.getTightenTime();
+        }
+        bool tighten = (i_time < fingers[i].tightenUntil);
+
+        // In a power grasp the fingers wait for the palm to touch the object
+        bool wait = palmTrigger && !palmTriggered;
+        // Fingers without a target pressure stop at contact
+        if ((config.mode == GraspType::Regulate) && !wait && (targetPressures[i] > 0.0)) {
+            // The finger velocities follow the pressure error
+            double scale = regulate(i, dt);
+            if (tighten) {
+                scale = std::max(scale, slip.getTightenScale());
+            }
+            for (int j = commandOffsets[i]; j < commandOffsets[i + 1]; ++j) {
+                graspVelocities[commands[j].joint] = scale * config.velocities.grasp[commands[j].velocity];
+            }
+        } else {
+            bool stop = fingers[i].contact || (fingers[i].predictedScale <= 0.0) || wait;
+            const double *fingerVelocities = (stop ? &config.velocities.stop[0] : &config.velocities.grasp[0]);
+            // A finger released after a forecast creeps on to the contact
+            double scale = (stop ? 1.0 : fingers[i].predictedScale);
+            // Loop all joints in that finger
+            for (int j = commandOffsets[i]; j < commandOffsets[i + 1]; ++j) {
+                graspVelocities[commands[j].joint] = scale * fingerVelocities[commands[j].velocity];
+            }
+            if (stop && tighten && !wait) {
+                // Squeeze the slipping object
+                for (int j = commandOffsets[i]; j < commandOffsets[i + 1]; ++j) {
+                    graspVelocities[commands[j].joint] = std::max(graspVelocities[commands[j].joint], 
+                        slip.getTightenScale() * config.velocities.grasp[commands[j].velocity]);
+                }
+            }
+        }
+    }
+
+    AsyncLog::logVector(LogLevel::Debug, dbgTag, "Moving joints at velocities:", graspVelocities.data(), graspVelocities.size());
+
+    return graspVelocities;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Set touch threshold.                                             ********************************************** */
+bool GraspController::setTouchThreshold(const int aFinger, const double aThreshold) {
+    GraspConfig edited(config);
+    if (!edited.setTouchThreshold(aFinger, aThreshold)) {
+        cerr << dbgTag << "RPC::setTouchThreshold() - The specified finger is out of range. \n";
+        return false;
+    }
+    applyConfig(edited);
+
+    return true;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Set the given velocity                                           ********************************************** */
+bool GraspController::setVelocities(const int &i_type, const std::vector<double> &i_vel) {
+    GraspConfig edited(config);
+    if (!edited.setVelocities(i_type, i_vel)) {
+        return false;
+    }
+    applyConfig(edited);
+
+    return true;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Set the velocity for the given joint.                            ********************************************** */
+bool GraspController::setVelocity(const int &i_type, const int &i_joint, const double &i_vel) {
+    GraspConfig edited(config);
+    if (!edited.setVelocity(i_type, i_joint, i_vel)) {
+        return false;
+    }
+    applyConfig(edited);
+
+    return true;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Use new settings                                                 ********************************************** */
+void GraspController::applyConfig(const GraspConfig &i_config) {
+    bool newGrasp = (i_config.modeSelections != config.modeSelections);
+
+    config.copyFrom(i_config);
+    for (int i = 0; i < nFingers; ++i) {
+        patches[i].threshold = config.touchThresholds[i];
+    }
+
+    if (newGrasp) {
+        // The regulators start from scratch
+        std::fill(integrals.begin(), integrals.end(), 0.0);
+        lastControlTime = -1.0;
+    }
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Generate the mapping of each finger into the controllable joints it contains.  ******************************** */
+bool GraspController::generateJointMap(void) {
+    commandOffsets.assign(1, 0);
+    commands.clear();
+
+    // Loop fingers
+    for (int i = 0; i < nFingers; ++i) {
+        if (patches[i].threshold >= 0) {
+            for (int j = hand.getJointBegin(i); j < hand.getJointEnd(i); ++j) {
+                JointCommand command;
+                command.joint = hand.getJoint(j);
+                command.velocity = command.joint - hand.getJointOffset();
+                if ((nJoints > 0) && (command.joint >= nJoints)) {
+                    cerr << dbgTag << "Finger " << i << " joint " << command.joint << " is not controlled by the velocity interface. \n";
+                    return false;
+                }
+                commands.push_back(command);
+            }
+        }
+        commandOffsets.push_back(commands.size());
+    }
+
+    return true;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Build the taxel patches of the hand skin.                        ********************************************** */
+bool GraspController::configureSkinLayout(yarp::os::Searchable &rf, const double &i_palmThreshold) {
+    using yarp::os::Bottle;
+
+    Bottle &confLayout = rf.findGroup("skinLayout");
+    Bottle *confTips = confLayout.isNull() ? NULL : confLayout.find("fingertips").asList();
+    Bottle *confPalm = confLayout.isNull() ? NULL : confLayout.find("palm").asList();
+
+    // Fingertips
+    if (confTips) {
+        if (confTips->size() != nFingers) {
+            cerr << dbgTag << "The [skinLayout] fingertips must contain one (offset count) pair per touch threshold. \n";
+            return false;
+        }
+        for (int i = 0; i < nFingers; ++i) {
+            Bottle *tip = confTips->get(i).asList();
+            if (!tip || (tip->size() != 2)) {
+                cerr << dbgTag << "Invalid [skinLayout] fingertip " << i << ". Expected (offset count). \n";
+                return false;
+            }
+            patches[i].offset = tip->get(0).asInt();
+            patches[i].count = tip->get(1).asInt();
+        }
+    } else {
+        for (int i = 0; i < nFingers; ++i) {
+            patches[i].offset = hand.getTaxelsPerFinger()*i;
+            patches[i].count = hand.getTaxelsPerFinger();
+        }
+    }
+
+    // Palm
+    hasPalm = false;
+    if (confPalm) {
+        if (confPalm->size() != 2) {
+            cerr << dbgTag << "Invalid [skinLayout] palm. Expected (offset count). \n";
+            return false;
+        }
+        TaxelPatch palm;
+        palm.offset = confPalm->get(0).asInt();
+        palm.count = confPalm->get(1).asInt();
+        palm.threshold = i_palmThreshold;
+        patches.push_back(palm);
+        hasPalm = true;
+    } else if (palmTrigger) {
+        cerr << dbgTag << "The palm trigger requires the palm to be configured in the [skinLayout] group. \n";
+        return false;
+    }
+
+    // Skin vector size covering all the patches
+    skinSize = 0;
+    for (size_t i = 0; i < patches.size(); ++i) {
+        if ((patches[i].offset < 0) || (patches[i].count < 0)) {
+            cerr << dbgTag << "Invalid [skinLayout] patch " << i << ". \n";
+            return false;
+        }
+        skinSize = std::max(skinSize, static_cast<size_t>(patches[i].offset + patches[i].count));
+    }
+
+    // Preallocate the reduction results
+    patchStats.resize(patches.size());
+    referenceStats.resize(patches.size());
+
+    // Taxel to patch lookup of the sparse detection. Where patches overlap the last one wins.
+    taxelPatches.assign(skinSize, -1);
+    for (size_t i = 0; i < patches.size(); ++i) {
+        for (int t = patches[i].offset; t < patches[i].offset + patches[i].count; ++t) {
+            taxelPatches[t] = static_cast<int>(i);
+        }
+    }
+
+    cout << dbgTag << "Skin layout has " << patches.size() << " patches over " << skinSize << " taxels. Using the " 
+        << SkinPatchKernel::getInstructionSet() << " contact detection kernel. \n";
+
+    return true;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Read the contact filtering parameters                            ********************************************** */
+bool GraspController::configureFiltering(yarp::os::Searchable &rf) {
+    using yarp::os::Bottle;
+
+    Bottle &confGrasp = rf.findGroup("graspTh");
+
+    // Release thresholds
+    config.releaseThresholds.resize(nFingers);
+    Bottle *confRelease = confGrasp.find("releaseThresholds").asList();
+    if (confRelease) {
+        if (confRelease->size() != nFingers) {
+            cerr << dbgTag << "The [graspTh] releaseThresholds must contain one value per touch threshold. \n";
+            return false;
+        }
+        for (int i = 0; i < nFingers; ++i) {
+            config.releaseThresholds[i] = std::min(confRelease->get(i).asDouble(), patches[i].threshold);
+        }
+    } else {
+        for (int i = 0; i < nFingers; ++i) {
+            config.releaseThresholds[i] = patches[i].threshold;
+        }
+    }
+    config.releaseMargins.resize(nFingers);
+    for (int i = 0; i < nFingers; ++i) {
+        config.releaseMargins[i] = patches[i].threshold - config.releaseThresholds[i];
+    }
+
+    // Taxel filter
+    std::string filter = confGrasp.check("filter", Value("none")).asString().c_str();
+    if (!taxelFilter.configure(filter, confGrasp.check("filterWindow", Value(3)).asInt(), skinSize)) {
+        cerr << dbgTag << "Invalid [graspTh] filter " << filter << ". Expected none, average or median. \n";
+        return false;
+    }
+    debounce = std::max(1, confGrasp.check("debounce", Value(1)).asInt());
+
+    cout << dbgTag << "Contact detection with the " << taxelFilter.getName() << " taxel filter and a debounce of " << debounce 
+        << " samples. This adds up to " << getDetectionDelay() << " skin samples of latency. \n";
+
+    return true;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Read the pressure regulation parameters                          ********************************************** */
+bool GraspController::configureRegulation(yarp::os::Searchable &rf) {
+    using yarp::os::Bottle;
+
+    Bottle &confRegulation = rf.findGroup("regulation");
+
+    // Target pressures
+    targetPressures.resize(nFingers);
+    Bottle *confTargets = confRegulation.isNull() ? NULL : confRegulation.find("targetPressures").asList();
+    if (confTargets) {
+        if (confTargets->size() != nFingers) {
+            cerr << dbgTag << "The [regulation] targetPressures must contain one value per touch threshold. \n";
+            return false;
+        }
+        for (int i = 0; i < nFingers; ++i) {
+            targetPressures[i] = confTargets->get(i).asDouble();
+        }
+    } else {
+        for (int i = 0; i < nFingers; ++i) {
+            targetPressures[i] = 2.0*patches[i].threshold;
+        }
+    }
+
+    // Gains and saturation
+    regulation.kp = confRegulation.check("kp", Value(0.05)).asDouble();
+    regulation.ki = confRegulation.check("ki", Value(0.2)).asDouble();
+    regulation.maxScale = confRegulation.check("maxScale", Value(1.0)).asDouble();
+    regulation.minScale = confRegulation.check("minScale", Value(-0.5)).asDouble();
+    regulation.tolerance = confRegulation.check("tolerance", Value(2.0)).asDouble();
+    if (regulation.minScale > regulation.maxScale) {
+        cerr << dbgTag << "The [regulation] minScale is greater than maxScale. \n";
+        return false;
+    }
+
+    integrals.assign(nFingers, 0.0);
+    lastControlTime = -1.0;
+
+    return true;
+}
+/* *********************************************************************************************************************** */
+
+/* *********************************************************************************************************************** */
+/* ******* Check the vectorised reduction against the scalar reference.     ********************************************** */
+void GraspController::validatePatchStats(const yarp::sig::Vector &i_skinComp) {
+    SkinPatchKernel::reduceScalar(i_skinComp.data(), &patches[0], patches.size(), &referenceStats[0]);
+
+    for (size_t i = 0; i < patches.size(); ++i) {
+        // The sums are accumulated in a different order
+        double sumTolerance = 1e-9 * std::max(1.0, std::fabs(referenceStats[i].sum));
+        if ((patchStats[i].max != referenceStats[i].max) || (patchStats[i].nActive != referenceStats[i].nActive)
+                || (std::fabs(patchStats[i].sum - referenceStats[i].sum) > sumTolerance)) {
+            AsyncLog::log(LogLevel::Error, dbgTag, "Contact detection kernel mismatch on patch %d: max %g / %g, sum %g / %g, active %d / %d. ", 
+                static_cast<int>(i), patchStats[i].max, referenceStats[i].max, patchStats[i].sum, referenceStats[i].sum, 
+                patchStats[i].nActive, referenceStats[i].nActive);
+        }
+    }
+}
+/* *********************************************************************************************************************** */
@@ -19,8 +19,11 @@
 
 
 #include "iCub/tactileGrasp/GraspThread.h"
+#include "iCub/tactileGrasp/AllocationCounter.h"
+#include "iCub/tactileGrasp/AsyncLog.h"
 
 #include <iostream>
+#include <cmath>
 #include <algorithm>
 
 #include <yarp/os/Property.h>
@@ -32,6 +35,11 @@ using std::cout;
 using std::string;
 
 using iCub::tactileGrasp::GraspThread;
+using iCub::tactileGrasp::StreamFrameType;
+using iCub::tactileGrasp::MotionStatus;
+using iCub::tactileGrasp::Pose;
+using iCub::tactileGrasp::GraspPhase;
+using iCub::tactileGrasp::RateScheduler;
 
 using yarp::os::RateThread;
 using yarp::os::Value;
@@ -39,21 +47,60 @@ using yarp::os::Value;
 
 /* *********************************************************************************************************************** */
 /* ******* Constructor                                                      ********************************************** */   
-GraspThread::GraspThread(const int aPeriod, const yarp::os::ResourceFinder &aRf) 
-    : RateThread(aPeriod) {
+GraspThread::GraspThread(const int aPeriod, const yarp::os::ResourceFinder &aRf, const std::string &aHand, StartupTimer *aStartup) 
+    : RateThread(aPeriod), loopMonitor(aPeriod/1000.0) {
         period = aPeriod;
         rf = aRf;
 
-        nFingers = 0;
-
-        dbgTag = "GraspThread: ";
+        nJointsVel = 0;
+
+        iPos2 = NULL;
+
+        motionMonitor = NULL;
+        motionTimeout = 0.0;
+
+        reachOnStart = false;
+        reachOnGrasp = true;
+        reachMotion = -1;
+        armReached = false;
+        startup = (aStartup ? aStartup : &localStartup);
+        whichHand = aHand;
+        tickOrigin = 0.0;
+        tickOffset = -1.0;
+
+        eventDriven = false;
+        callbackScheduled = false;
+        skinTimeout = 0.0;
+        lastSkinTime = 0.0;
+        watchdogActive = false;
+
+        stopLatencies = NULL;
+        slipLatencies = NULL;
+
+        portSkinIn = &portGraspThreadInSkinComp;
+
+        sparseDetection = false;
+        contactsTimeout = 0.0;
+        lastContactsTime = 0.0;
+        contactsLate = true;
+        handSkinPart = iCub::skinDynLib::SKIN_PART_UNKNOWN;
+        sparseFrames = 0;
+        denseFrames = 0;
+        trackingDrift = false;
+        telemetryPending = false;
+        commandTime = 0.0;
+
+        dbgTag = (whichHand.empty() ? "GraspThread: " : "GraspThread(" + whichHand + "): ");
 }
 /* *********************************************************************************************************************** */
 
 
 /* *********************************************************************************************************************** */
 /* ******* Destructor                                                       ********************************************** */   
-GraspThread::~GraspThread() {}
+GraspThread::~GraspThread() {
+    delete[] stopLatencies;
+    delete[] slipLatencies;
+}
 /* *********************************************************************************************************************** */
 
 
@@ -67,78 +114,114 @@ bool GraspThread::threadInit(void) {
     using std::vector;
 
     cout << dbgTag << "Initialising. \n";
+    double initStart = Time::now();
 
     /* ******* Extract configuration files          ******* */
     string robotName = rf.check("robot", Value("icub"), "The robot name.").asString().c_str();
-    string whichHand = rf.check("whichHand", Value("right"), "The hand to be used for the grasping.").asString().c_str();
-
+    if (whichHand.empty()) {
+        whichHand = rf.check("whichHand", Value("right"), "The hand to be used for the grasping.").asString().c_str();
+    }
 
-    // Build grasp parameters
-    Bottle &confGrasp = rf.findGroup("graspTh");
-    if (!confGrasp.isNull()) {
-        // Individual touch thresholds per fingertip
-        Bottle *confTouchThr = confGrasp.find("touchThresholds").asList();
-
-        if (!confTouchThr->isNull()) {
-            // Generate parameter vectors
-            nFingers = confTouchThr->size();
-            for (int i = 0; i < confTouchThr->size(); ++i) {
-                touchThresholds.push_back(confTouchThr->get(i).asDouble());
-            }
-        } else {
-            cerr << dbgTag << "Could not find the touch thresholds in the specified configuration file under the [graspTh] parameter group. \n";
-            return false;
-        }
-    } else {
-        cerr << dbgTag << "Could not find grasp configuration [graspTh] group in the specified configuration file. \n";
+    // Startup
+    Bottle &confStartup = rf.findGroup("startup");
+    string reachMode = confStartup.check("reach", Value("lazy")).asString().c_str();
+    if ((reachMode != "lazy") && (reachMode != "start") && (reachMode != "off")) {
+        cerr << dbgTag << "Invalid [startup] reach " << reachMode << ". Expected lazy, start or off. \n";
         return false;
     }
+    reachOnStart = (reachMode == "start");
+    reachOnGrasp = (reachMode != "off");
+    double encoderTimeout = confStartup.check("encoderTimeout", Value(5.0)).asDouble();
 
 
-    /* ******* Build finger to joint map.           ******* */
-    generateJointMap(touchThresholds);
+    // Build grasp parameters
+    double phaseStart = Time::now();
+    if (!controller.configure(rf)) {
+        return false;
+    }
+    stopLatencies = new LatencyHistogram[controller.getFingerCount()];
+    slipLatencies = new LatencyHistogram[controller.getFingerCount()];
+    if (!compensator.configure(rf)) {
+        return false;
+    }
+    startup->record(whichHand + " grasp configuration", phaseStart);
 
+    // Event-driven control
+    Bottle &confGrasp = rf.findGroup("graspTh");
+    eventDriven = (confGrasp.check("eventDriven", Value("off")).asString() == "on");
+    skinTimeout = confGrasp.check("skinTimeout", Value(2.0*period/1000.0)).asDouble();
 
-    // Print out debug information
-#ifndef NODEBUG
-    cout << "\n";
-    cout << "DEBUG: " << dbgTag << " Configured joints and thresholds: \n";
-    for (size_t i = 0; i < touchThresholds.size(); ++i) {
-        cout << "DEBUG: " << dbgTag << "\tFinger ID: " << i << "\t Touch threshold: " << touchThresholds[i] << "\t Joints: ";
-        vector<int> fingerJoints = jointMap[i];
-        for (size_t j = 0; j < fingerJoints.size(); ++j) {
-            cout << fingerJoints[j] << " ";
-        }
-        cout << "\n";
+    // Sparse contact detection
+    string detection = confGrasp.check("detection", Value("dense")).asString().c_str();
+    if ((detection != "dense") && (detection != "sparse")) {
+        cerr << dbgTag << "Invalid [graspTh] detection " << detection << ". Expected dense or sparse. \n";
+        return false;
     }
-    cout << "\n";
-#endif
+    sparseDetection = (detection == "sparse");
+    contactsTimeout = confGrasp.check("contactsTimeout", Value(0.1)).asDouble();
+    contactsLate = true;
 
+    // Real-time scheduling, applied once the buffers are allocated
+    if (!scheduling.configure(rf)) {
+        return false;
+    }
+    callbackScheduling = scheduling;
+    callbackScheduled = false;
 
-    /* ******* Initialise previous contacts.        ******* */
-    previousContacts.resize(nFingers, false);
+    // Adaptive control rate
+    if (!rateScheduler.configure(rf, controller.getFingerCount(), period, controller.getSlipDetector().isEnabled())) {
+        return false;
+    }
+    if (rateScheduler.isEnabled() && eventDriven) {
+        // The skin data paces the control, the periodic tick is only the watchdog
+        cout << dbgTag << "The adaptive control rate is not used with the event-driven control. \n";
+        rateScheduler.setEnabled(false);
+    }
+    if (rateScheduler.isEnabled() && (tickOffset >= 0.0)) {
+        cout << dbgTag << "The adaptive control rate does not keep the ticks interleaved with those of the other hand. \n";
+    }
+    if (rateScheduler.isEnabled()) {
+        // Nothing to control until the first grasp
+        applyRate();
+    }
+    handSkinPart = ((whichHand == "left") ? iCub::skinDynLib::SKIN_LEFT_HAND : iCub::skinDynLib::SKIN_RIGHT_HAND);
+    activeTaxels.reserve(controller.getSkinSize());
 
 
     /* ******* Ports                                ******* */
     portGraspThreadInSkinComp.open("/TactileGrasp/skin/" + whichHand + "_hand_comp:i");
     portGraspThreadInSkinRaw.open("/TactileGrasp/skin/" + whichHand + "_hand_raw:i");
-    portGraspThreadInSkinContacts.open("/TactileGrasp/skin/contacts:i");
+    portGraspThreadInSkinContacts.open("/TactileGrasp/skin/" + whichHand + "_contacts:i");
+    portGraspThreadOutTelemetry.open("/TactileGrasp/telemetry/" + whichHand + ":o");
 
 
     /* ******* Joint interfaces                     ******* */
     string arm = whichHand + "_arm";
+    string skinSource = "/icub/skin/" + whichHand + "_hand_comp";
+    string rawSkinSource = "/icub/skin/" + whichHand + "_hand";
     Property options;
-    options.put("robot", robotName.c_str()); 
-    options.put("device", "remote_controlboard");
-//    options.put("writeStrict", "on");
-    options.put("part", arm.c_str());
-    options.put("local", ("/TactileGrasp/" + arm).c_str());
-    options.put("remote", ("/" + robotName + "/" + arm).c_str());
+    if (rf.check("simulation", Value("off")).asString() == "on") {
+        // Simulated arm publishing its own fingertip skin
+        skinSource = "/TactileGrasp/sim/skin/" + whichHand + "_hand_comp";
+        rawSkinSource = "/TactileGrasp/sim/skin/" + whichHand + "_hand";
+        if (!configureSimulation(options, skinSource, (compensator.isEnabled() ? rawSkinSource : ""))) {
+            return false;
+        }
+    } else {
+        options.put("robot", robotName.c_str()); 
+        options.put("device", "remote_controlboard");
+//        options.put("writeStrict", "on");
+        options.put("part", arm.c_str());
+        options.put("local", ("/TactileGrasp/" + arm).c_str());
+        options.put("remote", ("/" + robotName + "/" + arm).c_str());
+    }
     
     // Open driver
+    phaseStart = Time::now();
     if (!clientArm.open(options)) {
         return false;
     }
+    startup->record(whichHand + " arm driver", phaseStart);
     // Open interfaces
     clientArm.view(iEncs);
     if (!iEncs) {
@@ -152,31 +235,45 @@ bool GraspThread::threadInit(void) {
     if (!iVel) {
         return false;
     }
+    // Batched multi-joint commands, when the driver supports them
+    clientArm.view(iPos2);
     // Set velocity control parameters
     iVel->getAxes(&nJointsVel);
     std::vector<double> refAccels(nJointsVel, 10^6);
     iVel->setRefAccelerations(&refAccels[0]);
+    // Preallocate the commanded velocities
+    if (!controller.setJointCount(nJointsVel)) {
+        return false;
+    }
+    configs.reset(controller.getConfig());
 
     
     /* ******* Store position prior to acquiring control.           ******* */
     int nnJoints;
     iPos->getAxes(&nnJoints);
     startPos.resize(nnJoints);
-    bool ok = false;
-    while(!ok) {
-        ok = iEncs->getEncoders(startPos.data());
+    phaseStart = Time::now();
+    bool ok = iEncs->getEncoders(startPos.data());
 #ifndef NODEBUG
-        cout << "DEBUG: " << dbgTag << "Encoder data is not available yet. \n";
+    if (!ok) {
+        cout << "DEBUG: " << dbgTag << "Encoder data is not available yet. Waiting up to " << encoderTimeout << " s. \n";
+    }
 #endif
-        Time::delay(0.1);
+    while (!ok) {
+        if (Time::now() - phaseStart > encoderTimeout) {
+            cerr << dbgTag << "No encoder data received within " << encoderTimeout << " s. \n";
+            return false;
+        }
+        Time::delay(0.01);
+        ok = iEncs->getEncoders(startPos.data());
     }
-    // Set reference speeds
-    vector<double> refSpeeds(nnJoints, 0);
-    iPos->getRefSpeeds(&refSpeeds[0]);
-    for (int i = 11; i < 15; ++i) {
-        refSpeeds[i] = 50;
+    startup->record(whichHand + " arm encoders", phaseStart);
+
+    // Named poses
+    if (!poses.configure(rf, nnJoints)) {
+        return false;
     }
-    iPos->setRefSpeeds(&refSpeeds[0]);
+    cout << dbgTag << "Sending the poses as " << (iPos2 ? "batched multi-joint commands" : "single-joint commands") << ". \n";
 
 #ifndef NODEBUG
     cout << "\n";
@@ -187,12 +284,94 @@ bool GraspThread::threadInit(void) {
     cout << "\n";
 #endif
 
-    // Put arm in position
-    reachArm();
+    /* ******* Motion completion tracking           ******* */
+    Bottle &confMotion = rf.findGroup("motion");
+    motionTimeout = confMotion.check("timeout", Value(10.0)).asDouble();
+    motionMonitor = new MotionMonitor(confMotion.check("checkPeriod", Value(10)).asInt(), iPos, iPos2);
+    motionMonitor->setListener(&poses);
+    if (!motionMonitor->start()) {
+        cerr << dbgTag << "Could not start the motion monitor. \n";
+        return false;
+    }
+
+    // Put arm in position, without waiting for it. Otherwise this is done on the first grasp or on request.
+    if (reachOnStart) {
+        cout << dbgTag << "Reaching for grasp. \n";
+        moveToPose("reach");
+    }
+
+
+    /* ******* Stream recording                     ******* */
+    string recordFile = rf.check("record", Value(""), "The binary log of the grasp streams.").asString().c_str();
+    if (!recordFile.empty()) {
+        // One log per hand when grasping with both
+        if (rf.check("whichHand", Value("right")).asString() == "both") {
+            size_t dot = recordFile.rfind('.');
+            recordFile.insert((dot == string::npos) ? recordFile.size() : dot, "_" + whichHand);
+        }
+        if (!recorder.open(recordFile, nJointsVel)) {
+            return false;
+        }
+        recordedEncoders.assign(nnJoints, 0.0);
+        // The raw skin and the contacts are only read to be recorded, unless they drive the control
+        if (skinSource.find("/icub/") == 0) {
+            if (!compensator.isEnabled()) {
+                Network::connect(rawSkinSource.c_str(), ("/TactileGrasp/skin/" + whichHand + "_hand_raw:i").c_str());
+            }
+            if (!sparseDetection) {
+                Network::connect("/skinManager/skin_events:o", ("/TactileGrasp/skin/" + whichHand + "_contacts:i").c_str());
+            }
+        }
+    }
 
 
     // Connecting ports
-    Network::connect(("/icub/skin/" + whichHand + "_hand_comp"), ("/TactileGrasp/skin/" + whichHand + "_hand_comp:i"));
+    phaseStart = Time::now();
+    if (compensator.isEnabled()) {
+        // The contacts are detected on the raw skin compensated here, without going through the skinManager
+        cout << dbgTag << "Compensating the raw skin in the module. \n";
+        portSkinIn = &portGraspThreadInSkinRaw;
+        Network::connect(rawSkinSource.c_str(), ("/TactileGrasp/skin/" + whichHand + "_hand_raw:i").c_str());
+    } else {
+        portSkinIn = &portGraspThreadInSkinComp;
+        Network::connect(skinSource.c_str(), ("/TactileGrasp/skin/" + whichHand + "_hand_comp:i"));
+    }
+    if (sparseDetection) {
+        // Without the skinManager, e.g. in simulation, the dense detection takes over
+        cout << dbgTag << "Detecting the contacts from the skin contact list, with a timeout of " << contactsTimeout << " s. \n";
+        Network::connect("/skinManager/skin_events:o", ("/TactileGrasp/skin/" + whichHand + "_contacts:i").c_str());
+    }
+    startup->record(whichHand + " skin connection", phaseStart);
+
+    // The baselines are calibrated before anything touches the hand
+    if (compensator.isEnabled()) {
+        phaseStart = Time::now();
+        if (!calibrateSkin(rf.findGroup("compensation").check("calibrationTimeout", Value(5.0)).asDouble())) {
+            return false;
+        }
+        startup->record(whichHand + " skin calibration", phaseStart);
+    }
+
+    // Trigger the control on skin data arrival
+    if (eventDriven) {
+        cout << dbgTag << "Using event-driven control with a watchdog timeout of " << skinTimeout << " s. \n";
+        portSkinIn->useCallback(*this);
+    }
+
+    // The control buffers are all allocated: lock them in memory and raise the priority
+    scheduling.apply(dbgTag);
+
+    startup->record(whichHand + " grasp thread", initStart);
+
+    // Interleave the ticks with those of the other hand
+    if (tickOffset >= 0.0) {
+        double periodSec = period/1000.0;
+        double wait = std::fmod(tickOrigin + tickOffset - Time::now(), periodSec);
+        if (wait < 0.0) {
+            wait += periodSec;
+        }
+        Time::delay(wait);
+    }
 
     
     cout << dbgTag << "Initialised correctly. \n";
@@ -205,51 +384,67 @@ bool GraspThread::threadInit(void) {
 /* *********************************************************************************************************************** */
 /* ******* Run thread                                                       ********************************************** */
 void GraspThread::run(void) {
-    using std::deque;
-    using std::vector;
+    using yarp::os::Time;
+    using yarp::sig::Vector;
 
+    // Suspended: only follow the drift of the baselines, as the skin callback does
+    if (trackingDrift) {
+        controlMutex.lock();
+        Vector *inRaw = portSkinIn->read(false);
+        if (inRaw) {
+            compensator.compensate(*inRaw, compensatedSkin);
+        }
+        controlMutex.unlock();
+        return;
+    }
+
+    loopMonitor.tickStarted(getIterations());
 
-    // Check that the control thread is actually being run or if this is just the module::configure() acting.
-    if (velocities.grasp.size() > 0) {
-        deque<bool> contacts (false, nFingers);
-        vector<double> graspVelocities(nJointsVel, 0);
-        if (detectContact(contacts)) {
-            // Loop all contacts
-            for (size_t i = 0; i < contacts.size(); ++i) {
-                vector<int> fingerJoints = jointMap[i];
-                if (!contacts[i]) {
-                    // Loop all joints in that finger
-                    for (size_t j = 0; j < fingerJoints.size(); ++j) {
-                        // FG: -8 is required as the velocities array contains only finger joints speeds i.e. joints with id >= 8.
-                        graspVelocities[fingerJoints[j]] = velocities.grasp[fingerJoints[j] - 8];
+    recordStreams();
+    if (!eventDriven) {
+        readContacts();
+    }
+
+    controlMutex.lock();
+    {
+        applySettings();
+        // Check that the control thread is actually being run or if this is just the module::configure() acting.
+        if (controller.hasVelocities()) {
+            if (eventDriven) {
+                // Watchdog: the skin callback is in charge of the control as long as skin data keeps arriving
+                bool skinLate = ((Time::now() - lastSkinTime) > skinTimeout);
+                if (skinLate != watchdogActive) {
+                    watchdogActive = skinLate;
+                    if (watchdogActive) {
+                        AsyncLog::log(LogLevel::Warning, dbgTag, "No skin data received for %g s. Watchdog is using previous contacts. ", skinTimeout);
+                    } else {
+                        AsyncLog::log(LogLevel::Info, dbgTag, "Skin data is back. Watchdog released the control. ");
                     }
+                }
+                if (watchdogActive) {
+                    sendVelocities();
+                }
+            } else {
+                Vector *inSkin = portSkinIn->read(false);
+                if (inSkin) {
+                    portSkinIn->getEnvelope(skinStamp);
+                    processSkin(*inSkin);
                 } else {
-                    // Loop all joints in that finger
-                    for (size_t j = 0; j < fingerJoints.size(); ++j) {
-                        // FG: -8 is required as the velocities array contains only finger joints speeds i.e. joints with id >= 8.
-                        graspVelocities[fingerJoints[j]] = velocities.stop[fingerJoints[j] - 8];
-                    }
+                    AsyncLog::log(LogLevel::Debug, dbgTag, "No skin data. Using previous contacts. ");
                 }
+                sendVelocities();
             }
         } else {
-            cout << dbgTag << "No contact. \n";
-        }
-
-#ifndef NODEBUG
-        cout << "DEBUG: " << dbgTag << "Moving joints at velocities: \t";
-        for (size_t i = 0; i < graspVelocities.size(); ++i) {
-            cout << i << " " << graspVelocities[i] << "\t";
+            AsyncLog::log(LogLevel::Debug, dbgTag, "Module initialisation running. ");
         }
-        cout << "\n";
-#endif
-
-        // Send move command
-        iVel->velocityMove(&graspVelocities[0]);
-    } else {
-#ifndef NODEBUG
-        cout << "DEBUG: " << dbgTag << "Module initialisation running. \n";
-#endif
     }
+    publishTelemetry();
+    if (rateScheduler.isEnabled() && rateScheduler.update(controller, Time::now())) {
+        applyRate();
+    }
+    controlMutex.unlock();
+
+    loopMonitor.tickEnded();
 }  
 /* *********************************************************************************************************************** */
 
@@ -260,12 +455,17 @@ void GraspThread::threadRelease(void) {
     cout << dbgTag << "Releasing. \n";
     
     // Close ports
+    if (eventDriven) {
+        portSkinIn->disableCallback();
+    }
     portGraspThreadInSkinComp.interrupt();
     portGraspThreadInSkinRaw.interrupt();
     portGraspThreadInSkinContacts.interrupt();
+    portGraspThreadOutTelemetry.interrupt();
     portGraspThreadInSkinComp.close();
     portGraspThreadInSkinRaw.close();
     portGraspThreadInSkinContacts.close();
+    portGraspThreadOutTelemetry.close();
 
     // Stop interfaces
     if (iVel) {
@@ -277,63 +477,241 @@ void GraspThread::threadRelease(void) {
         iPos->positionMove(startPos.data());
     }
 
+    // Stop tracking the motions before closing the driver
+    if (motionMonitor) {
+        motionMonitor->stop();
+        delete motionMonitor;
+        motionMonitor = NULL;
+    }
+
     // Close driver
     clientArm.close();
 
+    recorder.close();
+
     cout << dbgTag << "Released. \n";
 }
 /* *********************************************************************************************************************** */
 
 /* *********************************************************************************************************************** */
-/* ******* Detect contact on each finger.                                   ********************************************** */
-bool GraspThread::detectContact(std::deque<bool> &o_contacts) {
-    using yarp::sig::Vector;
-    using std::deque;
-    using std::vector;
+/* ******* Skin data callback                                               ********************************************** */
+void GraspThread::onRead(yarp::sig::Vector &aSkin) {
+    using yarp::os::Time;
+
+    // The callback runs in the thread of the port: it gets the real-time options on its first call
+    if (!callbackScheduled) {
+        callbackScheduling.apply(dbgTag + "Skin callback: ");
+        callbackScheduled = true;
+    }
+
+    readContacts();
+
+    controlMutex.lock();
+    lastSkinTime = Time::now();
+    portSkinIn->getEnvelope(skinStamp);
+    applySettings();
+    // The skin keeps streaming while the grasp is suspended
+    if (!isSuspended() && controller.hasVelocities()) {
+        processSkin(aSkin);
+        sendVelocities();
+    } else if (compensator.isEnabled()) {
+        // Keep following the drift of the baselines
+        compensator.compensate(aSkin, compensatedSkin);
+    }
+    publishTelemetry();
+    controlMutex.unlock();
+}
+/* *********************************************************************************************************************** */
+
 
-    Vector *inComp = portGraspThreadInSkinComp.read(false);
-    if (inComp) {
-        // Convert yarp vector to stl vector
-        vector<double> contacts(12*nFingers);
-        for (size_t i = 0; i < contacts.size(); ++i) {
-            contacts[i] = (*inComp)[i];
+/* *********************************************************************************************************************** */
+/* ******* Process the compensated skin data.                               ********************************************** */
+void GraspThread::processSkin(const yarp::sig::Vector &i_skin) {
+    // Abort if the processing touches the heap (only when built with TACTILEGRASP_CHECK_ALLOCATIONS)
+    AllocationGuard allocGuard(dbgTag.c_str());
+
+    const yarp::sig::Vector *skinComp = &i_skin;
+    if (compensator.isEnabled()) {
+        if (recorder.isOpen()) {
+            recorder.write(StreamFrameType::SkinRaw, i_skin.data(), i_skin.size(), yarp::os::Time::now(), skinStamp);
         }
+        if (!compensator.compensate(i_skin, compensatedSkin)) {
+            // Calibrating again after a change of the skin size: keep the previous contacts
+            return;
+        }
+        skinComp = &compensatedSkin;
+    }
+
+    if (recorder.isOpen()) {
+        recorder.write(StreamFrameType::SkinComp, skinComp->data(), skinComp->size(), yarp::os::Time::now(), skinStamp);
+    }
 
-        // Find maximum for each finger
-        vector<double> maxContacts(nFingers);
-        vector<double>::iterator start;
-        vector<double>::iterator end;
-        for (int i = 0; i < nFingers; ++i) {
-            start = contacts.begin() + 12*i;
-            end = start + 11;
-            maxContacts[i] = *std::max_element(start, end);
+    if (sparseDetection) {
+        // Fall back to the dense detection while the contact list is stale
+        bool late = ((yarp::os::Time::now() - lastContactsTime) > contactsTimeout);
+        if (late != contactsLate) {
+            contactsLate = late;
+            if (contactsLate) {
+                AsyncLog::log(LogLevel::Warning, dbgTag, "No skin contact list received for %g s. Using the dense contact detection. ", contactsTimeout);
+            } else {
+                AsyncLog::log(LogLevel::Info, dbgTag, "Skin contact list is back. Using the sparse contact detection. ");
+            }
+        }
+        if (!contactsLate) {
+            controller.detectContactSparse(*skinComp, activeTaxels);
+            ++sparseFrames;
         }
+    }
+    if (!sparseDetection || contactsLate) {
+        controller.detectContact(*skinComp);
+        ++denseFrames;
+    }
 
-#ifndef NODEBUG
-        cout << "DEBUG: " << dbgTag << "Maximum contact detected: \t\t";
-        for (size_t i = 0; i < maxContacts.size(); ++i) {
-            cout << maxContacts[i] << " ";
+    // The forecasts follow the skin clock
+    controller.predictContacts(skinStamp.isValid() ? skinStamp.getTime() : yarp::os::Time::now());
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Read the skin contact list.                                      ********************************************** */
+void GraspThread::readContacts(void) {
+    using yarp::os::Time;
+
+    if (!sparseDetection) {
+        return;
+    }
+    iCub::skinDynLib::skinContactList *inContacts = portGraspThreadInSkinContacts.read(false);
+    if (!inContacts) {
+        return;
+    }
+
+    controlMutex.lock();
+    lastContactsTime = Time::now();
+    if (recorder.isOpen()) {
+        yarp::os::Stamp stamp;
+        portGraspThreadInSkinContacts.getEnvelope(stamp);
+        recorder.writeContacts(*inContacts, lastContactsTime, stamp);
+    }
+
+    // Active taxels of this hand
+    activeTaxels.clear();
+    for (size_t i = 0; i < inContacts->size(); ++i) {
+        const iCub::skinDynLib::skinContact &contact = (*inContacts)[i];
+        if (contact.getSkinPart() == handSkinPart) {
+            std::vector<unsigned int> taxels = contact.getTaxelList();
+            activeTaxels.insert(activeTaxels.end(), taxels.begin(), taxels.end());
         }
-        cout << "\n";
-#endif
+    }
+    controlMutex.unlock();
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Record the other streams.                                        ********************************************** */
+void GraspThread::recordStreams(void) {
+    using yarp::os::Time;
+    using yarp::os::Stamp;
+
+    if (!recorder.isOpen()) {
+        return;
+    }
+
+    Stamp stamp;
+    // The raw skin compensated in the module is recorded by processSkin()
+    yarp::sig::Vector *inRaw = (compensator.isEnabled() ? NULL : portGraspThreadInSkinRaw.read(false));
+    if (inRaw) {
+        portGraspThreadInSkinRaw.getEnvelope(stamp);
+        recorder.write(StreamFrameType::SkinRaw, inRaw->data(), inRaw->size(), Time::now(), stamp);
+    }
+    // The contact list of the sparse detection is recorded by readContacts()
+    iCub::skinDynLib::skinContactList *inContacts = (sparseDetection ? NULL : portGraspThreadInSkinContacts.read(false));
+    if (inContacts) {
+        portGraspThreadInSkinContacts.getEnvelope(stamp);
+        recorder.writeContacts(*inContacts, Time::now(), stamp);
+    }
+    if (iEncs->getEncoders(&recordedEncoders[0])) {
+        recorder.write(StreamFrameType::Encoders, &recordedEncoders[0], recordedEncoders.size(), Time::now(), Stamp());
+    }
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Send the grasp velocities                                        ********************************************** */
+void GraspThread::sendVelocities(void) {
+    double now = yarp::os::Time::now();
+    const std::vector<double> *graspVelocities;
+    {
+        // Abort if the control touches the heap (only when built with TACTILEGRASP_CHECK_ALLOCATIONS)
+        AllocationGuard allocGuard(dbgTag.c_str());
+        graspVelocities = &controller.computeVelocities(now);
+    }
+
+    // Send move command. The remote drivers allocate the message, so this is not checked.
+    iVel->velocityMove(graspVelocities->data());
 
-        // Check if contact is greater than threshold
-        o_contacts.resize(nFingers, false);
-        for (size_t i = 0; i < maxContacts.size(); ++i) {
-            o_contacts[i] = (maxContacts[i] >= touchThresholds[i]);
+    AllocationGuard allocGuard(dbgTag.c_str());
+
+    // Record the latency from the skin data to the stop command
+    for (int i = 0; i < controller.getFingerCount(); ++i) {
+        if (controller.takeContactOnset(i) && skinStamp.isValid()) {
+            stopLatencies[i].record(now - skinStamp.getTime());
+            controller.recordStopLatency(now - skinStamp.getTime());
+        }
+        if (controller.takeSlipOnset(i) && skinStamp.isValid()) {
+            slipLatencies[i].record(now - skinStamp.getTime());
         }
+    }
 
-        // Store previous contacts
-        previousContacts = o_contacts;
-    } else {
-#ifndef NODEBUG
-        cout << "DEBUG: " << dbgTag << "No skin data. \n";
-        cout << "DEBUG: " << dbgTag << "Using previous skin value. \n";
-#endif
-        o_contacts = previousContacts;
+    if (recorder.isOpen()) {
+        recorder.write(StreamFrameType::Command, graspVelocities->data(), graspVelocities->size(), now, skinStamp);
     }
 
-    return true;
+    commandTime = now;
+    telemetryPending = true;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Publish the telemetry                                            ********************************************** */
+void GraspThread::publishTelemetry(void) {
+    if (!telemetryPending) {
+        return;
+    }
+    telemetryPending = false;
+    telemetryStamp.update(commandTime);
+    if (portGraspThreadOutTelemetry.getOutputCount() == 0) {
+        return;
+    }
+
+    int nFingers = controller.getFingerCount();
+    const std::vector<double> &velocities = controller.getVelocities();
+    int nJoints = static_cast<int>(velocities.size());
+
+    // The size is the same at every tick, so the buffers of the port are only allocated once
+    yarp::sig::Vector &frame = portGraspThreadOutTelemetry.prepare();
+    frame.resize(TelemetryField::Data + 2*nFingers + nJoints);
+    frame[TelemetryField::Version] = TelemetryField::LayoutVersion;
+    frame[TelemetryField::Sequence] = telemetryStamp.getCount();
+    frame[TelemetryField::TickTime] = commandTime;
+    frame[TelemetryField::SkinTime] = (skinStamp.isValid() ? skinStamp.getTime() : -1.0);
+    frame[TelemetryField::Fingers] = nFingers;
+    frame[TelemetryField::Joints] = nJoints;
+    double *data = frame.data() + TelemetryField::Data;
+    for (int i = 0; i < nFingers; ++i) {
+        const FingerState &finger = controller.getFinger(i);
+        data[i] = finger.maxTaxel;
+        data[nFingers + i] = (finger.contact ? 1.0 : 0.0);
+    }
+    for (int j = 0; j < nJoints; ++j) {
+        data[2*nFingers + j] = velocities[j];
+    }
+
+    portGraspThreadOutTelemetry.setEnvelope(telemetryStamp);
+    portGraspThreadOutTelemetry.write();
 }
 /* *********************************************************************************************************************** */
 
@@ -341,34 +719,62 @@ bool GraspThread::detectContact(std::deque<bool> &o_contacts) {
 /* *********************************************************************************************************************** */
 /* ******* Set touch threshold.                                             ********************************************** */
 bool GraspThread::setTouchThreshold(const int aFinger, const double aThreshold) {
-    if ((aFinger > 0) && (aFinger < nFingers)) {
-        touchThresholds[aFinger] = aThreshold;
-        return true;
-    } else {
+    GraspConfig *config = configs.edit();
+    bool ok = config->setTouchThreshold(aFinger, aThreshold);
+    if (!ok) {
         cerr << dbgTag << "RPC::setTouchThreshold() - The specified finger is out of range. \n";
-        return false;
     }
+    configs.publish(config, ok);
+
+    return ok;
 }
 /* *********************************************************************************************************************** */
 
 
 /* *********************************************************************************************************************** */
-/* ******* Open hand                                                        ********************************************** */
-bool GraspThread::openHand(void) {
-    cout << dbgTag << "Opening hand ... \t";
-    
-    iVel->stop();
+/* ******* Get the contact-to-command latencies.                            ********************************************** */
+bool GraspThread::getStopLatencies(yarp::os::Bottle &o_stats) {
+    using yarp::os::Bottle;
 
-    // Set the fingers to the original position
-    iPos->positionMove(11, 5);
-    iPos->positionMove(12, 0);
-    iPos->positionMove(13, 0);
-    iPos->positionMove(14, 0);
-    iPos->positionMove(15, 40);
+    o_stats.clear();
+    if (!stopLatencies) {
+        cerr << dbgTag << "The grasp thread is not initialised. \n";
+        return false;
+    }
 
-    // Check motion done
-    waitMoveDone(10, 1);
-    cout << "Done. \n";
+    for (int i = 0; i < controller.getFingerCount(); ++i) {
+        Bottle &finger = o_stats.addList();
+        Bottle &id = finger.addList();
+        id.addString("finger");
+        id.addInt(i);
+        Bottle &count = finger.addList();
+        count.addString("count");
+        count.addInt(stopLatencies[i].getCount());
+        Bottle &mean = finger.addList();
+        mean.addString("mean");
+        mean.addDouble(1000.0 * stopLatencies[i].getMean());
+        Bottle &p50 = finger.addList();
+        p50.addString("p50");
+        p50.addDouble(1000.0 * stopLatencies[i].getPercentile(50));
+        Bottle &p99 = finger.addList();
+        p99.addString("p99");
+        p99.addDouble(1000.0 * stopLatencies[i].getPercentile(99));
+        Bottle &max = finger.addList();
+        max.addString("max");
+        max.addDouble(1000.0 * stopLatencies[i].getMax());
+
+        // The contact decisions are read under the control lock
+        controlMutex.lock();
+        unsigned long nSwitches = controller.getFinger(i).switches;
+        int detectionDelay = controller.getDetectionDelay();
+        controlMutex.unlock();
+        Bottle &switches = finger.addList();
+        switches.addString("switches");
+        switches.addInt(static_cast<int>(nSwitches));
+        Bottle &delay = finger.addList();
+        delay.addString("filterDelay");
+        delay.addInt(detectionDelay);
+    }
 
     return true;
 }
@@ -376,35 +782,77 @@ bool GraspThread::openHand(void) {
 
 
 /* *********************************************************************************************************************** */
-/* ******* Place arm in grasping position                                   ********************************************** */ 
-bool GraspThread::reachArm(void) {
-    cout << dbgTag << "Reaching for grasp ... \t";
-    
-    iVel->stop();
+/* ******* Reset the contact-to-command latencies.                          ********************************************** */
+void GraspThread::resetStopLatencies(void) {
+    if (stopLatencies) {
+        for (int i = 0; i < controller.getFingerCount(); ++i) {
+            stopLatencies[i].reset();
+        }
+    }
+
+    controlMutex.lock();
+    controller.resetContactSwitches();
+    controlMutex.unlock();
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Get the slip statistics.                                         ********************************************** */
+bool GraspThread::getSlipStats(yarp::os::Bottle &o_stats) {
+    using yarp::os::Bottle;
+
+    o_stats.clear();
+    if (!slipLatencies) {
+        cerr << dbgTag << "The grasp thread is not initialised. \n";
+        return false;
+    }
+
+    // The slip detector is read under the control lock
+    controlMutex.lock();
+    const SlipDetector &slip = controller.getSlipDetector();
+    std::vector<unsigned long> nSlips(controller.getFingerCount());
+    for (int i = 0; i < controller.getFingerCount(); ++i) {
+        nSlips[i] = slip.getSlipCount(i);
+    }
+    double meanCost = slip.getMeanCost();
+    double maxCost = slip.getMaxCost();
+    unsigned long nCosts = slip.getCostCount();
+    controlMutex.unlock();
+
+    for (int i = 0; i < controller.getFingerCount(); ++i) {
+        Bottle &finger = o_stats.addList();
+        Bottle &id = finger.addList();
+        id.addString("finger");
+        id.addInt(i);
+        Bottle &slips = finger.addList();
+        slips.addString("slips");
+        slips.addInt(static_cast<int>(nSlips[i]));
+        Bottle &count = finger.addList();
+        count.addString("count");
+        count.addInt(slipLatencies[i].getCount());
+        Bottle &mean = finger.addList();
+        mean.addString("mean");
+        mean.addDouble(1000.0 * slipLatencies[i].getMean());
+        Bottle &p99 = finger.addList();
+        p99.addString("p99");
+        p99.addDouble(1000.0 * slipLatencies[i].getPercentile(99));
+        Bottle &max = finger.addList();
+        max.addString("max");
+        max.addDouble(1000.0 * slipLatencies[i].getMax());
+    }
 
-    // Set the arm in the starting position
-    // Arm
-    iPos->positionMove(0 ,-25);
-    iPos->positionMove(1 , 35);
-    iPos->positionMove(2 , 18);
-    iPos->positionMove(3 , 65);
-    iPos->positionMove(4 ,-32);
-    iPos->positionMove(5 , 9);
-    iPos->positionMove(6 , -5);
-    iPos->positionMove(7 , 20);
-    // Hand
-    iPos->positionMove(8 , 90);
-    iPos->positionMove(9 , 30);
-    iPos->positionMove(10, 30);
-    iPos->positionMove(11, 5);
-    iPos->positionMove(12, 0);
-    iPos->positionMove(13, 0);
-    iPos->positionMove(14, 0);
-    iPos->positionMove(15, 40);
-
-    // Check motion done
-    waitMoveDone(10, 1);
-    cout << "Done. \n";
+    Bottle &detection = o_stats.addList();
+    detection.addString("detection");
+    Bottle &costMean = detection.addList();
+    costMean.addString("mean");
+    costMean.addDouble(1.0e6 * meanCost);
+    Bottle &costMax = detection.addList();
+    costMax.addString("max");
+    costMax.addDouble(1.0e6 * maxCost);
+    Bottle &samples = detection.addList();
+    samples.addString("samples");
+    samples.addInt(static_cast<int>(nCosts));
 
     return true;
 }
@@ -412,21 +860,46 @@ bool GraspThread::reachArm(void) {
 
 
 /* *********************************************************************************************************************** */
-/* ******* Set the given velocity                                           ********************************************** */
-bool GraspThread::setVelocities(const int &i_type, const std::vector<double> &i_vel) {
-    switch (i_type) {
-        case GraspType::Stop :
-            velocities.stop = i_vel;
-            break;
-        case GraspType::Grasp :
-            velocities.grasp = i_vel;
-            break;
-
-        default:
-            cerr << dbgTag << "Unknown velocity type specified. \n";
-            return false;
-            break;
+/* ******* Get the contact forecast statistics.                             ********************************************** */
+bool GraspThread::getPredictionStats(yarp::os::Bottle &o_stats) {
+    using yarp::os::Bottle;
+
+    o_stats.clear();
+
+    // The predictor is read under the control lock
+    controlMutex.lock();
+    const ContactPredictor &predictor = controller.getPredictor();
+    for (int i = 0; i < controller.getFingerCount(); ++i) {
+        Bottle &finger = o_stats.addList();
+        Bottle &id = finger.addList();
+        id.addString("finger");
+        id.addInt(i);
+        Bottle &predictions = finger.addList();
+        predictions.addString("predictions");
+        predictions.addInt(static_cast<int>(predictor.getPredictions(i)));
+        Bottle &confirmed = finger.addList();
+        confirmed.addString("confirmed");
+        confirmed.addInt(static_cast<int>(predictor.getConfirmed(i)));
+        Bottle &expired = finger.addList();
+        expired.addString("expired");
+        expired.addInt(static_cast<int>(predictor.getExpired(i)));
+        Bottle &mean = finger.addList();
+        mean.addString("meanError");
+        mean.addDouble(1000.0 * predictor.getMeanError(i));
+        Bottle &meanAbs = finger.addList();
+        meanAbs.addString("meanAbsError");
+        meanAbs.addDouble(1000.0 * predictor.getMeanAbsError(i));
+        Bottle &maxAbs = finger.addList();
+        maxAbs.addString("maxAbsError");
+        maxAbs.addDouble(1000.0 * predictor.getMaxAbsError(i));
     }
+    Bottle &budget = o_stats.addList();
+    budget.addString("budget");
+    budget.addDouble(1000.0 * predictor.getBudget());
+    Bottle &latency = o_stats.addList();
+    latency.addString("latency");
+    latency.addDouble(1000.0 * predictor.getPipelineLatency());
+    controlMutex.unlock();
 
     return true;
 }
@@ -434,86 +907,420 @@ bool GraspThread::setVelocities(const int &i_type, const std::vector<double> &i_
 
 
 /* *********************************************************************************************************************** */
-/* ******* Set the velocity for the given joint.                            ********************************************** */
-bool GraspThread::setVelocity(const int &i_type, const int &i_joint, const double &i_vel) {
-    if ((i_joint > 0) && (i_joint < nJointsVel)) {
-        switch (i_type) {
-            case GraspType::Stop :
-                velocities.stop[i_joint - 8] = i_vel;
-                break;
-            case GraspType::Grasp :
-                velocities.grasp[i_joint - 8] = i_vel;
-                break;
-
-            default:
-                cerr << dbgTag << "Unknown velocity type specified. \n";
-                return false;
-                break;
+/* ******* Reset the contact forecast statistics.                           ********************************************** */
+void GraspThread::resetPredictionStats(void) {
+    controlMutex.lock();
+    controller.resetPredictionStats();
+    controlMutex.unlock();
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Reset the slip statistics.                                       ********************************************** */
+void GraspThread::resetSlipStats(void) {
+    if (slipLatencies) {
+        for (int i = 0; i < controller.getFingerCount(); ++i) {
+            slipLatencies[i].reset();
         }
+    }
+
+    controlMutex.lock();
+    controller.resetSlipStats();
+    controlMutex.unlock();
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Get the control tick timing statistics.                          ********************************************** */
+void GraspThread::getLoopStats(yarp::os::Bottle &o_stats) {
+    using yarp::os::Bottle;
+
+    loopMonitor.getStats(*this, o_stats);
+
+    Bottle &sparse = o_stats.addList();
+    sparse.addString("sparse");
+    sparse.addInt(static_cast<int>(sparseFrames.load()));
+    Bottle &dense = o_stats.addList();
+    dense.addString("dense");
+    dense.addInt(static_cast<int>(denseFrames.load()));
+    Bottle &phase = o_stats.addList();
+    phase.addString("phase");
+    phase.addString(RateScheduler::getPhaseName(rateScheduler.getPhase()));
+    Bottle &rateChanges = o_stats.addList();
+    rateChanges.addString("rateChanges");
+    rateChanges.addInt(static_cast<int>(rateScheduler.getChanges()));
+    if (eventDriven) {
+        callbackScheduling.getStats(o_stats);
     } else {
-        cerr << dbgTag << "Invalid joint specified. \n";
-        return false;
+        scheduling.getStats(o_stats);
     }
+}
+/* *********************************************************************************************************************** */
 
-    return true;
+
+/* *********************************************************************************************************************** */
+/* ******* Reset the control tick timing statistics.                        ********************************************** */
+void GraspThread::resetLoopStats(void) {
+    loopMonitor.reset(*this);
+    sparseFrames = 0;
+    denseFrames = 0;
+    rateScheduler.resetStats();
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Suspend the control.                                             ********************************************** */
+void GraspThread::suspend(void) {
+    controlMutex.lock();
+    if (rateScheduler.isEnabled() && rateScheduler.setPhase(GraspPhase::Idle)) {
+        applyRate();
+    }
+    // Without the skin callback, the periodic tick is the only reader of the raw skin
+    trackingDrift = (compensator.isEnabled() && !eventDriven);
+    controlMutex.unlock();
+
+    if (!trackingDrift) {
+        RateThread::suspend();
+    }
 }
 /* *********************************************************************************************************************** */
 
 
 /* *********************************************************************************************************************** */
-/* ******* Generate the mapping of each finger into the controllable joints it contains.  ******************************** */
-bool GraspThread::generateJointMap(std::vector<double> &i_thresholds) {
-    // FG:  This is probably one of the dirtiest pieces of code I have ever concocted. I found no clean why to map finger IDs
-    //      (0,1,2,3,4) into their respective joints in the robotic kinematic chain. I chose this one.
-    //
+/* ******* Resume the control.                                              ********************************************** */
+void GraspThread::resume(void) {
+    controlMutex.lock();
+    if (rateScheduler.isEnabled() && rateScheduler.setPhase(GraspPhase::Approach)) {
+        applyRate();
+    }
+    trackingDrift = false;
+    controlMutex.unlock();
+
+    RateThread::resume();
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Apply the control period of the grasp phase.                     ********************************************** */
+void GraspThread::applyRate(void) {
+    int phasePeriod = rateScheduler.getPeriod();
+    setRate(phasePeriod);
+    loopMonitor.setPeriod(phasePeriod/1000.0);
+
+    AsyncLog::log(LogLevel::Info, dbgTag, "Entering the %s phase. Control period set to %d ms. ", RateScheduler::getPhaseName(rateScheduler.getPhase()), phasePeriod);
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Set the phase of the control ticks.                              ********************************************** */
+void GraspThread::setTickPhase(const double &i_origin, const double &i_offset) {
+    tickOrigin = i_origin;
+    tickOffset = i_offset;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Get the arm driver.                                              ********************************************** */
+yarp::dev::PolyDriver &GraspThread::getArmDriver(void) {
+    return clientArm;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Open hand                                                        ********************************************** */
+int GraspThread::openHand(void) {
+    cout << dbgTag << "Opening hand. \n";
+
+    return moveToPose("open");
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Move to a named pose                                             ********************************************** */ 
+int GraspThread::moveToPose(const std::string &i_name) {
+    using yarp::os::Time;
     using std::vector;
 
-    // Initialise map
-    jointMap.resize(i_thresholds.size());
-
-    // Loop thresholds
-    for (size_t i = 0; i < i_thresholds.size(); ++i) {
-        vector<int> tmp;
-        if (i_thresholds[i] >= 0) {
-            // Create joint list
-            if (i == 0) {
-                tmp.push_back(11);
-                tmp.push_back(12);
-            } else if (i == 1) {
-                tmp.push_back(13);
-                tmp.push_back(14);
-            } else if (i == 2) {
-                tmp.push_back(15);
-            } else if (i == 3) {
-                tmp.push_back(15);
-            } else if (i == 4) {
-                tmp.push_back(8);
-                tmp.push_back(9);
-                tmp.push_back(10);
-            } 
+    if (!motionMonitor) {
+        cerr << dbgTag << "The grasp thread is not initialised. \n";
+        return -1;
+    }
+
+    int p = poses.find(i_name);
+    if (p < 0) {
+        cerr << dbgTag << "Unknown pose " << i_name << ". \n";
+        return -1;
+    }
+    const Pose &pose = poses.getPose(p);
+    int nJoints = static_cast<int>(pose.joints.size());
+
+    // Make sure no skin callback overrides the stop
+    controlMutex.lock();
+    iVel->stop();
+    controller.resetGrasp();
+    controlMutex.unlock();
+
+    double start = Time::now();
+    int calls = 0;
+
+    // Speeds making all the joints arrive together
+    vector<double> encoders(startPos.size(), 0.0);
+    vector<double> speeds(nJoints, 0.0);
+    if (iEncs->getEncoders(&encoders[0])) {
+        poses.computeSpeeds(p, &encoders[0], speeds);
+    } else {
+        speeds.assign(nJoints, pose.speed);
+    }
+    ++calls;
+
+    if (iPos2) {
+        // One command for all the joints, which then start moving together
+        iPos2->setRefSpeeds(nJoints, &pose.joints[0], &speeds[0]);
+        iPos2->positionMove(nJoints, &pose.joints[0], &pose.positions[0]);
+        calls += 2;
+    } else {
+        for (int j = 0; j < nJoints; ++j) {
+            iPos->setRefSpeed(pose.joints[j], speeds[j]);
+            iPos->positionMove(pose.joints[j], pose.positions[j]);
         }
-        // Add joint list to map
-        jointMap[i] = tmp;
+        calls += 2*nJoints;
     }
 
-    return true;
+    poses.recordDispatch(p, calls, Time::now() - start, (iPos2 != NULL));
+
+#ifndef NODEBUG
+    cout << "DEBUG: " << dbgTag << "Pose " << i_name << " sent with " << calls << " calls in " << 1000.0*(Time::now() - start) << " ms. \n";
+#endif
+
+    // Track the completion
+    int id = motionMonitor->track(pose.joints, motionTimeout, p);
+
+    // Any other arm motion takes the arm away from the grasping position
+    if (i_name == "reach") {
+        reachMotion = id;
+        armReached = false;
+    } else if (*std::min_element(pose.joints.begin(), pose.joints.end()) < controller.getHand().getJointOffset()) {
+        reachMotion = -1;
+        armReached = false;
+    }
+
+    return id;
 }
 /* *********************************************************************************************************************** */
 
 
 /* *********************************************************************************************************************** */
-/* ******* Wait for motion to be completed.                                 ********************************************** */
-bool GraspThread::waitMoveDone(const double &i_timeout, const double &i_delay) {
+/* ******* Reach before grasping                                            ********************************************** */
+bool GraspThread::prepareGrasp(const bool &i_wait) {
+    if (armReached) {
+        return true;
+    }
+
+    int id = reachMotion;
+    MotionStatus status = getMotionStatus(id);
+    if ((status != MotionStatus::Running) && (status != MotionStatus::Done)) {
+        if (!reachOnGrasp) {
+            return true;
+        }
+        cout << dbgTag << "Reaching for grasp. \n";
+        id = moveToPose("reach");
+    }
+    if (!i_wait) {
+        return (id >= 0);
+    }
+
+    armReached = waitMotion(id, motionTimeout);
+    if (!armReached) {
+        cerr << dbgTag << "The arm did not reach the grasping position within " << motionTimeout << " s. \n";
+    }
+
+    return armReached;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Get the pose statistics                                          ********************************************** */
+void GraspThread::getPoseStats(yarp::os::Bottle &o_stats) {
+    poses.getStats(o_stats);
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Reset the pose statistics                                        ********************************************** */
+void GraspThread::resetPoseStats(void) {
+    poses.resetStats();
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Get the status of a motion                                       ********************************************** */
+MotionStatus GraspThread::getMotionStatus(const int &i_id) {
+    if (!motionMonitor) {
+        return MotionStatus(MotionStatus::Unknown);
+    }
+
+    return motionMonitor->getStatus(i_id);
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Wait for a motion                                                ********************************************** */
+bool GraspThread::waitMotion(const int &i_id, const double &i_timeout) {
+    if (!motionMonitor) {
+        return false;
+    }
+
+    return motionMonitor->wait(i_id, i_timeout);
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Set the given velocity                                           ********************************************** */
+bool GraspThread::setVelocities(const int &i_type, const std::vector<double> &i_vel) {
+    GraspConfig *config = configs.edit();
+    bool ok = config->setVelocities(i_type, i_vel);
+    configs.publish(config, ok);
+
+    return ok;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Select the grasp mode                                            ********************************************** */
+bool GraspThread::setGraspMode(const int &i_type) {
+    GraspConfig *config = configs.edit();
+    bool ok = config->setMode(i_type);
+    configs.publish(config, ok);
+
+    return ok;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Set the velocity for the given joint.                            ********************************************** */
+bool GraspThread::setVelocity(const int &i_type, const int &i_joint, const double &i_vel) {
+    GraspConfig *config = configs.edit();
+    bool ok = config->setVelocity(i_type, i_joint, i_vel);
+    configs.publish(config, ok);
+
+    return ok;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Set the grasp velocities and mode at once.                       ********************************************** */
+bool GraspThread::configureGrasp(const std::vector<double> &i_grasp, const std::vector<double> &i_stop, const int &i_type) {
+    GraspConfig *config = configs.edit();
+    bool ok = config->setVelocities(GraspType::Grasp, i_grasp)
+        && config->setVelocities(GraspType::Stop, i_stop)
+        && config->setMode(i_type);
+    configs.publish(config, ok);
+
+    return ok;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Pick up the latest settings.                                     ********************************************** */
+void GraspThread::applySettings(void) {
+    // Abort if copying the settings touches the heap (only when built with TACTILEGRASP_CHECK_ALLOCATIONS)
+    AllocationGuard allocGuard(dbgTag.c_str());
+
+    controller.applyConfig(*configs.acquire());
+    configs.release();
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Calibrate the skin baselines.                                    ********************************************** */
+bool GraspThread::calibrateSkin(const double &i_timeout) {
     using yarp::os::Time;
-    
-    bool ok = false;
-    
+
+    cout << dbgTag << "Calibrating the skin baselines. Do not touch the hand. \n";
+    compensator.reset();
     double start = Time::now();
-    while (!ok && (start - Time::now() <= i_timeout)) {
-        iPos->checkMotionDone(&ok);
-        Time::delay(i_delay);
+    while (!compensator.isCalibrated()) {
+        if (Time::now() - start > i_timeout) {
+            cerr << dbgTag << "The raw skin calibration did not complete within " << i_timeout << " s. \n";
+            return false;
+        }
+        yarp::sig::Vector *inRaw = portGraspThreadInSkinRaw.read(false);
+        if (inRaw) {
+            compensator.compensate(*inRaw, compensatedSkin);
+        } else {
+            Time::delay(0.005);
+        }
     }
 
-    return ok;
+    return true;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Build the options of the simulated arm.                          ********************************************** */
+bool GraspThread::configureSimulation(yarp::os::Property &o_options, const std::string &i_skinPort, const std::string &i_rawSkinPort) {
+    using yarp::os::Bottle;
+
+    cout << dbgTag << "Using the simulated arm. \n";
+
+    // Virtual object parameters
+    Bottle &confSim = rf.findGroup("simulation");
+    for (int i = 1; i < confSim.size(); ++i) {
+        Bottle *param = confSim.get(i).asList();
+        if (param && (param->size() == 2)) {
+            o_options.put(param->get(0).asString().c_str(), param->get(1));
+        }
+    }
+
+    // The simulated skin must match the configuration of the grasp thread
+    int nFingers = controller.getFingerCount();
+    Bottle lists;
+    Bottle &thresholds = lists.addList();
+    for (int i = 0; i < nFingers; ++i) {
+        thresholds.addDouble(controller.getPatch(i).threshold);
+    }
+    Bottle &tips = lists.addList();
+    for (int i = 0; i < nFingers; ++i) {
+        Bottle &tip = tips.addList();
+        tip.addInt(controller.getPatch(i).offset);
+        tip.addInt(controller.getPatch(i).count);
+    }
+    Bottle &joints = lists.addList();
+    for (int i = 0; i < nFingers; ++i) {
+        Bottle &finger = joints.addList();
+        for (int j = controller.getJointBegin(i); j < controller.getJointEnd(i); ++j) {
+            finger.addInt(controller.getFingerJoint(j));
+        }
+    }
+
+    o_options.put("device", "fakeHandBoard");
+    o_options.put("skinPort", i_skinPort.c_str());
+    if (!i_rawSkinPort.empty()) {
+        o_options.put("rawSkinPort", i_rawSkinPort.c_str());
+    }
+    o_options.put("touchThresholds", lists.get(0));
+    o_options.put("fingertips", lists.get(1));
+    o_options.put("fingerJoints", lists.get(2));
+
+    return true;
 }
 /* *********************************************************************************************************************** */
@@ -0,0 +1,198 @@
+/* 
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org 
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+
+#include "iCub/tactileGrasp/HandModel.h"
+
+#include <iostream>
+#include <algorithm>
+
+#include <yarp/os/Bottle.h>
+
+using std::cerr;
+using std::cout;
+using std::string;
+
+using iCub::tactileGrasp::HandModel;
+
+using yarp::os::Bottle;
+using yarp::os::Value;
+
+
+namespace {
+    /**
+     * Built-in hand table.
+     */
+    struct HandTable {
+        const char *name;
+        int nFingers;
+        /** Row offsets of each finger in joints, plus the end of the table. */
+        const int *offsets;
+        const int *joints;
+        int jointOffset;
+        int taxelsPerFinger;
+        /** The (x y) position of each taxel of a fingertip (mm), or NULL. */
+        const double *taxelPositions;
+    };
+
+    // iCub hand: index (11 12), middle (13 14), ring (15), little (15) and thumb (8 9 10). Finger joints start at 8.
+    const int icubOffsets[] = {0, 2, 4, 5, 6, 9};
+    const int icubJoints[] = {11, 12, 13, 14, 15, 15, 8, 9, 10};
+    // iCub fingertip: approximate taxel centres on the unrolled pad, scaled from the skinGui fingertip layout. The taxels
+    // 0 to 6 run across the tip, 7 to 11 along the pad.
+    const double icubTaxelPositions[] = {
+         8.2,  2.0,    3.0,  2.0,    3.0,  7.0,    0.0,  7.0,   -3.0,  7.0,   -3.0,  2.0,
+        -8.2,  2.0,   -6.0, -2.2,   -2.8, -6.2,    0.0, -2.0,    2.8, -6.2,    6.0, -2.2
+    };
+
+    // Add the tables of other hand revisions here
+    const HandTable handTables[] = {
+        {"icub", 5, icubOffsets, icubJoints, 8, 12, icubTaxelPositions}
+    };
+    const int nHandTables = sizeof(handTables) / sizeof(handTables[0]);
+}
+
+
+/* *********************************************************************************************************************** */
+/* ******* Constructor                                                      ********************************************** */   
+HandModel::HandModel() {
+    jointOffset = 0;
+    taxelsPerFinger = 0;
+    offsets.assign(1, 0);
+
+    dbgTag = "HandModel: ";
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Load a built-in table                                            ********************************************** */   
+bool HandModel::loadBuiltIn(const std::string &i_name) {
+    for (int t = 0; t < nHandTables; ++t) {
+        const HandTable &table = handTables[t];
+        if (i_name == table.name) {
+            name = table.name;
+            jointOffset = table.jointOffset;
+            taxelsPerFinger = table.taxelsPerFinger;
+            offsets.assign(table.offsets, table.offsets + table.nFingers + 1);
+            joints.assign(table.joints, table.joints + table.offsets[table.nFingers]);
+            if (table.taxelPositions) {
+                taxelPositions.assign(table.taxelPositions, table.taxelPositions + 2*table.taxelsPerFinger);
+            } else {
+                taxelPositions.clear();
+            }
+
+            return true;
+        }
+    }
+
+    cerr << dbgTag << "Unknown hand model " << i_name << ". Available models are:";
+    for (int t = 0; t < nHandTables; ++t) {
+        cerr << " " << handTables[t].name;
+    }
+    cerr << ". \n";
+
+    return false;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Load the hand model                                              ********************************************** */   
+bool HandModel::configure(yarp::os::Searchable &rf) {
+    Bottle &confGrasp = rf.findGroup("graspTh");
+    Bottle &confVelocity = rf.findGroup("velocity");
+
+    if (!loadBuiltIn(confGrasp.check("handModel", Value("icub")).asString().c_str())) {
+        return false;
+    }
+
+    // Finger to joint map
+    Bottle *confJoints = confGrasp.find("fingerJoints").asList();
+    if (confJoints) {
+        offsets.assign(1, 0);
+        joints.clear();
+        for (int i = 0; i < confJoints->size(); ++i) {
+            Bottle *finger = confJoints->get(i).asList();
+            if (!finger) {
+                cerr << dbgTag << "Invalid [graspTh] fingerJoints entry " << i << ". Expected a list of joints. \n";
+                return false;
+            }
+            for (int j = 0; j < finger->size(); ++j) {
+                joints.push_back(finger->get(j).asInt());
+            }
+            offsets.push_back(joints.size());
+        }
+    }
+
+    jointOffset = confVelocity.check("jointOffset", Value(jointOffset)).asInt();
+    taxelsPerFinger = confGrasp.check("taxelsPerFinger", Value(taxelsPerFinger)).asInt();
+
+    for (size_t j = 0; j < joints.size(); ++j) {
+        if (joints[j] < jointOffset) {
+            cerr << dbgTag << "Finger joint " << joints[j] << " is below the velocity joint offset " << jointOffset << ". \n";
+            return false;
+        }
+    }
+    if (taxelsPerFinger <= 0) {
+        cerr << dbgTag << "The number of taxels per finger must be positive. \n";
+        return false;
+    }
+
+    // Fingertip taxel positions
+    Bottle *confPositions = confGrasp.find("taxelPositions").asList();
+    if (confPositions) {
+        taxelPositions.clear();
+        for (int t = 0; t < confPositions->size(); ++t) {
+            Bottle *position = confPositions->get(t).asList();
+            if (!position || (position->size() != 2)) {
+                cerr << dbgTag << "Invalid [graspTh] taxelPositions entry " << t << ". Expected (x y). \n";
+                return false;
+            }
+            taxelPositions.push_back(position->get(0).asDouble());
+            taxelPositions.push_back(position->get(1).asDouble());
+        }
+    }
+    if (taxelPositions.size() < 2*static_cast<size_t>(taxelsPerFinger)) {
+        cout << dbgTag << "No position for some of the " << taxelsPerFinger << " taxels of a fingertip. They are laid on a line, 1 mm apart. \n";
+        for (int t = static_cast<int>(taxelPositions.size()/2); t < taxelsPerFinger; ++t) {
+            taxelPositions.push_back(t);
+            taxelPositions.push_back(0.0);
+        }
+    }
+
+    cout << dbgTag << "Using the " << name << (confJoints ? " hand model with the configured finger joints" : " hand model") 
+        << ": " << getFingerCount() << " fingers, " << joints.size() << " finger joints from joint " << jointOffset << ". \n";
+
+    return true;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Size of the velocity vectors                                     ********************************************** */   
+int HandModel::getVelocityCount(void) const {
+    int count = 0;
+    for (size_t j = 0; j < joints.size(); ++j) {
+        count = std::max(count, joints[j] - jointOffset + 1);
+    }
+
+    return count;
+}
+/* *********************************************************************************************************************** */
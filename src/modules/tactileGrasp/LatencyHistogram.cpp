@@ -0,0 +1,125 @@
+/* 
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org 
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+
+#include "iCub/tactileGrasp/LatencyHistogram.h"
+
+#include <cmath>
+
+using iCub::tactileGrasp::LatencyHistogram;
+
+
+namespace {
+    /** Upper edge of the first bin (seconds). */
+    const double minLatency = 1e-6;
+    /** Ratio between the edges of two consecutive bins. */
+    const double binRatio = 1.05;
+}
+
+
+/* *********************************************************************************************************************** */
+/* ******* Constructor                                                      ********************************************** */   
+LatencyHistogram::LatencyHistogram() {
+    reset();
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Record a latency                                                 ********************************************** */
+void LatencyHistogram::record(const double &i_latency) {
+    double latency = (i_latency > 0) ? i_latency : 0.0;
+
+    // Find bin
+    int bin = 0;
+    if (latency >= minLatency) {
+        bin = 1 + static_cast<int>(std::log(latency / minLatency) / std::log(binRatio));
+        if (bin >= NBins) {
+            bin = NBins - 1;
+        }
+    }
+    bins[bin].fetch_add(1, std::memory_order_relaxed);
+
+    // Update summary statistics
+    unsigned long long us = static_cast<unsigned long long>(latency * 1e6 + 0.5);
+    sumUs.fetch_add(us, std::memory_order_relaxed);
+    unsigned long long prevMax = maxUs.load(std::memory_order_relaxed);
+    while ((us > prevMax) && !maxUs.compare_exchange_weak(prevMax, us, std::memory_order_relaxed)) {}
+    count.fetch_add(1, std::memory_order_release);
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Reset the histogram                                              ********************************************** */
+void LatencyHistogram::reset(void) {
+    for (int i = 0; i < NBins; ++i) {
+        bins[i].store(0, std::memory_order_relaxed);
+    }
+    sumUs.store(0, std::memory_order_relaxed);
+    maxUs.store(0, std::memory_order_relaxed);
+    count.store(0, std::memory_order_release);
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Get statistics                                                   ********************************************** */
+unsigned long LatencyHistogram::getCount(void) const {
+    return count.load(std::memory_order_acquire);
+}
+
+double LatencyHistogram::getMean(void) const {
+    unsigned long n = getCount();
+    return (n > 0) ? (sumUs.load(std::memory_order_relaxed) * 1e-6 / n) : 0.0;
+}
+
+double LatencyHistogram::getMax(void) const {
+    return maxUs.load(std::memory_order_relaxed) * 1e-6;
+}
+
+double LatencyHistogram::getPercentile(const double &i_percentile) const {
+    // Take a snapshot of the bins as they keep being updated
+    unsigned long snapshot[NBins];
+    unsigned long total = 0;
+    for (int i = 0; i < NBins; ++i) {
+        snapshot[i] = bins[i].load(std::memory_order_relaxed);
+        total += snapshot[i];
+    }
+    if (total == 0) {
+        return 0.0;
+    }
+
+    // Find the bin containing the requested rank
+    double rank = std::ceil(i_percentile / 100.0 * total);
+    unsigned long cumulated = 0;
+    int bin = 0;
+    for (; bin < NBins - 1; ++bin) {
+        cumulated += snapshot[bin];
+        if (cumulated >= rank) {
+            break;
+        }
+    }
+
+    // The upper edge is clipped to the observed maximum
+    double upperEdge = minLatency * std::pow(binRatio, bin);
+    double max = getMax();
+    return (upperEdge < max) ? upperEdge : max;
+}
+/* *********************************************************************************************************************** */
@@ -0,0 +1,137 @@
+/* 
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org 
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+
+#include "iCub/tactileGrasp/LoopMonitor.h"
+
+#include <cmath>
+#include <algorithm>
+
+#include <yarp/os/Time.h>
+
+using iCub::tactileGrasp::LoopMonitor;
+
+using yarp::os::Bottle;
+using yarp::os::RateThread;
+
+
+namespace {
+    /** Add a (name value) pair to the given bottle. */
+    void addStat(Bottle &o_stats, const char *i_name, const double &i_value) {
+        Bottle &stat = o_stats.addList();
+        stat.addString(i_name);
+        stat.addDouble(i_value);
+    }
+
+    void addStat(Bottle &o_stats, const char *i_name, const unsigned long &i_value) {
+        Bottle &stat = o_stats.addList();
+        stat.addString(i_name);
+        stat.addInt(static_cast<int>(i_value));
+    }
+}
+
+
+/* *********************************************************************************************************************** */
+/* ******* Constructor                                                      ********************************************** */   
+LoopMonitor::LoopMonitor(const double &aPeriod) 
+    : period(aPeriod), lastPeriod(aPeriod), tickStart(0.0), lastTickStart(0.0), lastIteration(0),
+      overruns(0), missed(0), maxUsedUs(0), resetRequested(false) {}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Set the nominal period                                           ********************************************** */
+void LoopMonitor::setPeriod(const double &i_period) {
+    period = i_period;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Tick started                                                     ********************************************** */
+void LoopMonitor::tickStarted(const unsigned int &i_iteration) {
+    tickStart = yarp::os::Time::now();
+
+    if (resetRequested.exchange(false)) {
+        overruns.store(0, std::memory_order_relaxed);
+        missed.store(0, std::memory_order_relaxed);
+        maxUsedUs.store(0, std::memory_order_relaxed);
+        lastTickStart = 0.0;
+    }
+
+    // The rate thread loop keeps iterating while suspended, so only consecutive iterations are checked
+    double tickPeriod = std::max(period.load(std::memory_order_relaxed), lastPeriod);
+    if ((lastTickStart > 0.0) && (i_iteration == lastIteration + 1)) {
+        double interval = tickStart - lastTickStart;
+        if (interval > 1.5*tickPeriod) {
+            missed.fetch_add(static_cast<unsigned long>(std::floor(interval/tickPeriod + 0.5)) - 1, std::memory_order_relaxed);
+        }
+    }
+    lastPeriod = period.load(std::memory_order_relaxed);
+    lastTickStart = tickStart;
+    lastIteration = i_iteration;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Tick ended                                                       ********************************************** */
+void LoopMonitor::tickEnded(void) {
+    double used = yarp::os::Time::now() - tickStart;
+
+    if (used > period.load(std::memory_order_relaxed)) {
+        overruns.fetch_add(1, std::memory_order_relaxed);
+    }
+    unsigned long long usedUs = static_cast<unsigned long long>(used * 1e6);
+    if (usedUs > maxUsedUs.load(std::memory_order_relaxed)) {
+        maxUsedUs.store(usedUs, std::memory_order_relaxed);
+    }
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Reset the statistics                                             ********************************************** */
+void LoopMonitor::reset(RateThread &i_thread) {
+    i_thread.resetStat();
+    resetRequested.store(true);
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Get the statistics                                               ********************************************** */
+void LoopMonitor::getStats(RateThread &i_thread, Bottle &o_stats) {
+    // The rate thread estimates are in ms
+    double estPeriod, jitter, used, usedStd;
+    i_thread.getEstPeriod(estPeriod, jitter);
+    i_thread.getEstUsed(used, usedStd);
+
+    o_stats.clear();
+    addStat(o_stats, "period", i_thread.getRate());
+    addStat(o_stats, "estPeriod", estPeriod);
+    addStat(o_stats, "jitter", jitter);
+    addStat(o_stats, "used", used);
+    addStat(o_stats, "usedStd", usedStd);
+    addStat(o_stats, "maxUsed", maxUsedUs.load(std::memory_order_relaxed) / 1000.0);
+    addStat(o_stats, "iterations", static_cast<unsigned long>(i_thread.getIterations()));
+    addStat(o_stats, "overruns", overruns.load(std::memory_order_relaxed));
+    addStat(o_stats, "missed", missed.load(std::memory_order_relaxed));
+}
+/* *********************************************************************************************************************** */
@@ -0,0 +1,203 @@
+/* 
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org 
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+
+#include "iCub/tactileGrasp/MotionMonitor.h"
+
+#include <iostream>
+
+#include <yarp/os/Time.h>
+
+using std::cerr;
+using std::cout;
+
+using iCub::tactileGrasp::MotionMonitor;
+using iCub::tactileGrasp::MotionStatus;
+
+using yarp::os::Time;
+
+
+namespace {
+    /** Number of motions kept in the history. */
+    const int motionHistorySize = 32;
+}
+
+
+/* *********************************************************************************************************************** */
+/* ******* Constructor                                                      ********************************************** */   
+MotionMonitor::MotionMonitor(const int aPeriod, yarp::dev::IPositionControl *aPos, yarp::dev::IPositionControl2 *aPos2)
+    : RateThread(aPeriod) {
+        iPos = aPos;
+        iPos2 = aPos2;
+        listener = NULL;
+
+        motions.resize(motionHistorySize);
+        for (int i = 0; i < motionHistorySize; ++i) {
+            motions[i].id = -1;
+            motions[i].tag = -1;
+            motions[i].status = MotionStatus::Unknown;
+        }
+        nextId = 0;
+        checkIds.reserve(motionHistorySize);
+        checkOffsets.reserve(motionHistorySize + 1);
+
+        dbgTag = "MotionMonitor: ";
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Check the running motions                                        ********************************************** */   
+void MotionMonitor::run(void) {
+    // Copy the running motions out of the history
+    checkIds.clear();
+    checkJoints.clear();
+    checkOffsets.clear();
+    mutex.lock();
+    for (int i = 0; i < motionHistorySize; ++i) {
+        const Motion &motion = motions[i];
+        if (motion.status == MotionStatus::Running) {
+            checkIds.push_back(motion.id);
+            checkOffsets.push_back(static_cast<int>(checkJoints.size()));
+            checkJoints.insert(checkJoints.end(), motion.joints.begin(), motion.joints.end());
+        }
+    }
+    mutex.unlock();
+    checkOffsets.push_back(static_cast<int>(checkJoints.size()));
+
+    if (checkIds.empty()) {
+        return;
+    }
+
+    // Without the multi-joint interface, the motions are done when all the axes are
+    bool allDone = false;
+    if (!iPos2) {
+        iPos->checkMotionDone(&allDone);
+    }
+
+    for (size_t m = 0; m < checkIds.size(); ++m) {
+        bool done = allDone;
+        int nJoints = checkOffsets[m + 1] - checkOffsets[m];
+        if (iPos2 && (nJoints > 0)) {
+            iPos2->checkMotionDone(nJoints, &checkJoints[checkOffsets[m]], &done);
+        } else if (nJoints == 0) {
+            done = true;
+        }
+
+        // The motion may have been preempted while it was checked
+        double now = Time::now();
+        mutex.lock();
+        Motion &motion = motions[checkIds[m] % motionHistorySize];
+        if ((motion.id == checkIds[m]) && (motion.status == MotionStatus::Running)) {
+            if (done) {
+                motion.status = MotionStatus::Done;
+#ifndef NODEBUG
+                cout << "DEBUG: " << dbgTag << "Motion " << motion.id << " done in " << now - motion.startTime << " s. \n";
+#endif
+            } else if (now - motion.startTime > motion.timeout) {
+                motion.status = MotionStatus::TimedOut;
+                cerr << dbgTag << "Motion " << motion.id << " timed out after " << motion.timeout << " s. \n";
+            }
+
+            if (listener && (motion.status != MotionStatus::Running)) {
+                listener->onMotionEnded(motion.id, motion.tag, motion.status, now - motion.startTime);
+            }
+        }
+        mutex.unlock();
+    }
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Set the motion listener                                          ********************************************** */   
+void MotionMonitor::setListener(MotionListener *i_listener) {
+    listener = i_listener;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Track a new motion                                               ********************************************** */   
+int MotionMonitor::track(const std::vector<int> &i_joints, const double &i_timeout, const int &i_tag) {
+    mutex.lock();
+
+    // The new motion takes over the joints of the running ones
+    for (int i = 0; i < motionHistorySize; ++i) {
+        Motion &motion = motions[i];
+        if (motion.status == MotionStatus::Running) {
+            for (size_t j = 0; (j < motion.joints.size()) && (motion.status == MotionStatus::Running); ++j) {
+                for (size_t k = 0; k < i_joints.size(); ++k) {
+                    if (motion.joints[j] == i_joints[k]) {
+                        motion.status = MotionStatus::Preempted;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    int id = nextId++;
+    Motion &motion = motions[id % motionHistorySize];
+    motion.id = id;
+    motion.tag = i_tag;
+    motion.status = MotionStatus::Running;
+    motion.startTime = Time::now();
+    motion.timeout = i_timeout;
+    motion.joints = i_joints;
+
+    mutex.unlock();
+
+    return id;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Get the status of a motion                                       ********************************************** */   
+MotionStatus MotionMonitor::getStatus(const int &i_id) {
+    MotionStatus::Status status = MotionStatus::Unknown;
+
+    mutex.lock();
+    if (i_id >= 0) {
+        const Motion &motion = motions[i_id % motionHistorySize];
+        if (motion.id == i_id) {
+            status = motion.status;
+        }
+    }
+    mutex.unlock();
+
+    return MotionStatus(status);
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Wait for a motion                                                ********************************************** */   
+bool MotionMonitor::wait(const int &i_id, const double &i_timeout) {
+    double start = Time::now();
+    MotionStatus status = getStatus(i_id);
+    while ((status == MotionStatus::Running) && (Time::now() - start < i_timeout)) {
+        Time::delay(getRate() / 1000.0);
+        status = getStatus(i_id);
+    }
+
+    return (status == MotionStatus::Done);
+}
+/* *********************************************************************************************************************** */
@@ -0,0 +1,177 @@
+/* 
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org 
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+
+#include "iCub/tactileGrasp/ParallelStartup.h"
+
+#include <iostream>
+#include <iomanip>
+
+#include <yarp/os/Time.h>
+
+using std::cout;
+
+using iCub::tactileGrasp::StartupTimer;
+using iCub::tactileGrasp::DriverOpener;
+using iCub::tactileGrasp::ThreadStarter;
+
+using yarp::os::Time;
+
+
+/* *********************************************************************************************************************** */
+/* ******* Startup timer constructor                                        ********************************************** */   
+StartupTimer::StartupTimer() {
+    origin = Time::now();
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Reset the startup timer                                          ********************************************** */   
+void StartupTimer::reset(void) {
+    mutex.lock();
+    origin = Time::now();
+    phases.clear();
+    mutex.unlock();
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Record a startup phase                                           ********************************************** */   
+void StartupTimer::record(const std::string &i_name, const double &i_start) {
+    Phase phase;
+    phase.name = i_name;
+    phase.duration = Time::now() - i_start;
+
+    mutex.lock();
+    phase.start = i_start - origin;
+    phases.push_back(phase);
+    mutex.unlock();
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Log the startup phases                                           ********************************************** */   
+void StartupTimer::print(const std::string &i_tag) {
+    mutex.lock();
+    cout << i_tag << "Startup phases (start ms, duration ms): \n";
+    for (size_t i = 0; i < phases.size(); ++i) {
+        cout << i_tag << "\t" << std::left << std::setw(24) << phases[i].name << std::right << std::fixed << std::setprecision(1)
+            << std::setw(10) << 1000.0*phases[i].start << std::setw(10) << 1000.0*phases[i].duration << "\n";
+    }
+    cout << i_tag << "\t" << std::left << std::setw(24) << "total" << std::right 
+        << std::setw(20) << 1000.0*(Time::now() - origin) << "\n";
+    cout.unsetf(std::ios::floatfield);
+    cout << std::setprecision(6);
+    mutex.unlock();
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Driver opener constructor                                        ********************************************** */   
+DriverOpener::DriverOpener(yarp::dev::PolyDriver &aDriver, const yarp::os::Property &aOptions, const std::string &aPhase, StartupTimer *aTimer)
+    : Thread(), driver(aDriver), options(aOptions) {
+        phase = aPhase;
+        timer = aTimer;
+        async = false;
+        opened = false;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Open the driver                                                  ********************************************** */   
+void DriverOpener::run(void) {
+    double start = Time::now();
+    opened = driver.open(options);
+    timer->record(phase, start);
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Launch the driver opening                                        ********************************************** */   
+void DriverOpener::launch(const bool &i_async) {
+    async = i_async;
+    if (async) {
+        start();
+    } else {
+        run();
+    }
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Wait for the driver                                              ********************************************** */   
+bool DriverOpener::wait(void) {
+    if (async) {
+        join();
+    }
+
+    return opened;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Thread starter constructor                                       ********************************************** */   
+ThreadStarter::ThreadStarter(yarp::os::RateThread *aThread)
+    : Thread() {
+        thread = aThread;
+        async = false;
+        started = false;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Start the thread                                                 ********************************************** */   
+void ThreadStarter::run(void) {
+    started = thread->start();
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Launch the thread start                                          ********************************************** */   
+void ThreadStarter::launch(const bool &i_async) {
+    async = i_async;
+    if (async) {
+        start();
+    } else {
+        run();
+    }
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Wait for the thread                                              ********************************************** */   
+bool ThreadStarter::wait(void) {
+    if (async) {
+        join();
+    }
+
+    return started;
+}
+/* *********************************************************************************************************************** */
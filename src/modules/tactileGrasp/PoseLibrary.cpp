@@ -0,0 +1,333 @@
+/* 
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org 
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+
+#include "iCub/tactileGrasp/PoseLibrary.h"
+
+#include <iostream>
+#include <cmath>
+#include <algorithm>
+
+using std::cerr;
+using std::cout;
+using std::string;
+
+using iCub::tactileGrasp::PoseLibrary;
+using iCub::tactileGrasp::Pose;
+using iCub::tactileGrasp::MotionStatus;
+
+using yarp::os::Bottle;
+using yarp::os::Value;
+
+
+namespace {
+    /** Lowest reference speed sent to a joint, so that joints with a short travel still move (deg/s). */
+    const double minPoseSpeed = 1.0;
+
+    /**
+     * Built-in pose.
+     */
+    struct PoseTable {
+        const char *name;
+        int nJoints;
+        const int *joints;
+        const double *positions;
+        double speed;
+    };
+
+    // Grasping position of the iCub arm and hand
+    const int reachJoints[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15};
+    const double reachPositions[] = {-25, 35, 18, 65, -32, 9, -5, 20, 90, 30, 30, 5, 0, 0, 0, 40};
+    // Open iCub fingers, the thumb staying in opposition
+    const int openJoints[] = {11, 12, 13, 14, 15};
+    const double openPositions[] = {5, 0, 0, 0, 40};
+
+    const PoseTable poseTables[] = {
+        {"reach", 16, reachJoints, reachPositions, 20.0},
+        {"open", 5, openJoints, openPositions, 50.0}
+    };
+    const int nPoseTables = sizeof(poseTables) / sizeof(poseTables[0]);
+}
+
+
+/* *********************************************************************************************************************** */
+/* ******* Constructor                                                      ********************************************** */   
+PoseLibrary::PoseLibrary() {
+    dispatchTimes = NULL;
+    poseTimes = NULL;
+    batched = false;
+
+    dbgTag = "PoseLibrary: ";
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Destructor                                                       ********************************************** */   
+PoseLibrary::~PoseLibrary() {
+    delete[] dispatchTimes;
+    delete[] poseTimes;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Load the poses                                                   ********************************************** */   
+bool PoseLibrary::configure(yarp::os::ResourceFinder &rf, const int &i_nJoints) {
+    // Built-in poses
+    poses.clear();
+    for (int t = 0; t < nPoseTables; ++t) {
+        const PoseTable &table = poseTables[t];
+        Pose pose;
+        pose.name = table.name;
+        pose.joints.assign(table.joints, table.joints + table.nJoints);
+        pose.positions.assign(table.positions, table.positions + table.nJoints);
+        pose.speed = table.speed;
+        addPose(pose);
+    }
+
+    // Configured poses
+    Bottle &confPoses = rf.findGroup("poses");
+    Bottle *names = confPoses.find("names").asList();
+    if (names) {
+        for (int i = 0; i < names->size(); ++i) {
+            if (!readPose(rf, names->get(i).asString().c_str())) {
+                return false;
+            }
+        }
+    }
+
+    // Check the poses against the arm
+    for (size_t p = 0; p < poses.size(); ++p) {
+        const Pose &pose = poses[p];
+        for (size_t j = 0; j < pose.joints.size(); ++j) {
+            if ((pose.joints[j] < 0) || (pose.joints[j] >= i_nJoints)) {
+                cerr << dbgTag << "Joint " << pose.joints[j] << " of pose " << pose.name << " is not one of the " << i_nJoints << " arm joints. \n";
+                return false;
+            }
+        }
+    }
+
+    delete[] dispatchTimes;
+    delete[] poseTimes;
+    dispatchTimes = new LatencyHistogram[poses.size()];
+    poseTimes = new LatencyHistogram[poses.size()];
+    dispatches.assign(poses.size(), 0);
+    calls.assign(poses.size(), 0);
+    failures.assign(poses.size(), 0);
+
+    cout << dbgTag << "Loaded " << poses.size() << " poses:";
+    for (size_t p = 0; p < poses.size(); ++p) {
+        cout << " " << poses[p].name;
+    }
+    cout << ". \n";
+
+    return true;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Read a configured pose                                           ********************************************** */   
+bool PoseLibrary::readPose(yarp::os::ResourceFinder &rf, const std::string &i_name) {
+    Bottle &confPose = rf.findGroup(("pose_" + i_name).c_str());
+    int index = find(i_name);
+    if (confPose.isNull()) {
+        if (index < 0) {
+            cerr << dbgTag << "Missing [pose_" << i_name << "] group. \n";
+            return false;
+        }
+        return true;
+    }
+
+    Pose pose;
+    if (index >= 0) {
+        pose = poses[index];
+    } else {
+        pose.name = i_name;
+        pose.speed = 10.0;
+    }
+
+    Bottle *confJoints = confPose.find("joints").asList();
+    Bottle *confPositions = confPose.find("positions").asList();
+    if (confJoints || confPositions) {
+        if (!confJoints || !confPositions || (confJoints->size() != confPositions->size()) || (confJoints->size() == 0)) {
+            cerr << dbgTag << "The joints and positions of pose " << i_name << " must be two non-empty lists of the same size. \n";
+            return false;
+        }
+        pose.joints.resize(confJoints->size());
+        pose.positions.resize(confPositions->size());
+        for (int j = 0; j < confJoints->size(); ++j) {
+            pose.joints[j] = confJoints->get(j).asInt();
+            pose.positions[j] = confPositions->get(j).asDouble();
+        }
+    } else if (index < 0) {
+        cerr << dbgTag << "Pose " << i_name << " has no joints and positions. \n";
+        return false;
+    }
+
+    pose.speed = confPose.check("speed", Value(pose.speed)).asDouble();
+    if (pose.speed <= 0) {
+        cerr << dbgTag << "The speed of pose " << i_name << " must be positive. \n";
+        return false;
+    }
+
+    addPose(pose);
+
+    return true;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Add or replace a pose                                            ********************************************** */   
+void PoseLibrary::addPose(const Pose &i_pose) {
+    int index = find(i_pose.name);
+    if (index >= 0) {
+        poses[index] = i_pose;
+    } else {
+        poses.push_back(i_pose);
+    }
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Find a pose                                                      ********************************************** */   
+int PoseLibrary::find(const std::string &i_name) const {
+    for (size_t p = 0; p < poses.size(); ++p) {
+        if (poses[p].name == i_name) {
+            return static_cast<int>(p);
+        }
+    }
+
+    return -1;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Synchronised reference speeds                                    ********************************************** */   
+void PoseLibrary::computeSpeeds(const int &i_pose, const double *i_encoders, std::vector<double> &o_speeds) const {
+    const Pose &pose = poses[i_pose];
+
+    double maxTravel = 0.0;
+    for (size_t j = 0; j < pose.joints.size(); ++j) {
+        maxTravel = std::max(maxTravel, std::fabs(pose.positions[j] - i_encoders[pose.joints[j]]));
+    }
+
+    // Each joint covers its travel in the time taken by the longest one
+    for (size_t j = 0; j < pose.joints.size(); ++j) {
+        double travel = std::fabs(pose.positions[j] - i_encoders[pose.joints[j]]);
+        double speed = (maxTravel > 0.0) ? pose.speed * travel / maxTravel : pose.speed;
+        o_speeds[j] = std::max(minPoseSpeed, speed);
+    }
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Record a dispatch                                                ********************************************** */   
+void PoseLibrary::recordDispatch(const int &i_pose, const int &i_calls, const double &i_time, const bool &i_batched) {
+    statsMutex.lock();
+    ++dispatches[i_pose];
+    calls[i_pose] += i_calls;
+    batched = i_batched;
+    statsMutex.unlock();
+
+    dispatchTimes[i_pose].record(i_time);
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Record the end of a motion                                       ********************************************** */   
+void PoseLibrary::onMotionEnded(const int &i_id, const int &i_tag, const MotionStatus::Status &i_status, const double &i_duration) {
+    if ((i_tag < 0) || (i_tag >= static_cast<int>(poses.size()))) {
+        return;
+    }
+
+    if (i_status == MotionStatus::Done) {
+        poseTimes[i_tag].record(i_duration);
+    } else {
+        statsMutex.lock();
+        ++failures[i_tag];
+        statsMutex.unlock();
+    }
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Get the dispatch statistics                                      ********************************************** */   
+void PoseLibrary::getStats(yarp::os::Bottle &o_stats) {
+    statsMutex.lock();
+    for (size_t p = 0; p < poses.size(); ++p) {
+        Bottle &pose = o_stats.addList();
+
+        Bottle &name = pose.addList();
+        name.addString("pose");
+        name.addString(poses[p].name.c_str());
+        Bottle &mode = pose.addList();
+        mode.addString("mode");
+        mode.addString(batched ? "batched" : "perJoint");
+        Bottle &nDispatches = pose.addList();
+        nDispatches.addString("dispatches");
+        nDispatches.addInt(static_cast<int>(dispatches[p]));
+        Bottle &nCalls = pose.addList();
+        nCalls.addString("calls");
+        nCalls.addInt(static_cast<int>(calls[p]));
+        Bottle &dispatch = pose.addList();
+        dispatch.addString("dispatch");
+        dispatch.addDouble(1000.0 * dispatchTimes[p].getMean());
+        Bottle &dispatchMax = pose.addList();
+        dispatchMax.addString("dispatchMax");
+        dispatchMax.addDouble(1000.0 * dispatchTimes[p].getMax());
+        Bottle &reached = pose.addList();
+        reached.addString("reached");
+        reached.addInt(static_cast<int>(poseTimes[p].getCount()));
+        Bottle &failed = pose.addList();
+        failed.addString("failed");
+        failed.addInt(static_cast<int>(failures[p]));
+        Bottle &timeToPose = pose.addList();
+        timeToPose.addString("timeToPose");
+        timeToPose.addDouble(1000.0 * poseTimes[p].getMean());
+        Bottle &timeToPoseMax = pose.addList();
+        timeToPoseMax.addString("timeToPoseMax");
+        timeToPoseMax.addDouble(1000.0 * poseTimes[p].getMax());
+    }
+    statsMutex.unlock();
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Reset the dispatch statistics                                    ********************************************** */   
+void PoseLibrary::resetStats(void) {
+    statsMutex.lock();
+    for (size_t p = 0; p < poses.size(); ++p) {
+        dispatches[p] = 0;
+        calls[p] = 0;
+        failures[p] = 0;
+        dispatchTimes[p].reset();
+        poseTimes[p].reset();
+    }
+    statsMutex.unlock();
+}
+/* *********************************************************************************************************************** */
@@ -0,0 +1,172 @@
+/* 
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org 
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+#include "iCub/tactileGrasp/RateScheduler.h"
+
+#include <iostream>
+
+#include <yarp/os/Value.h>
+
+using std::cerr;
+using std::cout;
+
+using iCub::tactileGrasp::RateScheduler;
+using iCub::tactileGrasp::GraspPhase;
+using iCub::tactileGrasp::GraspController;
+using iCub::tactileGrasp::FingerState;
+
+using yarp::os::Value;
+
+
+/* *********************************************************************************************************************** */
+/* ******* Constructor                                                      ********************************************** */   
+RateScheduler::RateScheduler() : phase(GraspPhase::Idle), changes(0) {
+    enabled = false;
+    for (int p = 0; p < GraspPhase::Count; ++p) {
+        periods[p] = 20;
+    }
+    nearRatio = 0.5;
+    nearHold = 0.2;
+    nearUntil = -1.0;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Configure the scheduler                                          ********************************************** */   
+bool RateScheduler::configure(yarp::os::ResourceFinder &rf, const int &i_nFingers, const int &i_period, const bool &i_slipDetection) {
+    using yarp::os::Bottle;
+
+    Bottle &confRate = rf.findGroup("rate");
+    enabled = (confRate.check("adaptive", Value("off")).asString() == "on");
+    periods[GraspPhase::Idle] = confRate.check("idlePeriod", Value(100)).asInt();
+    periods[GraspPhase::Approach] = confRate.check("approachPeriod", Value(i_period)).asInt();
+    periods[GraspPhase::Near] = confRate.check("nearPeriod", Value(i_period)).asInt();
+    periods[GraspPhase::Holding] = confRate.check("holdPeriod", Value(i_period)).asInt();
+    nearRatio = confRate.check("nearRatio", Value(0.5)).asDouble();
+    nearHold = confRate.check("nearHold", Value(0.2)).asDouble();
+    for (int p = 0; p < GraspPhase::Count; ++p) {
+        if (periods[p] < 1) {
+            cerr << "RateScheduler: The [rate] period of the " << getPhaseName(static_cast<GraspPhase::Phase>(p)) << " phase must be at least 1 ms. \n";
+            return false;
+        }
+    }
+
+    if (i_slipDetection && (periods[GraspPhase::Holding] > periods[GraspPhase::Near])) {
+        if (enabled) {
+            cout << "RateScheduler: The slips are detected while holding. Using the near contact period when holding. \n";
+        }
+        periods[GraspPhase::Holding] = periods[GraspPhase::Near];
+    }
+
+    lastMaxTaxels.assign(i_nFingers, 0.0);
+    nearUntil = -1.0;
+    phase = GraspPhase::Idle;
+    changes = 0;
+
+    if (enabled) {
+        cout << "RateScheduler: Control periods of " << periods[GraspPhase::Idle] << " ms when idle, " << periods[GraspPhase::Approach] 
+            << " ms when approaching, " << periods[GraspPhase::Near] << " ms near contact and " << periods[GraspPhase::Holding] << " ms when holding. \n";
+    }
+
+    return true;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Update the grasp phase                                           ********************************************** */   
+bool RateScheduler::update(const GraspController &i_controller, const double &i_time) {
+    if (!i_controller.hasVelocities()) {
+        return setPhase(GraspPhase::Idle);
+    }
+
+    bool anyContact = false;
+    bool allContact = true;
+    bool imminent = false;
+    for (int i = 0; i < i_controller.getFingerCount(); ++i) {
+        double threshold = i_controller.getPatch(i).threshold;
+        const FingerState &finger = i_controller.getFinger(i);
+        // Fingers without a threshold never touch
+        if (threshold > 0.0) {
+            if (finger.contact) {
+                anyContact = true;
+            } else {
+                allContact = false;
+                if ((finger.maxTaxel >= nearRatio * threshold) && (finger.maxTaxel > lastMaxTaxels[i])) {
+                    imminent = true;
+                }
+            }
+        }
+        // A slipping finger is followed closely as well
+        if (i_time < finger.tightenUntil) {
+            imminent = true;
+        }
+        lastMaxTaxels[i] = finger.maxTaxel;
+    }
+    if (imminent) {
+        nearUntil = i_time + nearHold;
+    }
+
+    if (i_time < nearUntil) {
+        return setPhase(GraspPhase::Near);
+    } else if (anyContact && allContact) {
+        return setPhase(GraspPhase::Holding);
+    }
+    return setPhase(GraspPhase::Approach);
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Set the grasp phase                                              ********************************************** */   
+bool RateScheduler::setPhase(const GraspPhase::Phase &i_phase) {
+    if (phase.load() == i_phase) {
+        return false;
+    }
+
+    if (i_phase == GraspPhase::Idle) {
+        nearUntil = -1.0;
+        lastMaxTaxels.assign(lastMaxTaxels.size(), 0.0);
+    }
+    phase = i_phase;
+    ++changes;
+
+    return true;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Get the name of a phase                                          ********************************************** */   
+const char *RateScheduler::getPhaseName(const GraspPhase::Phase &i_phase) {
+    switch (i_phase) {
+        case GraspPhase::Idle:
+            return "idle";
+        case GraspPhase::Approach:
+            return "approach";
+        case GraspPhase::Near:
+            return "near";
+        case GraspPhase::Holding:
+            return "holding";
+        default:
+            return "unknown";
+    }
+}
+/* *********************************************************************************************************************** */
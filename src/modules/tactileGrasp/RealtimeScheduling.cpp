@@ -0,0 +1,187 @@
+/* 
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org 
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+#include "iCub/tactileGrasp/RealtimeScheduling.h"
+
+#include <iostream>
+#include <cstring>
+#include <cerrno>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <alloca.h>
+#endif
+
+#include <yarp/os/Value.h>
+
+using std::cerr;
+using std::cout;
+using std::string;
+
+using iCub::tactileGrasp::RealtimeScheduling;
+
+using yarp::os::Value;
+
+
+/* *********************************************************************************************************************** */
+/* ******* Constructor                                                      ********************************************** */   
+RealtimeScheduling::RealtimeScheduling() {
+    policy = "other";
+    priority = 50;
+    cpu = -1;
+    lockMemory = false;
+    prefaultStack = 64;
+
+    appliedPolicy = "other";
+    appliedPriority = 0;
+    appliedCpu = -1;
+    memoryLocked = false;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Configure the scheduling                                         ********************************************** */   
+bool RealtimeScheduling::configure(yarp::os::ResourceFinder &rf) {
+    using yarp::os::Bottle;
+
+    Bottle &confRealtime = rf.findGroup("realtime");
+    policy = confRealtime.check("policy", Value("other")).asString().c_str();
+    priority = confRealtime.check("priority", Value(50)).asInt();
+    cpu = confRealtime.check("cpu", Value(-1)).asInt();
+    lockMemory = (confRealtime.check("lockMemory", Value("off")).asString() == "on");
+    prefaultStack = confRealtime.check("prefaultStack", Value(64)).asInt();
+    if ((policy != "other") && (policy != "fifo") && (policy != "rr")) {
+        cerr << "RealtimeScheduling: Invalid [realtime] policy " << policy << ". Expected other, fifo or rr. \n";
+        return false;
+    }
+    if ((policy != "other") && ((priority < 1) || (priority > 99))) {
+        cerr << "RealtimeScheduling: The [realtime] priority must be between 1 and 99. \n";
+        return false;
+    }
+    if ((prefaultStack < 0) || (prefaultStack > 1024)) {
+        cerr << "RealtimeScheduling: The [realtime] prefaultStack must be between 0 and 1024 KB. \n";
+        return false;
+    }
+#if defined(__linux__)
+    if (cpu >= CPU_SETSIZE) {
+        cerr << "RealtimeScheduling: The [realtime] cpu " << cpu << " is beyond the largest CPU set (" << CPU_SETSIZE 
+            << "). Running on any CPU. \n";
+        cpu = -1;
+    }
+#endif
+    if (cpu < 0) {
+        cpu = -1;
+    }
+
+    return true;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Apply the scheduling to the calling thread                       ********************************************** */   
+void RealtimeScheduling::apply(const std::string &i_tag) {
+#if defined(__linux__)
+    // Memory first, so that the thread does not page fault once it runs at a real-time priority
+    if (lockMemory) {
+        if (mlockall(MCL_CURRENT | MCL_FUTURE) == 0) {
+            memoryLocked = true;
+            cout << i_tag << "Locked the memory of the process. \n";
+        } else {
+            cerr << i_tag << "Could not lock the memory (" << strerror(errno) << "). The memory can be paged out. \n";
+        }
+    }
+    if (lockMemory || (policy != "other")) {
+        prefault(prefaultStack);
+    }
+
+    if (cpu >= 0) {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(cpu, &cpus);
+        int err = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+        if (err == 0) {
+            appliedCpu = cpu;
+            cout << i_tag << "Pinned to CPU " << cpu << ". \n";
+        } else {
+            cerr << i_tag << "Could not pin the thread to CPU " << cpu << " (" << strerror(err) << "). Running on any CPU. \n";
+        }
+    }
+
+    if (policy != "other") {
+        sched_param param;
+        std::memset(&param, 0, sizeof(param));
+        param.sched_priority = priority;
+        int err = pthread_setschedparam(pthread_self(), (policy == "fifo" ? SCHED_FIFO : SCHED_RR), &param);
+        if (err == 0) {
+            appliedPolicy = policy;
+            appliedPriority = priority;
+            cout << i_tag << "Running with the " << policy << " scheduling policy at priority " << priority << ". \n";
+        } else {
+            cerr << i_tag << "Could not set the " << policy << " scheduling policy at priority " << priority << " (" << strerror(err) 
+                << "). Running with the default scheduling. \n";
+        }
+    }
+#else
+    if (lockMemory || (cpu >= 0) || (policy != "other")) {
+        cerr << i_tag << "The [realtime] options are only supported on Linux. Running with the default scheduling. \n";
+    }
+#endif
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Prefault the stack                                               ********************************************** */   
+void RealtimeScheduling::prefault(const int &i_size) {
+#if defined(__linux__)
+    if (i_size > 0) {
+        // Writing the pages maps them, and keeps them mapped once the memory is locked
+        volatile unsigned char *stack = static_cast<volatile unsigned char *>(alloca(i_size * 1024));
+        for (int b = 0; b < i_size * 1024; b += 512) {
+            stack[b] = 0;
+        }
+    }
+#endif
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Get the scheduling in effect                                     ********************************************** */   
+void RealtimeScheduling::getStats(yarp::os::Bottle &o_stats) const {
+    using yarp::os::Bottle;
+
+    Bottle &policyStat = o_stats.addList();
+    policyStat.addString("policy");
+    policyStat.addString(appliedPolicy.c_str());
+    Bottle &priorityStat = o_stats.addList();
+    priorityStat.addString("priority");
+    priorityStat.addInt(appliedPriority);
+    Bottle &cpuStat = o_stats.addList();
+    cpuStat.addString("cpu");
+    cpuStat.addInt(appliedCpu);
+    Bottle &lockedStat = o_stats.addList();
+    lockedStat.addString("memoryLocked");
+    lockedStat.addInt(memoryLocked ? 1 : 0);
+}
+/* *********************************************************************************************************************** */
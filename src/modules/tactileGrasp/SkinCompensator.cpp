@@ -0,0 +1,153 @@
+/* 
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org 
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+#include "iCub/tactileGrasp/SkinCompensator.h"
+
+#include <iostream>
+#include <cmath>
+#include <algorithm>
+
+#include <yarp/os/Bottle.h>
+#include <yarp/os/Value.h>
+
+using std::cerr;
+using std::cout;
+
+using iCub::tactileGrasp::SkinCompensator;
+
+using yarp::os::Value;
+
+
+/* *********************************************************************************************************************** */
+/* ******* Constructor                                                      ********************************************** */   
+SkinCompensator::SkinCompensator() {
+    enabled = false;
+    inverted = true;
+    calibrationSamples = 50;
+    driftRate = 0.001;
+    touchMargin = 3.0;
+    minTouch = 2.0;
+    samples = 0;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Configure the compensation                                       ********************************************** */   
+bool SkinCompensator::configure(yarp::os::ResourceFinder &rf) {
+    using yarp::os::Bottle;
+
+    Bottle &confCompensation = rf.findGroup("compensation");
+    std::string source = confCompensation.check("source", Value("external")).asString().c_str();
+    if ((source != "external") && (source != "internal")) {
+        cerr << "SkinCompensator: Invalid [compensation] source " << source << ". Expected external or internal. \n";
+        return false;
+    }
+    enabled = (source == "internal");
+    inverted = (confCompensation.check("inverted", Value("on")).asString() == "on");
+    calibrationSamples = std::max(1, confCompensation.check("calibrationSamples", Value(50)).asInt());
+    driftRate = confCompensation.check("driftRate", Value(0.001)).asDouble();
+    touchMargin = confCompensation.check("touchMargin", Value(3.0)).asDouble();
+    minTouch = confCompensation.check("minTouch", Value(2.0)).asDouble();
+    if ((driftRate < 0.0) || (driftRate > 1.0)) {
+        cerr << "SkinCompensator: The [compensation] driftRate must be in [0, 1]. \n";
+        return false;
+    }
+
+    reset();
+
+    return true;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Accessors                                                        ********************************************** */   
+bool SkinCompensator::isEnabled(void) const {
+    return enabled;
+}
+
+bool SkinCompensator::isCalibrated(void) const {
+    return (samples >= calibrationSamples);
+}
+
+double SkinCompensator::getBaseline(const size_t &i_taxel) const {
+    return (isCalibrated() && (i_taxel < baselines.size())) ? baselines[i_taxel] : 0.0;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Restart the calibration                                          ********************************************** */   
+void SkinCompensator::reset(void) {
+    samples = 0;
+    baselines.assign(baselines.size(), 0.0);
+    squares.assign(squares.size(), 0.0);
+    thresholds.assign(thresholds.size(), 0.0);
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Compensate a raw skin frame                                      ********************************************** */   
+bool SkinCompensator::compensate(const yarp::sig::Vector &i_raw, yarp::sig::Vector &o_comp) {
+    size_t nTaxels = i_raw.size();
+    if (nTaxels != baselines.size()) {
+        baselines.assign(nTaxels, 0.0);
+        squares.assign(nTaxels, 0.0);
+        thresholds.assign(nTaxels, 0.0);
+        samples = 0;
+    }
+    if (o_comp.size() != nTaxels) {
+        o_comp.resize(nTaxels);
+    }
+
+    // Calibration: accumulate the mean and the variance of each taxel
+    if (samples < calibrationSamples) {
+        for (size_t t = 0; t < nTaxels; ++t) {
+            baselines[t] += i_raw[t];
+            squares[t] += i_raw[t]*i_raw[t];
+        }
+        if (++samples == calibrationSamples) {
+            for (size_t t = 0; t < nTaxels; ++t) {
+                baselines[t] /= samples;
+                double variance = std::max(0.0, squares[t]/samples - baselines[t]*baselines[t]);
+                thresholds[t] = std::max(minTouch, touchMargin*std::sqrt(variance));
+            }
+            cout << "SkinCompensator: Calibrated the baselines of " << nTaxels << " taxels over " << samples << " frames. \n";
+        }
+        return false;
+    }
+
+    // Compensation and drift tracking
+    const double sign = (inverted ? -1.0 : 1.0);
+    for (size_t t = 0; t < nTaxels; ++t) {
+        double deviation = sign*(i_raw[t] - baselines[t]);
+        if (deviation < thresholds[t]) {
+            // Untouched, or drifting away from the pressed side: follow the drift
+            baselines[t] += driftRate*(i_raw[t] - baselines[t]);
+            o_comp[t] = 0.0;
+        } else {
+            o_comp[t] = std::max(0.0, deviation - thresholds[t]);
+        }
+    }
+
+    return true;
+}
+/* *********************************************************************************************************************** */
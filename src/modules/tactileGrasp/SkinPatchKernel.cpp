@@ -0,0 +1,150 @@
+/* 
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org 
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+
+#include "iCub/tactileGrasp/SkinPatchKernel.h"
+
+#include <limits>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+using iCub::tactileGrasp::SkinPatchKernel;
+using iCub::tactileGrasp::TaxelPatch;
+using iCub::tactileGrasp::PatchStats;
+
+
+namespace {
+    /** Number of bits set in each 4-bit lane mask, as returned by the movemask instructions. */
+    const int maskBits[16] = {0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4};
+
+    /**
+     * Reduce a single patch using the fastest available instruction set.
+     */
+    inline void reducePatch(const double *i_taxels, const int &i_count, const double &i_threshold, PatchStats &o_stats) {
+        double max = -std::numeric_limits<double>::infinity();
+        double sum = 0.0;
+        int nActive = 0;
+        int i = 0;
+
+#if defined(__AVX__)
+        const __m256d threshold = _mm256_set1_pd(i_threshold);
+        __m256d vMax = _mm256_set1_pd(max);
+        __m256d vSum = _mm256_setzero_pd();
+        for (; i + 4 <= i_count; i += 4) {
+            __m256d x = _mm256_loadu_pd(i_taxels + i);
+            vMax = _mm256_max_pd(vMax, x);
+            vSum = _mm256_add_pd(vSum, x);
+            nActive += maskBits[_mm256_movemask_pd(_mm256_cmp_pd(x, threshold, _CMP_GE_OQ))];
+        }
+
+        // Horizontal reduction
+        double lanesMax[4], lanesSum[4];
+        _mm256_storeu_pd(lanesMax, vMax);
+        _mm256_storeu_pd(lanesSum, vSum);
+        for (int l = 0; l < 4; ++l) {
+            max = (lanesMax[l] > max) ? lanesMax[l] : max;
+            sum += lanesSum[l];
+        }
+#elif defined(__SSE2__)
+        const __m128d threshold = _mm_set1_pd(i_threshold);
+        __m128d vMax = _mm_set1_pd(max);
+        __m128d vSum = _mm_setzero_pd();
+        for (; i + 2 <= i_count; i += 2) {
+            __m128d x = _mm_loadu_pd(i_taxels + i);
+            vMax = _mm_max_pd(vMax, x);
+            vSum = _mm_add_pd(vSum, x);
+            nActive += maskBits[_mm_movemask_pd(_mm_cmpge_pd(x, threshold))];
+        }
+
+        // Horizontal reduction
+        double lanesMax[2], lanesSum[2];
+        _mm_storeu_pd(lanesMax, vMax);
+        _mm_storeu_pd(lanesSum, vSum);
+        for (int l = 0; l < 2; ++l) {
+            max = (lanesMax[l] > max) ? lanesMax[l] : max;
+            sum += lanesSum[l];
+        }
+#endif
+
+        // Remaining taxels
+        for (; i < i_count; ++i) {
+            max = (i_taxels[i] > max) ? i_taxels[i] : max;
+            sum += i_taxels[i];
+            nActive += (i_taxels[i] >= i_threshold);
+        }
+
+        o_stats.max = (i_count > 0) ? max : 0.0;
+        o_stats.sum = sum;
+        o_stats.nActive = nActive;
+    }
+}
+
+
+/* *********************************************************************************************************************** */
+/* ******* Vectorised reduction                                             ********************************************** */
+void SkinPatchKernel::reduce(const double *i_taxels, const TaxelPatch *i_patches, const int &i_nPatches, PatchStats *o_stats) {
+    for (int p = 0; p < i_nPatches; ++p) {
+        reducePatch(i_taxels + i_patches[p].offset, i_patches[p].count, i_patches[p].threshold, o_stats[p]);
+    }
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Reference scalar reduction                                       ********************************************** */
+void SkinPatchKernel::reduceScalar(const double *i_taxels, const TaxelPatch *i_patches, const int &i_nPatches, PatchStats *o_stats) {
+    for (int p = 0; p < i_nPatches; ++p) {
+        const double *taxels = i_taxels + i_patches[p].offset;
+        double max = 0.0;
+        double sum = 0.0;
+        int nActive = 0;
+        for (int i = 0; i < i_patches[p].count; ++i) {
+            if ((i == 0) || (taxels[i] > max)) {
+                max = taxels[i];
+            }
+            sum += taxels[i];
+            if (taxels[i] >= i_patches[p].threshold) {
+                ++nActive;
+            }
+        }
+
+        o_stats[p].max = max;
+        o_stats[p].sum = sum;
+        o_stats[p].nActive = nActive;
+    }
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Instruction set                                                  ********************************************** */
+const char *SkinPatchKernel::getInstructionSet(void) {
+#if defined(__AVX__)
+    return "AVX";
+#elif defined(__SSE2__)
+    return "SSE2";
+#else
+    return "scalar";
+#endif
+}
+/* *********************************************************************************************************************** */
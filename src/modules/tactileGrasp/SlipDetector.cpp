@@ -0,0 +1,182 @@
+/* 
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org 
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+#include "iCub/tactileGrasp/SlipDetector.h"
+
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+
+#include <yarp/os/Value.h>
+
+using std::cerr;
+using std::cout;
+
+using iCub::tactileGrasp::SlipDetector;
+
+using yarp::os::Value;
+
+
+/* *********************************************************************************************************************** */
+/* ******* Constructor                                                      ********************************************** */   
+SlipDetector::SlipDetector() {
+    enabled = false;
+    window = 8;
+    centroidShift = 1.5;
+    derivativeThreshold = 2.0;
+    oscillations = 3;
+    minPressure = 1.0;
+    tightenScale = 0.3;
+    tightenTime = 0.1;
+
+    costSum = 0.0;
+    costMax = 0.0;
+    costCount = 0;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Configure the detector                                           ********************************************** */   
+bool SlipDetector::configure(yarp::os::Searchable &rf, const int &i_nFingers, const std::vector<double> &i_positions) {
+    using yarp::os::Bottle;
+
+    Bottle &confSlip = rf.findGroup("slip");
+    enabled = (confSlip.check("enabled", Value("off")).asString() == "on");
+    window = confSlip.check("window", Value(8)).asInt();
+    centroidShift = confSlip.check("centroidShift", Value(1.5)).asDouble();
+    derivativeThreshold = confSlip.check("derivativeThreshold", Value(2.0)).asDouble();
+    oscillations = confSlip.check("oscillations", Value(3)).asInt();
+    minPressure = confSlip.check("minPressure", Value(1.0)).asDouble();
+    tightenScale = confSlip.check("tightenScale", Value(0.3)).asDouble();
+    tightenTime = confSlip.check("tightenTime", Value(0.1)).asDouble();
+    if ((window < 2) || (window > 32)) {
+        cerr << "SlipDetector: The [slip] window must be between 2 and 32 samples. \n";
+        return false;
+    }
+
+    fingers.resize(i_nFingers);
+    positions = i_positions;
+    reset();
+    resetStats();
+
+    if (enabled) {
+        cout << "SlipDetector: Detecting the slips with a centroid shift of " << centroidShift << " mm or " << oscillations 
+            << " pressure oscillations in " << window << " samples. \n";
+    }
+
+    return true;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Update the slip state of a fingertip                             ********************************************** */   
+bool SlipDetector::update(const int &i_finger, const double *i_taxels, const int &i_count) {
+    FingerSlip &finger = fingers[i_finger];
+
+    // Pressure centroid on the fingertip
+    double pressure = 0.0;
+    double momentX = 0.0;
+    double momentY = 0.0;
+    for (int t = 0; t < i_count; ++t) {
+        pressure += i_taxels[t];
+        momentX += positions[2*t] * i_taxels[t];
+        momentY += positions[2*t + 1] * i_taxels[t];
+    }
+    if (pressure < minPressure) {
+        finger.tracking = false;
+        return false;
+    }
+    double centroidX = momentX / pressure;
+    double centroidY = momentY / pressure;
+
+    if (!finger.tracking) {
+        finger.tracking = true;
+        finger.centroidX = centroidX;
+        finger.centroidY = centroidY;
+        finger.pressure = pressure;
+        finger.lastSign = 0;
+        finger.signChanges = 0;
+        return false;
+    }
+
+    // Oscillations of the pressure derivative
+    double derivative = pressure - finger.pressure;
+    finger.signChanges <<= 1;
+    if (std::fabs(derivative) >= derivativeThreshold) {
+        int sign = (derivative > 0.0) ? 1 : -1;
+        if ((finger.lastSign != 0) && (sign != finger.lastSign)) {
+            finger.signChanges |= 1u;
+        }
+        finger.lastSign = sign;
+    }
+    finger.signChanges &= (window >= 32) ? ~0u : ((1u << window) - 1u);
+
+    // Count the sign changes of the window
+    int changes = 0;
+    for (unsigned int bits = finger.signChanges; bits; bits &= bits - 1) {
+        ++changes;
+    }
+
+    double shiftX = centroidX - finger.centroidX;
+    double shiftY = centroidY - finger.centroidY;
+    bool slipping = (shiftX*shiftX + shiftY*shiftY >= centroidShift*centroidShift) || (changes >= oscillations);
+    finger.centroidX = centroidX;
+    finger.centroidY = centroidY;
+    finger.pressure = pressure;
+
+    if (slipping) {
+        ++finger.slips;
+        // Start afresh, so that a single slip is not reported several times
+        finger.tracking = false;
+    }
+
+    return slipping;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Reset                                                            ********************************************** */   
+void SlipDetector::reset(void) {
+    for (size_t i = 0; i < fingers.size(); ++i) {
+        fingers[i].tracking = false;
+    }
+}
+
+void SlipDetector::resetStats(void) {
+    for (size_t i = 0; i < fingers.size(); ++i) {
+        fingers[i].slips = 0;
+    }
+    costSum = 0.0;
+    costMax = 0.0;
+    costCount = 0;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Detection cost                                                   ********************************************** */   
+void SlipDetector::recordCost(const double &i_cost) {
+    costSum += i_cost;
+    costMax = std::max(costMax, i_cost);
+    ++costCount;
+}
+/* *********************************************************************************************************************** */
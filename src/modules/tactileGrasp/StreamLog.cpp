@@ -0,0 +1,353 @@
+/* 
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org 
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+
+#include "iCub/tactileGrasp/StreamLog.h"
+
+#include <iostream>
+#include <cstring>
+#include <cerrno>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+using std::cerr;
+using std::cout;
+
+using iCub::tactileGrasp::StreamRecorder;
+using iCub::tactileGrasp::StreamReader;
+using iCub::tactileGrasp::StreamFileHeader;
+using iCub::tactileGrasp::StreamFrameHeader;
+using iCub::tactileGrasp::StreamFrameType;
+
+
+namespace {
+    const char streamMagic[8] = {'T', 'G', 'S', 'T', 'R', 'E', 'A', 'M'};
+    const uint32_t streamVersion = 1;
+    /** The log file is grown by this amount when full. */
+    const size_t streamChunkSize = 16 * 1024 * 1024;
+    /** Capacity of the serialisation buffer of the contact lists, in doubles. */
+    const size_t contactBufferSize = 16 * 1024;
+}
+
+
+/* *********************************************************************************************************************** */
+/* ******* Recorder                                                         ********************************************** */
+StreamRecorder::StreamRecorder() {
+    fd = -1;
+    map = NULL;
+    mapSize = 0;
+    used = 0;
+
+    dbgTag = "StreamRecorder: ";
+}
+
+StreamRecorder::~StreamRecorder() {
+    close();
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Create the log file                                              ********************************************** */
+bool StreamRecorder::open(const std::string &i_path, const int &i_nJoints) {
+    close();
+
+#if defined(_WIN32)
+    cerr << dbgTag << "Recording the grasp streams is not supported on this platform. \n";
+    return false;
+#else
+    // The contact lists are serialised without allocating, unless they are unusually large
+    contactBuffer.reserve(contactBufferSize);
+
+    mutex.lock();
+    fd = ::open(i_path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        cerr << dbgTag << "Could not create the log file " << i_path << ": " << std::strerror(errno) << ". \n";
+        mutex.unlock();
+        return false;
+    }
+
+    used = 0;
+    if (!reserve(sizeof(StreamFileHeader))) {
+        mutex.unlock();
+        return false;
+    }
+
+    StreamFileHeader header;
+    std::memcpy(header.magic, streamMagic, sizeof(header.magic));
+    header.version = streamVersion;
+    header.nJoints = i_nJoints;
+    std::memcpy(map, &header, sizeof(header));
+    used = sizeof(header);
+    mutex.unlock();
+
+    cout << dbgTag << "Recording the grasp streams to " << i_path << ". \n";
+
+    return true;
+#endif
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Close the log file                                               ********************************************** */
+void StreamRecorder::close(void) {
+    mutex.lock();
+    release();
+    mutex.unlock();
+}
+
+void StreamRecorder::release(void) {
+#if !defined(_WIN32)
+    if (map) {
+        munmap(map, mapSize);
+        map = NULL;
+    }
+    if (fd >= 0) {
+        // Drop the unused part of the last chunk
+        if (ftruncate(fd, used) != 0) {
+            cerr << dbgTag << "Could not truncate the log file: " << std::strerror(errno) << ". \n";
+        }
+        ::close(fd);
+        fd = -1;
+    }
+#endif
+    mapSize = 0;
+    used = 0;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Grow the mapping                                                 ********************************************** */
+bool StreamRecorder::reserve(const size_t &i_bytes) {
+    if (used + i_bytes <= mapSize) {
+        return true;
+    }
+    if (fd < 0) {
+        return false;
+    }
+
+#if defined(_WIN32)
+    return false;
+#else
+    size_t newSize = mapSize + streamChunkSize;
+    while (used + i_bytes > newSize) {
+        newSize += streamChunkSize;
+    }
+
+    if (map) {
+        munmap(map, mapSize);
+        map = NULL;
+    }
+    if (ftruncate(fd, newSize) != 0) {
+        cerr << dbgTag << "Could not grow the log file: " << std::strerror(errno) << ". Recording stopped. \n";
+        release();
+        return false;
+    }
+    void *newMap = mmap(NULL, newSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (newMap == MAP_FAILED) {
+        cerr << dbgTag << "Could not map the log file: " << std::strerror(errno) << ". Recording stopped. \n";
+        release();
+        return false;
+    }
+    map = static_cast<char *>(newMap);
+    mapSize = newSize;
+
+    return true;
+#endif
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Append a frame                                                   ********************************************** */
+bool StreamRecorder::write(const int &i_type, const double *i_data, const size_t &i_count, const double &i_arrivalTime, const yarp::os::Stamp &i_stamp) {
+    mutex.lock();
+    bool ok = append(i_type, i_data, i_count, i_arrivalTime, i_stamp);
+    mutex.unlock();
+
+    return ok;
+}
+
+bool StreamRecorder::append(const int &i_type, const double *i_data, const size_t &i_count, const double &i_arrivalTime, const yarp::os::Stamp &i_stamp) {
+    size_t bytes = sizeof(StreamFrameHeader) + i_count * sizeof(double);
+    if (!reserve(bytes)) {
+        return false;
+    }
+
+    StreamFrameHeader header;
+    header.type = i_type;
+    header.count = i_count;
+    header.sequence = i_stamp.isValid() ? i_stamp.getCount() : -1;
+    header.reserved = 0;
+    header.arrivalTime = i_arrivalTime;
+    header.stampTime = i_stamp.isValid() ? i_stamp.getTime() : -1.0;
+    std::memcpy(map + used, &header, sizeof(header));
+    if (i_count > 0) {
+        std::memcpy(map + used + sizeof(header), i_data, i_count * sizeof(double));
+    }
+    used += bytes;
+
+    return true;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Append a contact list                                            ********************************************** */
+bool StreamRecorder::writeContacts(const iCub::skinDynLib::skinContactList &i_contacts, const double &i_arrivalTime, const yarp::os::Stamp &i_stamp) {
+    mutex.lock();
+    contactBuffer.clear();
+    for (size_t i = 0; i < i_contacts.size(); ++i) {
+        const iCub::skinDynLib::skinContact &contact = i_contacts[i];
+        // skinContact returns a copy of its taxel list
+        const std::vector<unsigned int> &taxels = contact.getTaxelList();
+        contactBuffer.push_back(contact.getBodyPart());
+        contactBuffer.push_back(contact.getSkinPart());
+        contactBuffer.push_back(contact.getPressure());
+        contactBuffer.push_back(taxels.size());
+        contactBuffer.insert(contactBuffer.end(), taxels.begin(), taxels.end());
+    }
+
+    bool ok = append(StreamFrameType::Contacts, contactBuffer.empty() ? NULL : &contactBuffer[0], contactBuffer.size(), i_arrivalTime, i_stamp);
+    mutex.unlock();
+
+    return ok;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Reader                                                           ********************************************** */
+StreamReader::StreamReader() {
+    fd = -1;
+    map = NULL;
+    mapSize = 0;
+    position = 0;
+    nJoints = 0;
+
+    dbgTag = "StreamReader: ";
+}
+
+StreamReader::~StreamReader() {
+    close();
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Open a log file                                                  ********************************************** */
+bool StreamReader::open(const std::string &i_path) {
+    close();
+
+#if defined(_WIN32)
+    cerr << dbgTag << "Reading the stream logs is not supported on this platform. \n";
+    return false;
+#else
+    fd = ::open(i_path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        cerr << dbgTag << "Could not open the log file " << i_path << ": " << std::strerror(errno) << ". \n";
+        return false;
+    }
+
+    struct stat info;
+    if ((fstat(fd, &info) != 0) || (static_cast<size_t>(info.st_size) < sizeof(StreamFileHeader))) {
+        cerr << dbgTag << i_path << " is not a stream log. \n";
+        close();
+        return false;
+    }
+    mapSize = info.st_size;
+    void *newMap = mmap(NULL, mapSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (newMap == MAP_FAILED) {
+        cerr << dbgTag << "Could not map the log file: " << std::strerror(errno) << ". \n";
+        mapSize = 0;
+        close();
+        return false;
+    }
+    map = static_cast<const char *>(newMap);
+
+    const StreamFileHeader *header = reinterpret_cast<const StreamFileHeader *>(map);
+    if ((std::memcmp(header->magic, streamMagic, sizeof(streamMagic)) != 0) || (header->version != streamVersion)) {
+        cerr << dbgTag << i_path << " is not a version " << streamVersion << " stream log. \n";
+        close();
+        return false;
+    }
+    nJoints = header->nJoints;
+    rewind();
+
+    return true;
+#endif
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Close the log file                                               ********************************************** */
+void StreamReader::close(void) {
+#if !defined(_WIN32)
+    if (map) {
+        munmap(const_cast<char *>(map), mapSize);
+        map = NULL;
+    }
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+#endif
+    mapSize = 0;
+    position = 0;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Get the next frame                                               ********************************************** */
+bool StreamReader::next(const StreamFrameHeader *&o_header, const double *&o_data) {
+    if (!map || (position + sizeof(StreamFrameHeader) > mapSize)) {
+        return false;
+    }
+
+    const StreamFrameHeader *header = reinterpret_cast<const StreamFrameHeader *>(map + position);
+    size_t bytes = sizeof(StreamFrameHeader) + header->count * sizeof(double);
+    if (position + bytes > mapSize) {
+        cerr << dbgTag << "Truncated frame at offset " << position << ". \n";
+        return false;
+    }
+
+    o_header = header;
+    o_data = reinterpret_cast<const double *>(map + position + sizeof(StreamFrameHeader));
+    position += bytes;
+
+    return true;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Go back to the first frame                                       ********************************************** */
+void StreamReader::rewind(void) {
+    position = sizeof(StreamFileHeader);
+}
+/* *********************************************************************************************************************** */
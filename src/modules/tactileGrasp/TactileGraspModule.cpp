@@ -19,10 +19,15 @@
 
 
 #include "iCub/tactileGrasp/TactileGraspModule.h"
+#include "iCub/tactileGrasp/AsyncLog.h"
 
 #include <iostream>
+#include <algorithm>
+
+#include <yarp/os/Time.h>
 
 using iCub::tactileGrasp::TactileGraspModule;
+using iCub::tactileGrasp::AsyncLog;
 
 using std::cerr;
 using std::cout;
@@ -39,6 +44,14 @@ TactileGraspModule::TactileGraspModule()
     : RFModule(), tactileGrasp_IDLServer() {
         closing = false;
 
+        gazeThread = NULL;
+
+        handsMotions.resize(32);
+        for (size_t i = 0; i < handsMotions.size(); ++i) {
+            handsMotions[i].id = -1;
+        }
+        nextHandsMotion = 0;
+
         dbgTag = "TactileGraspModule: ";
 }
 /* *********************************************************************************************************************** */
@@ -46,7 +59,12 @@ TactileGraspModule::TactileGraspModule()
 
 /* *********************************************************************************************************************** */
 /* ******* Destructor                                                       ********************************************** */   
-TactileGraspModule::~TactileGraspModule() {}
+TactileGraspModule::~TactileGraspModule() {
+    delete gazeThread;
+    for (size_t h = 0; h < graspThreads.size(); ++h) {
+        delete graspThreads[h];
+    }
+}
 /* *********************************************************************************************************************** */
 
 
@@ -63,12 +81,20 @@ bool TactileGraspModule::configure(ResourceFinder &rf) {
     using yarp::os::Property;
 
     cout << dbgTag << "Starting. \n";
+    startupTimer.reset();
 
     /* ****** Configure the Module                            ****** */
     // Get resource finder and extract properties
     moduleName = rf.check("name", Value("tactileGrasp"), "The module name.").asString().c_str();
     period = rf.check("period", 1.0).asDouble();
 
+    // The control loops log through the log thread
+    AsyncLog &log = AsyncLog::get();
+    if (!log.configure(rf) || !log.start()) {
+        cerr << dbgTag << "Could not start the log thread. \n";
+        return false;
+    }
+
 
     /* ******* Open ports                                       ******* */
     portTactileGraspRPC.open("/tactileGrasp/cmd:io");
@@ -77,28 +103,7 @@ bool TactileGraspModule::configure(ResourceFinder &rf) {
 
     /* ******* Get parameters from rf                           ******* */
     // Build velocities
-    Bottle &confVelocity = rf.findGroup("velocity");
-    if (!confVelocity.isNull()) {
-        // Velocities
-        Bottle *confVelGrasp = confVelocity.find("grasp").asList();
-        if (confVelGrasp->size() > 0) {
-            velocities.grasp.resize(confVelGrasp->size(), 0.0);
-            velocities.stop.resize(confVelGrasp->size(), 0.0);
-            for (int i = 0; i < confVelGrasp->size(); ++i) {
-                // Grasp velocities
-                velocities.grasp[i] = confVelGrasp->get(i).asDouble();
-
-                // Stop velocities
-                if (velocities.grasp[i] > 0) {
-                    velocities.stop[i] = confVelocity.check("stop", Value(0.0)).asDouble();
-                }
-            }
-        } else {
-            cerr << dbgTag << "No grasp velocities were found in the specified configuration file. \n";
-            return false;
-        }
-    } else {
-        cerr << dbgTag << "Could not find the velocities parameter group [velocity] in the given configuration file. \n";
+    if (!readGraspVelocities(rf, velocities)) {
         return false;
     }
 
@@ -106,25 +111,67 @@ bool TactileGraspModule::configure(ResourceFinder &rf) {
     cout << "\n";
     cout << "DEBUG: " << dbgTag << "Configured velocities: \n";
     for (size_t i = 0; i < velocities.grasp.size(); ++i) {
-        cout << "DEBUG: " << dbgTag << "\t Joint " << i + 8 << ":\t" << velocities.grasp[i] << "\t" << velocities.stop[i] << "\n";
+        cout << "DEBUG: " << dbgTag << "\t Velocity " << i << ":\t" << velocities.grasp[i] << "\t" << velocities.stop[i] << "\n";
     }
     cout << "\n";
 #endif
 
     /* ******* Threads                                          ******* */
-    // Gaze thread
-    gazeThread = new GazeThread(100, rf);
-    if (!gazeThread->start()) {
+    // One grasp thread for each hand
+    string whichHand = rf.check("whichHand", Value("right"), "The hand to be used for the grasping.").asString().c_str();
+    std::vector<string> hands;
+    if (whichHand == "both") {
+        hands.push_back("left");
+        hands.push_back("right");
+    } else {
+        hands.push_back(whichHand);
+    }
+    int graspPeriod = 20;
+    double tickOrigin = yarp::os::Time::now();
+    for (size_t h = 0; h < hands.size(); ++h) {
+        GraspThread *thread = new GraspThread(graspPeriod, rf, hands[h], &startupTimer);
+        // Spread the ticks of the hands over the period so that they do not compete for the core
+        if (hands.size() > 1) {
+            thread->setTickPhase(tickOrigin, h * graspPeriod / (1000.0 * hands.size()));
+        }
+        graspThreads.push_back(thread);
+    }
+    // Gaze thread: there is no head to move in simulation
+    if (rf.check("simulation", Value("off")).asString() != "on") {
+        gazeThread = new GazeThread(100, rf, &startupTimer);
+    }
+
+    // The threads open their drivers concurrently
+    bool parallel = (rf.findGroup("startup").check("parallel", Value("on")).asString() == "on");
+    std::vector<ThreadStarter *> graspStarters(graspThreads.size(), static_cast<ThreadStarter *>(NULL));
+    for (size_t h = 0; h < graspThreads.size(); ++h) {
+        graspStarters[h] = new ThreadStarter(graspThreads[h]);
+        graspStarters[h]->launch(parallel);
+    }
+    ThreadStarter gazeStarter(gazeThread);
+    if (gazeThread) {
+        gazeStarter.launch(parallel);
+    }
+
+    bool started = true;
+    for (size_t h = 0; h < graspThreads.size(); ++h) {
+        if (graspStarters[h]->wait()) {
+            graspThreads[h]->suspend();
+        } else {
+            cout << dbgTag << "Could not start the grasp thread of the " << hands[h] << " hand. \n";
+            started = false;
+        }
+        delete graspStarters[h];
+    }
+    if (gazeThread && !gazeStarter.wait()) {
         cout << dbgTag << "Could not start the gaze thread. \n";
-        return false;
+        started = false;
     }
-    // Grasp hread
-    graspThread = new GraspThread(20, rf);
-    if (!graspThread->start()) {
-        cout << dbgTag << "Could not start the grasp thread. \n";
+    if (!started) {
         return false;
     }
-    graspThread->suspend();
+
+    startupTimer.print(dbgTag);
     
     cout << dbgTag << "Started correctly. \n";
 
@@ -170,12 +217,38 @@ bool TactileGraspModule::close() {
     cout << dbgTag << "Closing. \n";
     
     // Stop threads
-    gazeThread->stop();
-    graspThread->stop();
+    if (gazeThread) {
+        gazeThread->stop();
+    }
+    for (size_t h = 0; h < graspThreads.size(); ++h) {
+        graspThreads[h]->stop();
+    }
+
+    for (size_t h = 0; h < graspThreads.size(); ++h) {
+        // Dump the contact-to-command latencies
+        Bottle latencies;
+        if (graspThreads[h]->getStopLatencies(latencies)) {
+            cout << dbgTag << "Contact-to-command latencies of the " << graspThreads[h]->getHand() << " hand (ms): \n";
+            for (int i = 0; i < latencies.size(); ++i) {
+                cout << dbgTag << "\t" << latencies.get(i).toString().c_str() << "\n";
+            }
+        }
+
+        // Dump the pose dispatch statistics
+        Bottle poseStats;
+        graspThreads[h]->getPoseStats(poseStats);
+        cout << dbgTag << "Pose dispatches of the " << graspThreads[h]->getHand() << " hand: \n";
+        for (int i = 0; i < poseStats.size(); ++i) {
+            cout << dbgTag << "\t" << poseStats.get(i).toString().c_str() << "\n";
+        }
+    }
 
     // Close ports
     portTactileGraspRPC.close();
 
+    // Write the last messages
+    AsyncLog::get().stop();
+
     cout << dbgTag << "Closed. \n";
     
     return true;
@@ -183,34 +256,177 @@ bool TactileGraspModule::close() {
 /* *********************************************************************************************************************** */
 
 
+/* *********************************************************************************************************************** */
+/* ******* Select the commanded hands                                       ********************************************** */
+bool TactileGraspModule::selectHands(const std::string &i_hand, std::vector<GraspThread *> &o_threads) {
+    o_threads.clear();
+    for (size_t h = 0; h < graspThreads.size(); ++h) {
+        if (i_hand.empty() || (i_hand == "both") || (i_hand == graspThreads[h]->getHand())) {
+            o_threads.push_back(graspThreads[h]);
+        }
+    }
+
+    if (o_threads.empty()) {
+        cerr << dbgTag << "The module is not grasping with the " << i_hand << " hand. \n";
+        return false;
+    }
+
+    return true;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Move the selected hands to a pose                                ********************************************** */
+int TactileGraspModule::moveHands(const std::string &i_pose, const std::string &i_hand) {
+    std::vector<GraspThread *> threads;
+    if (!selectHands(i_hand, threads)) {
+        return -1;
+    }
+
+    // Handle of the motion of each hand
+    int id = nextHandsMotion++;
+    HandsMotion &motion = handsMotions[id % handsMotions.size()];
+    motion.id = id;
+    motion.motions.assign(graspThreads.size(), -1);
+    bool ok = true;
+    for (size_t h = 0; h < graspThreads.size(); ++h) {
+        if (std::find(threads.begin(), threads.end(), graspThreads[h]) != threads.end()) {
+            graspThreads[h]->suspend();
+            motion.motions[h] = (i_pose == "open" ? graspThreads[h]->openHand() : graspThreads[h]->moveToPose(i_pose));
+            ok = ok && (motion.motions[h] >= 0);
+        }
+    }
+
+    return (ok ? id : -1);
+}
+/* *********************************************************************************************************************** */
+
+
 /* *********************************************************************************************************************** */
 /* ******* RPC Open hand                                                    ********************************************** */
-bool TactileGraspModule::open(void) {
-    graspThread->suspend();
+int TactileGraspModule::open(const std::string &hand) {
+    return moveHands("open", hand);
+}
+/* *********************************************************************************************************************** */
 
-    return graspThread->openHand();
+
+/* *********************************************************************************************************************** */
+/* ******* RPC Reach the grasping position                                  ********************************************** */
+int TactileGraspModule::reach(const std::string &hand) {
+    return moveHands("reach", hand);
 }
 /* *********************************************************************************************************************** */
 
 
 /* *********************************************************************************************************************** */
-/* ******* RPC Grasp object                                                 ********************************************** */
-bool TactileGraspModule::grasp(void) {
-    graspThread->setVelocities(GraspType::Grasp, velocities.grasp);
-    graspThread->setVelocities(GraspType::Stop, velocities.stop);       // Set velocity to stop upon contact detection
-    graspThread->resume();
+/* ******* RPC Move to a named pose                                         ********************************************** */
+int TactileGraspModule::pose(const std::string &name, const std::string &hand) {
+    return moveHands(name, hand);
+}
+/* *********************************************************************************************************************** */
 
-    return true;
+
+/* *********************************************************************************************************************** */
+/* ******* RPC Get the status of a motion                                   ********************************************** */
+std::string TactileGraspModule::motionStatus(const int id) {
+    if ((id < 0) || (handsMotions[id % handsMotions.size()].id != id)) {
+        return MotionStatus(MotionStatus::Unknown).toString();
+    }
+    const HandsMotion &motion = handsMotions[id % handsMotions.size()];
+
+    // Running while any hand is, done once all the hands are
+    MotionStatus::Status status = MotionStatus::Done;
+    for (size_t h = 0; h < graspThreads.size(); ++h) {
+        if (motion.motions[h] >= 0) {
+            MotionStatus::Status handStatus = graspThreads[h]->getMotionStatus(motion.motions[h]);
+            if (handStatus == MotionStatus::Running) {
+                status = MotionStatus::Running;
+            } else if ((handStatus != MotionStatus::Done) && (status == MotionStatus::Done)) {
+                status = handStatus;
+            }
+        }
+    }
+
+    return MotionStatus(status).toString();
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* RPC Wait for a motion                                            ********************************************** */
+bool TactileGraspModule::waitMotion(const int id, const double timeout) {
+    using yarp::os::Time;
+
+    if ((id < 0) || (handsMotions[id % handsMotions.size()].id != id)) {
+        return false;
+    }
+    const HandsMotion motion = handsMotions[id % handsMotions.size()];
+
+    double start = Time::now();
+    bool done = true;
+    for (size_t h = 0; h < graspThreads.size(); ++h) {
+        if (motion.motions[h] >= 0) {
+            double remaining = std::max(0.0, timeout - (Time::now() - start));
+            done = graspThreads[h]->waitMotion(motion.motions[h], remaining) && done;
+        }
+    }
+
+    return done;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* RPC Grasp object                                                 ********************************************** */
+bool TactileGraspModule::grasp(const std::string &hand) {
+    return startGrasp(hand, GraspType::Grasp);
 }
 /* *********************************************************************************************************************** */
 
 
 /* *********************************************************************************************************************** */
 /* ******* RPC Crush object                                                 ********************************************** */
-bool TactileGraspModule::crush(void) {
-    graspThread->setVelocities(GraspType::Grasp, velocities.grasp);
-    graspThread->setVelocities(GraspType::Stop, velocities.grasp);      // Set velocity to crush object
-    graspThread->resume();
+bool TactileGraspModule::crush(const std::string &hand) {
+    return startGrasp(hand, GraspType::Crush);
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* RPC Grasp object regulating the fingertip pressure               ********************************************** */
+bool TactileGraspModule::regulate(const std::string &hand) {
+    return startGrasp(hand, GraspType::Regulate);
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Start a grasp of the given type                                  ********************************************** */
+bool TactileGraspModule::startGrasp(const std::string &i_hand, const int &i_type) {
+    std::vector<GraspThread *> threads;
+    if (!selectHands(i_hand, threads)) {
+        return false;
+    }
+
+    // The hands reach the grasping position together
+    for (size_t h = 0; h < threads.size(); ++h) {
+        threads[h]->prepareGrasp(false);
+    }
+    for (size_t h = 0; h < threads.size(); ++h) {
+        if (!threads[h]->prepareGrasp()) {
+            return false;
+        }
+        // Stop upon contact detection, or keep going to crush the object. The regulator only uses the stop velocities while
+        // waiting for the palm.
+        const std::vector<double> &stopVelocities = ((i_type == GraspType::Crush) ? velocities.grasp : velocities.stop);
+        if (!threads[h]->configureGrasp(velocities.grasp, stopVelocities, i_type)) {
+            return false;
+        }
+    }
+    for (size_t h = 0; h < threads.size(); ++h) {
+        threads[h]->resume();
+    }
 
     return true;
 }
@@ -227,7 +443,178 @@ bool TactileGraspModule::quit(void) {
 
 /* *********************************************************************************************************************** */
 /* ******* Set touch threshold.                                             ********************************************** */
-bool TactileGraspModule::setThreshold(const int aFinger, const double aThreshold) {
-    return graspThread->setTouchThreshold(aFinger, aThreshold);
+bool TactileGraspModule::setThreshold(const int aFinger, const double aThreshold, const std::string &hand) {
+    std::vector<GraspThread *> threads;
+    if (!selectHands(hand, threads)) {
+        return false;
+    }
+
+    bool ok = true;
+    for (size_t h = 0; h < threads.size(); ++h) {
+        ok = threads[h]->setTouchThreshold(aFinger, aThreshold) && ok;
+    }
+
+    return ok;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Get the contact-to-command latencies.                            ********************************************** */
+Bottle TactileGraspModule::getLatencyStats(void) {
+    Bottle latencies;
+    if (graspThreads.size() == 1) {
+        graspThreads[0]->getStopLatencies(latencies);
+    } else {
+        for (size_t h = 0; h < graspThreads.size(); ++h) {
+            Bottle &hand = latencies.addList();
+            hand.addString(graspThreads[h]->getHand().c_str());
+            graspThreads[h]->getStopLatencies(hand.addList());
+        }
+    }
+
+    return latencies;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Reset the contact-to-command latencies.                          ********************************************** */
+bool TactileGraspModule::resetLatencyStats(void) {
+    for (size_t h = 0; h < graspThreads.size(); ++h) {
+        graspThreads[h]->resetStopLatencies();
+    }
+
+    return true;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Get the control loops timing statistics.                         ********************************************** */
+Bottle TactileGraspModule::getLoopStats(void) {
+    Bottle stats;
+
+    for (size_t h = 0; h < graspThreads.size(); ++h) {
+        Bottle &grasp = stats.addList();
+        grasp.addString(graspThreads.size() == 1 ? "grasp" : ("grasp_" + graspThreads[h]->getHand()).c_str());
+        graspThreads[h]->getLoopStats(grasp.addList());
+    }
+
+    if (gazeThread) {
+        Bottle &gaze = stats.addList();
+        gaze.addString("gaze");
+        gazeThread->getLoopStats(gaze.addList());
+    }
+
+    return stats;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Reset the control loops timing statistics.                       ********************************************** */
+bool TactileGraspModule::resetLoopStats(void) {
+    for (size_t h = 0; h < graspThreads.size(); ++h) {
+        graspThreads[h]->resetLoopStats();
+    }
+    if (gazeThread) {
+        gazeThread->resetLoopStats();
+    }
+
+    return true;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Get the pose dispatch statistics.                                ********************************************** */
+Bottle TactileGraspModule::getPoseStats(void) {
+    Bottle stats;
+    if (graspThreads.size() == 1) {
+        graspThreads[0]->getPoseStats(stats);
+    } else {
+        for (size_t h = 0; h < graspThreads.size(); ++h) {
+            Bottle &hand = stats.addList();
+            hand.addString(graspThreads[h]->getHand().c_str());
+            graspThreads[h]->getPoseStats(hand.addList());
+        }
+    }
+
+    return stats;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Reset the pose dispatch statistics.                              ********************************************** */
+bool TactileGraspModule::resetPoseStats(void) {
+    for (size_t h = 0; h < graspThreads.size(); ++h) {
+        graspThreads[h]->resetPoseStats();
+    }
+
+    return true;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Get the slip statistics.                                         ********************************************** */
+Bottle TactileGraspModule::getSlipStats(void) {
+    Bottle stats;
+    if (graspThreads.size() == 1) {
+        graspThreads[0]->getSlipStats(stats);
+    } else {
+        for (size_t h = 0; h < graspThreads.size(); ++h) {
+            Bottle &hand = stats.addList();
+            hand.addString(graspThreads[h]->getHand().c_str());
+            graspThreads[h]->getSlipStats(hand.addList());
+        }
+    }
+
+    return stats;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Reset the slip statistics.                                       ********************************************** */
+bool TactileGraspModule::resetSlipStats(void) {
+    for (size_t h = 0; h < graspThreads.size(); ++h) {
+        graspThreads[h]->resetSlipStats();
+    }
+
+    return true;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Get the contact forecast statistics.                             ********************************************** */
+Bottle TactileGraspModule::getPredictionStats(void) {
+    Bottle stats;
+    if (graspThreads.size() == 1) {
+        graspThreads[0]->getPredictionStats(stats);
+    } else {
+        for (size_t h = 0; h < graspThreads.size(); ++h) {
+            Bottle &hand = stats.addList();
+            hand.addString(graspThreads[h]->getHand().c_str());
+            graspThreads[h]->getPredictionStats(hand.addList());
+        }
+    }
+
+    return stats;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Reset the contact forecast statistics.                           ********************************************** */
+bool TactileGraspModule::resetPredictionStats(void) {
+    for (size_t h = 0; h < graspThreads.size(); ++h) {
+        graspThreads[h]->resetPredictionStats();
+    }
+
+    return true;
 }
 /* *********************************************************************************************************************** */
@@ -0,0 +1,198 @@
+/* 
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org 
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+#include "iCub/tactileGrasp/TaxelFilter.h"
+
+#include <algorithm>
+
+using iCub::tactileGrasp::TaxelFilter;
+
+
+/* *********************************************************************************************************************** */
+/* ******* Constructor                                                      ********************************************** */   
+TaxelFilter::TaxelFilter() {
+    type = None;
+    window = 1;
+    nTaxels = 0;
+    samples = 0;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Configure the filter                                             ********************************************** */   
+bool TaxelFilter::configure(const std::string &i_type, const int &i_window, const size_t &i_nTaxels) {
+    if (i_type == "none") {
+        type = None;
+    } else if (i_type == "average") {
+        type = Average;
+    } else if (i_type == "median") {
+        type = Median;
+    } else {
+        return false;
+    }
+    window = (type == None) ? 1 : std::max(1, i_window);
+    nTaxels = i_nTaxels;
+
+    if (type != None) {
+        history.assign(nTaxels*window, 0.0);
+        sorted.assign((type == Median) ? nTaxels*window : 0, 0.0);
+        sums.assign((type == Average) ? nTaxels : 0, 0.0);
+        stamps.assign(nTaxels, 0);
+        output.resize(nTaxels);
+    }
+    reset();
+
+    return true;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Reset the window                                                 ********************************************** */   
+void TaxelFilter::reset(void) {
+    samples = 0;
+    std::fill(stamps.begin(), stamps.end(), 0);
+    std::fill(sums.begin(), sums.end(), 0.0);
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Filter a skin sample                                             ********************************************** */   
+const yarp::sig::Vector &TaxelFilter::filter(const yarp::sig::Vector &i_taxels) {
+    if (type == None) {
+        return i_taxels;
+    }
+
+    for (size_t t = 0; t < nTaxels; ++t) {
+        filter(t, i_taxels[t]);
+    }
+    next();
+
+    return output;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Filter a single taxel                                            ********************************************** */   
+double TaxelFilter::filter(const size_t &i_taxel, const double &i_sample) {
+    if (type == None) {
+        return i_sample;
+    }
+
+    unsigned long &stamp = stamps[i_taxel];
+    if (stamp > samples) {
+        return output[i_taxel];
+    }
+
+    // Catch up with the samples the taxel missed: a whole window of zeros is written at once
+    if (samples - stamp >= static_cast<unsigned long>(window)) {
+        std::fill(history.begin() + i_taxel*window, history.begin() + (i_taxel + 1)*window, 0.0);
+        if (type == Median) {
+            std::fill(sorted.begin() + i_taxel*window, sorted.begin() + (i_taxel + 1)*window, 0.0);
+        } else {
+            sums[i_taxel] = 0.0;
+        }
+        stamp = samples;
+    }
+    for (; stamp < samples; ++stamp) {
+        push(i_taxel, 0.0, stamp);
+    }
+
+    stamp = samples + 1;
+    return push(i_taxel, i_sample, samples);
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Close the skin sample                                            ********************************************** */   
+void TaxelFilter::next(void) {
+    ++samples;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Add a sample to the window of a taxel                            ********************************************** */   
+double TaxelFilter::push(const size_t &i_taxel, const double &i_sample, const unsigned long &i_index) {
+    int head = static_cast<int>(i_index % window);
+    bool full = (i_index >= static_cast<unsigned long>(window));
+    int n = full ? window : head + 1;
+    double *ring = &history[i_taxel*window];
+    double oldest = ring[head];
+    ring[head] = i_sample;
+
+    if (type == Average) {
+        sums[i_taxel] += i_sample - (full ? oldest : 0.0);
+        output[i_taxel] = sums[i_taxel] / n;
+
+        // Drop the rounding errors accumulated by the running sum once per window
+        if (head == window - 1) {
+            double sum = 0.0;
+            for (int k = 0; k < window; ++k) {
+                sum += ring[k];
+            }
+            sums[i_taxel] = sum;
+        }
+    } else {
+        // Replace the oldest sample of the sorted window and move the new one to its place
+        double *window_t = &sorted[i_taxel*window];
+        int i = n - 1;
+        if (full) {
+            i = static_cast<int>(std::lower_bound(window_t, window_t + n, oldest) - window_t);
+        }
+        while ((i > 0) && (window_t[i - 1] > i_sample)) {
+            window_t[i] = window_t[i - 1];
+            --i;
+        }
+        while ((i < n - 1) && (window_t[i + 1] < i_sample)) {
+            window_t[i] = window_t[i + 1];
+            ++i;
+        }
+        window_t[i] = i_sample;
+        output[i_taxel] = (n % 2) ? window_t[n/2] : 0.5*(window_t[n/2 - 1] + window_t[n/2]);
+    }
+
+    return output[i_taxel];
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Accessors                                                        ********************************************** */   
+int TaxelFilter::getDelay(void) const {
+    // A step reaches the average after the whole window, the median after half of it
+    switch (type) {
+        case Average:   return window - 1;
+        case Median:    return window/2;
+        default:        return 0;
+    }
+}
+
+const char *TaxelFilter::getName(void) const {
+    switch (type) {
+        case Average:   return "average";
+        case Median:    return "median";
+        default:        return "none";
+    }
+}
+/* *********************************************************************************************************************** */
@@ -0,0 +1,249 @@
+/* 
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org 
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+/*
+ * Microbenchmarks of the grasp control hot path.
+ * Runs the contact detection, the taxel filters, the velocity assembly and the joint map generation of the grasp
+ * controller on synthetic skin frames, without ports nor devices, for several hand sizes and contact densities.
+ * Reports the time and the heap allocations per call. The allocations are only counted when the module is built with
+ * TACTILEGRASP_CHECK_ALLOCATIONS.
+ *
+ * Usage: tactileGrasp_bench [--iterations 100000] [--frames 16] [--seed 1]
+ */
+
+#include "iCub/tactileGrasp/GraspController.h"
+#include "iCub/tactileGrasp/TaxelFilter.h"
+#include "iCub/tactileGrasp/AllocationCounter.h"
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <algorithm>
+
+#include <yarp/os/Network.h>
+#include <yarp/os/Property.h>
+#include <yarp/os/ResourceFinder.h>
+#include <yarp/os/Time.h>
+#include <yarp/sig/Vector.h>
+
+using std::cerr;
+using std::cout;
+using std::string;
+using std::vector;
+
+using iCub::tactileGrasp::GraspController;
+using iCub::tactileGrasp::GraspVelocity;
+using iCub::tactileGrasp::GraspType;
+using iCub::tactileGrasp::TaxelFilter;
+using iCub::tactileGrasp::AllocationCounter;
+
+using yarp::os::ResourceFinder;
+using yarp::os::Property;
+using yarp::os::Value;
+using yarp::os::Time;
+
+
+namespace {
+    /** A synthetic hand. */
+    struct BenchHand {
+        const char *name;
+        int fingers;
+        int taxelsPerFinger;
+    };
+
+    /** Touch threshold of the synthetic fingertips. */
+    const double Threshold = 10.0;
+
+    /** The synthetic skin frames of a hand at a given contact density. */
+    struct BenchFrames {
+        vector<yarp::sig::Vector> skin;
+        /** The taxels above the threshold in each frame, as given by the skin contact list. */
+        vector<vector<unsigned int> > taxels;
+    };
+
+    /**
+     * Build skin frames where the given fraction of the taxels is above the touch threshold.
+     */
+    void makeFrames(const int &i_skinSize, const double &i_density, const int &i_frames, BenchFrames &o_frames) {
+        o_frames.skin.assign(i_frames, yarp::sig::Vector(i_skinSize, 0.0));
+        o_frames.taxels.assign(i_frames, vector<unsigned int>());
+        for (int f = 0; f < i_frames; ++f) {
+            for (int t = 0; t < i_skinSize; ++t) {
+                bool active = (std::rand() < i_density * RAND_MAX);
+                // Noise under the threshold, pressure above it
+                double value = active ? (Threshold + 50.0 * std::rand() / RAND_MAX) : (0.5 * Threshold * std::rand() / RAND_MAX);
+                o_frames.skin[f][t] = value;
+                if (active) {
+                    o_frames.taxels[f].push_back(t);
+                }
+            }
+        }
+    }
+
+    /**
+     * Configure a controller for a synthetic hand, from a configuration built in memory.
+     * Each finger moves two joints from joint 8.
+     */
+    bool configureController(const BenchHand &i_hand, const string &i_filter, GraspController &o_controller) {
+        std::ostringstream conf;
+        conf << "[velocity] \n";
+        conf << "grasp (";
+        for (int i = 0; i < 2*i_hand.fingers; ++i) {
+            conf << " 20";
+        }
+        conf << ") \n";
+        conf << "stop 0 \n";
+        conf << "jointOffset 8 \n";
+        conf << "[graspTh] \n";
+        conf << "touchThresholds (";
+        for (int i = 0; i < i_hand.fingers; ++i) {
+            conf << " " << Threshold;
+        }
+        conf << ") \n";
+        conf << "fingerJoints (";
+        for (int i = 0; i < i_hand.fingers; ++i) {
+            conf << " (" << 8 + 2*i << " " << 9 + 2*i << ")";
+        }
+        conf << ") \n";
+        conf << "taxelsPerFinger " << i_hand.taxelsPerFinger << " \n";
+        conf << "filter " << i_filter << " \n";
+        conf << "filterWindow 5 \n";
+
+        Property config;
+        config.fromConfig(conf.str().c_str());
+
+        GraspVelocity velocities;
+        return iCub::tactileGrasp::readGraspVelocities(config, velocities) && o_controller.configure(config)
+            && o_controller.setJointCount(8 + 2*i_hand.fingers)
+            && o_controller.setVelocities(GraspType::Grasp, velocities.grasp)
+            && o_controller.setVelocities(GraspType::Stop, velocities.stop);
+    }
+
+    /**
+     * Time a benchmark body and count its allocations.
+     *
+     * \param i_name The name of the benchmark
+     * \param i_hand The name of the hand
+     * \param i_density The contact density
+     * \param i_iterations The number of calls
+     * \param i_body The benchmark body, called with the iteration number
+     */
+    template<typename Body>
+    void run(const string &i_name, const string &i_hand, const double &i_density, const int &i_iterations, Body i_body) {
+        // Warm up the caches and the lazily grown buffers
+        for (int n = 0; n < std::min(1000, i_iterations); ++n) {
+            i_body(n);
+        }
+
+        AllocationCounter::start();
+        double start = Time::now();
+        for (int n = 0; n < i_iterations; ++n) {
+            i_body(n);
+        }
+        double elapsed = Time::now() - start;
+        unsigned long allocations = AllocationCounter::stop();
+
+        cout << std::setw(26) << std::left << i_name << std::setw(14) << i_hand << std::right << std::setw(8) << std::setprecision(2) << std::fixed << i_density
+            << std::setw(12) << std::setprecision(1) << 1e9 * elapsed / i_iterations << " ns";
+        if (AllocationCounter::isEnabled()) {
+            cout << std::setw(10) << std::setprecision(2) << static_cast<double>(allocations) / i_iterations << " allocs";
+        } else {
+            cout << std::setw(10) << "n/a" << " allocs";
+        }
+        cout << "\n";
+    }
+}
+
+
+int main(int argc, char * argv[])
+{
+    // The benchmark needs no name server
+    yarp::os::Network::setLocalMode(true);
+    yarp::os::Network yarp;
+
+    ResourceFinder rf;
+    rf.setVerbose(false);
+    rf.configure(argc, argv);
+    int iterations = std::max(1, rf.check("iterations", Value(100000)).asInt());
+    int nFrames = std::max(1, rf.check("frames", Value(16)).asInt());
+    std::srand(rf.check("seed", Value(1)).asInt());
+
+    const BenchHand hands[] = {
+        {"icub", 5, 12},
+        {"dense5x48", 5, 48},
+        {"dense10x48", 10, 48}
+    };
+    const double densities[] = {0.0, 0.1, 0.5, 1.0};
+    const char *filters[] = {"average", "median"};
+
+    cout << std::setw(26) << std::left << "benchmark" << std::setw(14) << "hand" << std::right << std::setw(8) << "density"
+        << std::setw(15) << "time/call" << std::setw(17) << "allocs/call \n";
+
+    for (size_t h = 0; h < sizeof(hands)/sizeof(hands[0]); ++h) {
+        const BenchHand &hand = hands[h];
+        GraspController controller;
+        if (!configureController(hand, "none", controller)) {
+            cerr << "Error: could not configure the " << hand.name << " hand. \n";
+            return -1;
+        }
+        GraspController filteredController;
+        if (!configureController(hand, "median", filteredController)) {
+            cerr << "Error: could not configure the filtered " << hand.name << " hand. \n";
+            return -1;
+        }
+        int skinSize = static_cast<int>(controller.getSkinSize());
+        int nJoints = 8 + 2*hand.fingers;
+
+        for (size_t d = 0; d < sizeof(densities)/sizeof(densities[0]); ++d) {
+            BenchFrames frames;
+            makeFrames(skinSize, densities[d], nFrames, frames);
+
+            run("detectContact", hand.name, densities[d], iterations, [&](int n) {
+                controller.detectContact(frames.skin[n % nFrames]);
+            });
+            run("detectContact median", hand.name, densities[d], iterations, [&](int n) {
+                filteredController.detectContact(frames.skin[n % nFrames]);
+            });
+            run("detectContactSparse", hand.name, densities[d], iterations, [&](int n) {
+                controller.detectContactSparse(frames.skin[n % nFrames], frames.taxels[n % nFrames]);
+            });
+            run("computeVelocities", hand.name, densities[d], iterations, [&](int n) {
+                controller.detectContact(frames.skin[n % nFrames]);
+                controller.computeVelocities(0.02 * n);
+            });
+            for (size_t f = 0; f < sizeof(filters)/sizeof(filters[0]); ++f) {
+                TaxelFilter filter;
+                filter.configure(filters[f], 5, skinSize);
+                run(string("filter ") + filters[f], hand.name, densities[d], iterations, [&](int n) {
+                    filter.filter(frames.skin[n % nFrames]);
+                });
+            }
+        }
+
+        // Rebuilding the joint map is not done by the control tick, so fewer iterations are enough
+        run("generateJointMap", hand.name, 0.0, std::max(1, iterations / 100), [&](int) {
+            controller.setJointCount(nJoints);
+        });
+    }
+
+    return 0;
+}
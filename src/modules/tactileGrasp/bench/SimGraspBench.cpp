@@ -0,0 +1,221 @@
+/* 
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org 
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+/*
+ * End-to-end grasp benchmark on the simulated hand.
+ * Runs the grasp thread against the fakeHandBoard device for a number of trials with randomised object positions and
+ * reports the time to contact, the threshold-crossing-to-stop latency, the time to rest and the overshoot after the contact.
+ * In the regulate mode the fingers stop once their pressure has settled on the target.
+ *
+ * Usage: tactileGrasp_simBench [--from confTactileGrasp.ini] [--trials 20] [--seed 1] [--trialTimeout 10] [--mode grasp|regulate]
+ */
+
+#include "iCub/tactileGrasp/GraspThread.h"
+#include "iCub/tactileGrasp/FakeHandBoard.h"
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+
+#include <yarp/os/Network.h>
+#include <yarp/os/ResourceFinder.h>
+#include <yarp/os/Bottle.h>
+#include <yarp/os/Time.h>
+
+using std::cerr;
+using std::cout;
+using std::string;
+using std::vector;
+
+using iCub::tactileGrasp::GraspThread;
+using iCub::tactileGrasp::GraspVelocity;
+using iCub::tactileGrasp::FakeHandBoard;
+using iCub::tactileGrasp::SimFingerEvents;
+
+using yarp::os::Network;
+using yarp::os::ResourceFinder;
+using yarp::os::Bottle;
+using yarp::os::Value;
+using yarp::os::Time;
+
+
+namespace {
+    /**
+     * Print the distribution of the given samples.
+     *
+     * \param i_name The name of the metric
+     * \param i_unit The unit of the samples
+     * \param io_samples The samples. They are sorted in place.
+     */
+    void printDistribution(const string &i_name, const string &i_unit, vector<double> &io_samples) {
+        cout << std::setw(24) << std::left << i_name << " ";
+        if (io_samples.empty()) {
+            cout << "no samples \n";
+            return;
+        }
+
+        std::sort(io_samples.begin(), io_samples.end());
+        const int percentiles[] = {50, 90, 99};
+        for (int i = 0; i < 3; ++i) {
+            size_t rank = static_cast<size_t>(percentiles[i] / 100.0 * (io_samples.size() - 1) + 0.5);
+            cout << "p" << percentiles[i] << " " << std::setw(8) << io_samples[rank] << " ";
+        }
+        cout << "max " << std::setw(8) << io_samples.back() << " " << i_unit << " (n = " << io_samples.size() << ") \n";
+    }
+}
+
+
+int main(int argc, char * argv[])
+{
+    /* ******* Simulated robot                                 ******* */
+    // The benchmark needs no name server
+    Network::setLocalMode(true);
+    Network yarp;
+    FakeHandBoard::registerDevice();
+
+    // Force the simulation: command line values take precedence over the configuration file
+    vector<char *> args(argv, argv + argc);
+    char simulationKey[] = "--simulation";
+    char simulationValue[] = "on";
+    args.push_back(simulationKey);
+    args.push_back(simulationValue);
+
+    ResourceFinder rf;
+    rf.setVerbose(true);
+    rf.setDefaultConfigFile("confTactileGrasp.ini");
+    rf.setDefaultContext("tactileGrasp");
+    rf.configure("ICUB_ROOT", static_cast<int>(args.size()), &args[0]);
+
+    int nTrials = rf.check("trials", Value(20)).asInt();
+    double trialTimeout = rf.check("trialTimeout", Value(10.0)).asDouble();
+    string mode = rf.check("mode", Value("grasp")).asString().c_str();
+    int graspType = (mode == "regulate") ? iCub::tactileGrasp::GraspType::Regulate : iCub::tactileGrasp::GraspType::Grasp;
+    std::srand(rf.check("seed", Value(1)).asInt());
+
+    // Object positions
+    Bottle &confSim = rf.findGroup("simulation");
+    Bottle *confAngles = confSim.find("contactAngles").asList();
+    double contactSpread = confSim.check("contactSpread", Value(0.0)).asDouble();
+    if (!confAngles) {
+        cerr << "Error: no contactAngles in the [simulation] group. \n";
+        return -1;
+    }
+
+    GraspVelocity velocities;
+    if (!iCub::tactileGrasp::readGraspVelocities(rf, velocities)) {
+        return -1;
+    }
+
+
+    /* ******* Grasp thread                                    ******* */
+    GraspThread graspThread(rf.check("graspPeriod", Value(20)).asInt(), rf);
+    if (!graspThread.start()) {
+        cerr << "Error: could not start the grasp thread. \n";
+        return -1;
+    }
+    graspThread.suspend();
+
+    FakeHandBoard *board = NULL;
+    graspThread.getArmDriver().view(board);
+    if (!board) {
+        cerr << "Error: the grasp thread is not driving the simulated hand. \n";
+        graspThread.stop();
+        return -1;
+    }
+    // Grasping position, as the module does before its first grasp
+    graspThread.prepareGrasp();
+
+
+    /* ******* Trials                                          ******* */
+    vector<double> timesToContact;
+    vector<double> stopLatencies;
+    vector<double> timesToRest;
+    vector<double> overshoots;
+    int nTimeouts = 0;
+
+    double motionTimeout = rf.findGroup("motion").check("timeout", Value(10.0)).asDouble();
+    for (int t = 0; t < nTrials; ++t) {
+        graspThread.waitMotion(graspThread.openHand(), motionTimeout);
+
+        // Randomise the object position
+        vector<double> contactAngles(confAngles->size());
+        for (int i = 0; i < confAngles->size(); ++i) {
+            contactAngles[i] = confAngles->get(i).asDouble();
+            if (contactAngles[i] >= 0) {
+                contactAngles[i] += contactSpread * (2.0 * std::rand() / RAND_MAX - 1.0);
+                contactAngles[i] = std::max(0.0, contactAngles[i]);
+            }
+        }
+        board->startTrial(contactAngles);
+
+        // Grasp
+        graspThread.configureGrasp(velocities.grasp, velocities.stop, graspType);
+        graspThread.resume();
+        double start = Time::now();
+        bool done = false;
+        while (!done && (Time::now() - start < trialTimeout)) {
+            Time::delay(0.01);
+            done = board->isTrialDone();
+        }
+        graspThread.suspend();
+
+        // Collect the results
+        vector<SimFingerEvents> events;
+        double trialStart = board->getTrialEvents(events);
+        if (!done || (trialStart < 0)) {
+            cerr << "Trial " << t << " timed out. \n";
+            ++nTimeouts;
+            continue;
+        }
+        for (size_t i = 0; i < events.size(); ++i) {
+            if ((contactAngles[i] >= 0) && (events[i].crossTime >= 0) && (events[i].stopTime >= 0)) {
+                timesToContact.push_back(1000.0 * (events[i].crossTime - trialStart));
+                stopLatencies.push_back(1000.0 * (events[i].stopTime - events[i].crossTime));
+                timesToRest.push_back(1000.0 * (events[i].stopTime - trialStart));
+                overshoots.push_back(events[i].restAngle - events[i].crossAngle);
+            }
+        }
+    }
+
+    graspThread.waitMotion(graspThread.openHand(), motionTimeout);
+    // Timing of the control loop, to compare the [realtime] settings
+    yarp::os::Bottle loopStats;
+    graspThread.getLoopStats(loopStats);
+    // Forecast errors, to tune the [prediction] settings against the overshoot
+    yarp::os::Bottle predictionStats;
+    graspThread.getPredictionStats(predictionStats);
+    graspThread.stop();
+
+
+    /* ******* Report                                          ******* */
+    cout << "\n";
+    cout << "Simulated " << mode << " benchmark: " << nTrials << " trials, " << nTimeouts << " timed out. \n";
+    cout << std::fixed << std::setprecision(2);
+    printDistribution("Time to contact", "ms", timesToContact);
+    printDistribution("Crossing to stop", "ms", stopLatencies);
+    printDistribution("Time to rest", "ms", timesToRest);
+    printDistribution("Overshoot", "deg", overshoots);
+    cout << "Control loop: " << loopStats.toString().c_str() << "\n";
+    cout << "Contact forecasts: " << predictionStats.toString().c_str() << "\n";
+
+    return (nTimeouts == 0) ? 0 : 1;
+}
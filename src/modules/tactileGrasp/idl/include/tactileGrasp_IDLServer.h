@@ -6,6 +6,7 @@
 
 #include <yarp/os/Wire.h>
 #include <yarp/os/idl/WireTypes.h>
+#include <yarp/os/Bottle.h>
 
 class tactileGrasp_IDLServer;
 
@@ -19,21 +20,64 @@ public:
   tactileGrasp_IDLServer() { yarp().setOwner(*this); }
 /**
  * Opens the robot hand.
- * @return true/false on success/failure
+ * The command returns as soon as the motion has started. Use motionStatus or waitMotion to follow it.
+ * @param hand left or right, empty or both for all the hands of the module.
+ * @return the handle of the motion, -1 on failure
  */
-  virtual bool open();
+  virtual int32_t open(const std::string& hand);
+/**
+ * Move the arm to the grasping position, i.e. the reach pose.
+ * Depending on the [startup] reach option this is otherwise done at startup or before the first grasp. The command returns as soon as the motion has started.
+ * @param hand left or right, empty or both for all the hands of the module.
+ * @return the handle of the motion, -1 on failure
+ */
+  virtual int32_t reach(const std::string& hand);
+/**
+ * Move the arm to a named pose of the [poses] configuration group.
+ * The joints are given synchronised reference speeds so that they arrive together. The command returns as soon as the motion has started.
+ * @param name the name of the pose.
+ * @param hand left or right, empty or both for all the hands of the module.
+ * @return the handle of the motion, -1 on failure
+ */
+  virtual int32_t pose(const std::string& name, const std::string& hand);
+/**
+ * Get the status of a motion.
+ * A motion of several hands is running until all of them are done.
+ * @param id the handle of the motion.
+ * @return one of running, done, timeout, preempted or unknown.
+ */
+  virtual std::string motionStatus(const int32_t id);
+/**
+ * Wait for a motion to end.
+ * @param id the handle of the motion.
+ * @param timeout the maximum waiting time in seconds.
+ * @return true if the motion is done, false if it failed or is still running.
+ */
+  virtual bool waitMotion(const int32_t id, const double timeout);
 /**
  * Grasp an object using feedback from the fingertips tactile sensors.
  * The grasping movement is stopped upon contact detection.
+ * If the arm is not in the grasping position yet, the command first waits for it to get there.
+ * @param hand left or right, empty or both for all the hands of the module.
  * @return true/false on success/failure.
  */
-  virtual bool grasp();
+  virtual bool grasp(const std::string& hand);
 /**
  * Grasp object without using the feedback from the fingertips tactile sensors.
  * The grasping movement is not controlled and the object is therefore crushed.
+ * If the arm is not in the grasping position yet, the command first waits for it to get there.
+ * @param hand left or right, empty or both for all the hands of the module.
+ * @return true/false on success/failure.
+ */
+  virtual bool crush(const std::string& hand);
+/**
+ * Grasp an object regulating the pressure of each fingertip to its target.
+ * The fingers approach fast, slow down as the pressure builds up and stop once the target is reached. See the [regulation] group.
+ * If the arm is not in the grasping position yet, the command first waits for it to get there.
+ * @param hand left or right, empty or both for all the hands of the module.
  * @return true/false on success/failure.
  */
-  virtual bool crush();
+  virtual bool regulate(const std::string& hand);
 /**
  * Quit the module.
  * @return true/false on success/failure.
@@ -41,9 +85,79 @@ public:
   virtual bool quit();
 /**
  * Set the touch threshold.
+ * The release threshold follows, keeping the configured difference between the touch and the release thresholds. A zero threshold disables the finger.
+ * @param hand left or right, empty or both for all the hands of the module.
+ * @return true/false on success/failure.
+ */
+  virtual bool setThreshold(const int32_t aFinger, const double aThreshold, const std::string& hand);
+/**
+ * Get the contact-to-command latency statistics of each finger.
+ * The latency is measured from the envelope timestamp of the compensated skin data to the velocity command reacting to the contact.
+ * It does not include the delay of the taxel filter and of the debounce, whose bound is given in skin samples by filterDelay.
+ * The switches are the changes of the contact state of the finger, which show the chattering of the contact decisions.
+ * With both hands, the lists of each hand are wrapped as (left (...)) (right (...)).
+ * @return a list per finger: (finger id) (count n) (mean ms) (p50 ms) (p99 ms) (max ms) (switches n) (filterDelay samples)
+ */
+  virtual yarp::os::Bottle getLatencyStats();
+/**
+ * Reset the contact-to-command latency statistics.
+ * @return true/false on success/failure.
+ */
+  virtual bool resetLatencyStats();
+/**
+ * Get the timing statistics of the grasp and gaze control loops since start or since the last reset.
+ * Times are in ms. Overruns are ticks whose run time exceeded the period, missed are ticks skipped because the thread started late.
+ * The grasp statistics also count the skin frames processed by the sparse and by the dense contact detection, and give the grasp phase and the number of phase changes of the adaptive control rate.
+ * They end with the scheduling in effect, see the [realtime] group: the policy, its priority, the CPU the thread is pinned to (-1 for none) and whether the memory is locked. With the event-driven control, they are those of the skin callback thread, applied on its first call.
+ * The gaze statistics also count the fixation points sent to the gaze controller and those suppressed by the deadband.
+ * With both hands, there is one grasp_left and one grasp_right entry instead of grasp.
+ * @return (grasp ((period ms) (estPeriod ms) (jitter ms) (used ms) (usedStd ms) (maxUsed ms) (iterations n) (overruns n) (missed n) (sparse n) (dense n) (phase name) (rateChanges n) (policy name) (priority n) (cpu n) (memoryLocked 0/1))) (gaze (... (sent n) (suppressed n)))
+ */
+  virtual yarp::os::Bottle getLoopStats();
+/**
+ * Reset the timing statistics of the grasp and gaze control loops.
+ * @return true/false on success/failure.
+ */
+  virtual bool resetLoopStats();
+/**
+ * Get the dispatch statistics of each pose.
+ * The calls are the control board calls made to send the pose. The time to pose goes from the dispatch to the end of the motion. Times are in ms.
+ * With both hands, the lists of each hand are wrapped as (left (...)) (right (...)).
+ * @return a list per pose: (pose name) (mode batched|perJoint) (dispatches n) (calls n) (dispatch ms) (dispatchMax ms) (reached n) (failed n) (timeToPose ms) (timeToPoseMax ms)
+ */
+  virtual yarp::os::Bottle getPoseStats();
+/**
+ * Reset the dispatch statistics of the poses.
+ * @return true/false on success/failure.
+ */
+  virtual bool resetPoseStats();
+/**
+ * Get the slip statistics of each finger, see the [slip] group.
+ * The count and the latencies are those of the tightening commands, measured from the envelope timestamp of the compensated skin data in which the slip was detected. Times are in ms.
+ * The detection cost is the time spent tracking the slips at each skin sample, in us.
+ * With both hands, the lists of each hand are wrapped as (left (...)) (right (...)).
+ * @return a list per finger: (finger id) (slips n) (count n) (mean ms) (p99 ms) (max ms), then (detection (mean us) (max us) (samples n))
+ */
+  virtual yarp::os::Bottle getSlipStats();
+/**
+ * Reset the slip statistics.
+ * @return true/false on success/failure.
+ */
+  virtual bool resetSlipStats();
+/**
+ * Get the statistics of the contact forecasts of each finger, see the [prediction] group.
+ * A confirmed forecast was followed by the crossing of the touch threshold while the finger was stopped, an expired one was released without crossing, to creep on to the contact at the [prediction] creepScale.
+ * The errors are the forecast minus the actual crossing times of the confirmed forecasts, positive if the crossing was forecast late. Times are in ms.
+ * The budget is the latency compensated by the forecasts, and the latency its calibrated skin-to-command part.
+ * With both hands, the lists of each hand are wrapped as (left (...)) (right (...)).
+ * @return a list per finger: (finger id) (predictions n) (confirmed n) (expired n) (meanError ms) (meanAbsError ms) (maxAbsError ms), then (budget ms) (latency ms)
+ */
+  virtual yarp::os::Bottle getPredictionStats();
+/**
+ * Reset the statistics of the contact forecasts.
  * @return true/false on success/failure.
  */
-  virtual bool setThreshold(const int32_t aFinger, const double aThreshold);
+  virtual bool resetPredictionStats();
   virtual bool read(yarp::os::ConnectionReader& connection);
   virtual std::vector<std::string> help(const std::string& functionName="--all");
 };
@@ -8,11 +8,105 @@
 
 class tactileGrasp_IDLServer_open : public yarp::os::Portable {
 public:
-  bool _return;
+  std::string hand;
+  int32_t _return;
   virtual bool write(yarp::os::ConnectionWriter& connection) {
     yarp::os::idl::WireWriter writer(connection);
-    if (!writer.writeListHeader(1)) return false;
+    if (!writer.writeListHeader(2)) return false;
     if (!writer.writeTag("open",1,1)) return false;
+    if (!writer.writeString(hand)) return false;
+    return true;
+  }
+  virtual bool read(yarp::os::ConnectionReader& connection) {
+    yarp::os::idl::WireReader reader(connection);
+    if (!reader.readListReturn()) return false;
+    if (!reader.readI32(_return)) {
+      reader.fail();
+      return false;
+    }
+    return true;
+  }
+};
+
+class tactileGrasp_IDLServer_reach : public yarp::os::Portable {
+public:
+  std::string hand;
+  int32_t _return;
+  virtual bool write(yarp::os::ConnectionWriter& connection) {
+    yarp::os::idl::WireWriter writer(connection);
+    if (!writer.writeListHeader(2)) return false;
+    if (!writer.writeTag("reach",1,1)) return false;
+    if (!writer.writeString(hand)) return false;
+    return true;
+  }
+  virtual bool read(yarp::os::ConnectionReader& connection) {
+    yarp::os::idl::WireReader reader(connection);
+    if (!reader.readListReturn()) return false;
+    if (!reader.readI32(_return)) {
+      reader.fail();
+      return false;
+    }
+    return true;
+  }
+};
+
+class tactileGrasp_IDLServer_pose : public yarp::os::Portable {
+public:
+  std::string name;
+  std::string hand;
+  int32_t _return;
+  virtual bool write(yarp::os::ConnectionWriter& connection) {
+    yarp::os::idl::WireWriter writer(connection);
+    if (!writer.writeListHeader(3)) return false;
+    if (!writer.writeTag("pose",1,1)) return false;
+    if (!writer.writeString(name)) return false;
+    if (!writer.writeString(hand)) return false;
+    return true;
+  }
+  virtual bool read(yarp::os::ConnectionReader& connection) {
+    yarp::os::idl::WireReader reader(connection);
+    if (!reader.readListReturn()) return false;
+    if (!reader.readI32(_return)) {
+      reader.fail();
+      return false;
+    }
+    return true;
+  }
+};
+
+class tactileGrasp_IDLServer_motionStatus : public yarp::os::Portable {
+public:
+  int32_t id;
+  std::string _return;
+  virtual bool write(yarp::os::ConnectionWriter& connection) {
+    yarp::os::idl::WireWriter writer(connection);
+    if (!writer.writeListHeader(2)) return false;
+    if (!writer.writeTag("motionStatus",1,1)) return false;
+    if (!writer.writeI32(id)) return false;
+    return true;
+  }
+  virtual bool read(yarp::os::ConnectionReader& connection) {
+    yarp::os::idl::WireReader reader(connection);
+    if (!reader.readListReturn()) return false;
+    if (!reader.readString(_return)) {
+      reader.fail();
+      return false;
+    }
+    return true;
+  }
+};
+
+class tactileGrasp_IDLServer_waitMotion : public yarp::os::Portable {
+public:
+  int32_t id;
+  double timeout;
+  bool _return;
+  virtual bool write(yarp::os::ConnectionWriter& connection) {
+    yarp::os::idl::WireWriter writer(connection);
+    if (!writer.writeListHeader(3)) return false;
+    if (!writer.writeTag("waitMotion",1,1)) return false;
+    if (!writer.writeI32(id)) return false;
+    if (!writer.writeDouble(timeout)) return false;
     return true;
   }
   virtual bool read(yarp::os::ConnectionReader& connection) {
@@ -28,11 +122,13 @@ public:
 
 class tactileGrasp_IDLServer_grasp : public yarp::os::Portable {
 public:
+  std::string hand;
   bool _return;
   virtual bool write(yarp::os::ConnectionWriter& connection) {
     yarp::os::idl::WireWriter writer(connection);
-    if (!writer.writeListHeader(1)) return false;
+    if (!writer.writeListHeader(2)) return false;
     if (!writer.writeTag("grasp",1,1)) return false;
+    if (!writer.writeString(hand)) return false;
     return true;
   }
   virtual bool read(yarp::os::ConnectionReader& connection) {
@@ -48,11 +144,35 @@ public:
 
 class tactileGrasp_IDLServer_crush : public yarp::os::Portable {
 public:
+  std::string hand;
   bool _return;
   virtual bool write(yarp::os::ConnectionWriter& connection) {
     yarp::os::idl::WireWriter writer(connection);
-    if (!writer.writeListHeader(1)) return false;
+    if (!writer.writeListHeader(2)) return false;
     if (!writer.writeTag("crush",1,1)) return false;
+    if (!writer.writeString(hand)) return false;
+    return true;
+  }
+  virtual bool read(yarp::os::ConnectionReader& connection) {
+    yarp::os::idl::WireReader reader(connection);
+    if (!reader.readListReturn()) return false;
+    if (!reader.readBool(_return)) {
+      reader.fail();
+      return false;
+    }
+    return true;
+  }
+};
+
+class tactileGrasp_IDLServer_regulate : public yarp::os::Portable {
+public:
+  std::string hand;
+  bool _return;
+  virtual bool write(yarp::os::ConnectionWriter& connection) {
+    yarp::os::idl::WireWriter writer(connection);
+    if (!writer.writeListHeader(2)) return false;
+    if (!writer.writeTag("regulate",1,1)) return false;
+    if (!writer.writeString(hand)) return false;
     return true;
   }
   virtual bool read(yarp::os::ConnectionReader& connection) {
@@ -90,13 +210,15 @@ class tactileGrasp_IDLServer_setThreshold : public yarp::os::Portable {
 public:
   int32_t aFinger;
   double aThreshold;
+  std::string hand;
   bool _return;
   virtual bool write(yarp::os::ConnectionWriter& connection) {
     yarp::os::idl::WireWriter writer(connection);
-    if (!writer.writeListHeader(3)) return false;
+    if (!writer.writeListHeader(4)) return false;
     if (!writer.writeTag("setThreshold",1,1)) return false;
     if (!writer.writeI32(aFinger)) return false;
     if (!writer.writeDouble(aThreshold)) return false;
+    if (!writer.writeString(hand)) return false;
     return true;
   }
   virtual bool read(yarp::os::ConnectionReader& connection) {
@@ -110,29 +232,284 @@ public:
   }
 };
 
-bool tactileGrasp_IDLServer::open() {
-  bool _return = false;
+class tactileGrasp_IDLServer_getLatencyStats : public yarp::os::Portable {
+public:
+  yarp::os::Bottle _return;
+  virtual bool write(yarp::os::ConnectionWriter& connection) {
+    yarp::os::idl::WireWriter writer(connection);
+    if (!writer.writeListHeader(1)) return false;
+    if (!writer.writeTag("getLatencyStats",1,1)) return false;
+    return true;
+  }
+  virtual bool read(yarp::os::ConnectionReader& connection) {
+    yarp::os::idl::WireReader reader(connection);
+    if (!reader.readListReturn()) return false;
+    if (!reader.read(_return)) {
+      reader.fail();
+      return false;
+    }
+    return true;
+  }
+};
+
+class tactileGrasp_IDLServer_resetLatencyStats : public yarp::os::Portable {
+public:
+  bool _return;
+  virtual bool write(yarp::os::ConnectionWriter& connection) {
+    yarp::os::idl::WireWriter writer(connection);
+    if (!writer.writeListHeader(1)) return false;
+    if (!writer.writeTag("resetLatencyStats",1,1)) return false;
+    return true;
+  }
+  virtual bool read(yarp::os::ConnectionReader& connection) {
+    yarp::os::idl::WireReader reader(connection);
+    if (!reader.readListReturn()) return false;
+    if (!reader.readBool(_return)) {
+      reader.fail();
+      return false;
+    }
+    return true;
+  }
+};
+
+class tactileGrasp_IDLServer_getLoopStats : public yarp::os::Portable {
+public:
+  yarp::os::Bottle _return;
+  virtual bool write(yarp::os::ConnectionWriter& connection) {
+    yarp::os::idl::WireWriter writer(connection);
+    if (!writer.writeListHeader(1)) return false;
+    if (!writer.writeTag("getLoopStats",1,1)) return false;
+    return true;
+  }
+  virtual bool read(yarp::os::ConnectionReader& connection) {
+    yarp::os::idl::WireReader reader(connection);
+    if (!reader.readListReturn()) return false;
+    if (!reader.read(_return)) {
+      reader.fail();
+      return false;
+    }
+    return true;
+  }
+};
+
+class tactileGrasp_IDLServer_resetLoopStats : public yarp::os::Portable {
+public:
+  bool _return;
+  virtual bool write(yarp::os::ConnectionWriter& connection) {
+    yarp::os::idl::WireWriter writer(connection);
+    if (!writer.writeListHeader(1)) return false;
+    if (!writer.writeTag("resetLoopStats",1,1)) return false;
+    return true;
+  }
+  virtual bool read(yarp::os::ConnectionReader& connection) {
+    yarp::os::idl::WireReader reader(connection);
+    if (!reader.readListReturn()) return false;
+    if (!reader.readBool(_return)) {
+      reader.fail();
+      return false;
+    }
+    return true;
+  }
+};
+
+class tactileGrasp_IDLServer_getPoseStats : public yarp::os::Portable {
+public:
+  yarp::os::Bottle _return;
+  virtual bool write(yarp::os::ConnectionWriter& connection) {
+    yarp::os::idl::WireWriter writer(connection);
+    if (!writer.writeListHeader(1)) return false;
+    if (!writer.writeTag("getPoseStats",1,1)) return false;
+    return true;
+  }
+  virtual bool read(yarp::os::ConnectionReader& connection) {
+    yarp::os::idl::WireReader reader(connection);
+    if (!reader.readListReturn()) return false;
+    if (!reader.read(_return)) {
+      reader.fail();
+      return false;
+    }
+    return true;
+  }
+};
+
+class tactileGrasp_IDLServer_resetPoseStats : public yarp::os::Portable {
+public:
+  bool _return;
+  virtual bool write(yarp::os::ConnectionWriter& connection) {
+    yarp::os::idl::WireWriter writer(connection);
+    if (!writer.writeListHeader(1)) return false;
+    if (!writer.writeTag("resetPoseStats",1,1)) return false;
+    return true;
+  }
+  virtual bool read(yarp::os::ConnectionReader& connection) {
+    yarp::os::idl::WireReader reader(connection);
+    if (!reader.readListReturn()) return false;
+    if (!reader.readBool(_return)) {
+      reader.fail();
+      return false;
+    }
+    return true;
+  }
+};
+
+class tactileGrasp_IDLServer_getSlipStats : public yarp::os::Portable {
+public:
+  yarp::os::Bottle _return;
+  virtual bool write(yarp::os::ConnectionWriter& connection) {
+    yarp::os::idl::WireWriter writer(connection);
+    if (!writer.writeListHeader(1)) return false;
+    if (!writer.writeTag("getSlipStats",1,1)) return false;
+    return true;
+  }
+  virtual bool read(yarp::os::ConnectionReader& connection) {
+    yarp::os::idl::WireReader reader(connection);
+    if (!reader.readListReturn()) return false;
+    if (!reader.read(_return)) {
+      reader.fail();
+      return false;
+    }
+    return true;
+  }
+};
+
+class tactileGrasp_IDLServer_resetSlipStats : public yarp::os::Portable {
+public:
+  bool _return;
+  virtual bool write(yarp::os::ConnectionWriter& connection) {
+    yarp::os::idl::WireWriter writer(connection);
+    if (!writer.writeListHeader(1)) return false;
+    if (!writer.writeTag("resetSlipStats",1,1)) return false;
+    return true;
+  }
+  virtual bool read(yarp::os::ConnectionReader& connection) {
+    yarp::os::idl::WireReader reader(connection);
+    if (!reader.readListReturn()) return false;
+    if (!reader.readBool(_return)) {
+      reader.fail();
+      return false;
+    }
+    return true;
+  }
+};
+
+class tactileGrasp_IDLServer_getPredictionStats : public yarp::os::Portable {
+public:
+  yarp::os::Bottle _return;
+  virtual bool write(yarp::os::ConnectionWriter& connection) {
+    yarp::os::idl::WireWriter writer(connection);
+    if (!writer.writeListHeader(1)) return false;
+    if (!writer.writeTag("getPredictionStats",1,1)) return false;
+    return true;
+  }
+  virtual bool read(yarp::os::ConnectionReader& connection) {
+    yarp::os::idl::WireReader reader(connection);
+    if (!reader.readListReturn()) return false;
+    if (!reader.read(_return)) {
+      reader.fail();
+      return false;
+    }
+    return true;
+  }
+};
+
+class tactileGrasp_IDLServer_resetPredictionStats : public yarp::os::Portable {
+public:
+  bool _return;
+  virtual bool write(yarp::os::ConnectionWriter& connection) {
+    yarp::os::idl::WireWriter writer(connection);
+    if (!writer.writeListHeader(1)) return false;
+    if (!writer.writeTag("resetPredictionStats",1,1)) return false;
+    return true;
+  }
+  virtual bool read(yarp::os::ConnectionReader& connection) {
+    yarp::os::idl::WireReader reader(connection);
+    if (!reader.readListReturn()) return false;
+    if (!reader.readBool(_return)) {
+      reader.fail();
+      return false;
+    }
+    return true;
+  }
+};
+
+int32_t tactileGrasp_IDLServer::open(const std::string& hand) {
+  int32_t _return = 0;
   tactileGrasp_IDLServer_open helper;
+  helper.hand = hand;
+  if (!yarp().canWrite()) {
+    fprintf(stderr,"Missing server method '%s'?\n","int32_t tactileGrasp_IDLServer::open(const std::string& hand)");
+  }
+  bool ok = yarp().write(helper,helper);
+  return ok?helper._return:_return;
+}
+int32_t tactileGrasp_IDLServer::reach(const std::string& hand) {
+  int32_t _return = 0;
+  tactileGrasp_IDLServer_reach helper;
+  helper.hand = hand;
   if (!yarp().canWrite()) {
-    fprintf(stderr,"Missing server method '%s'?\n","bool tactileGrasp_IDLServer::open()");
+    fprintf(stderr,"Missing server method '%s'?\n","int32_t tactileGrasp_IDLServer::reach(const std::string& hand)");
   }
   bool ok = yarp().write(helper,helper);
   return ok?helper._return:_return;
 }
-bool tactileGrasp_IDLServer::grasp() {
+int32_t tactileGrasp_IDLServer::pose(const std::string& name, const std::string& hand) {
+  int32_t _return = 0;
+  tactileGrasp_IDLServer_pose helper;
+  helper.name = name;
+  helper.hand = hand;
+  if (!yarp().canWrite()) {
+    fprintf(stderr,"Missing server method '%s'?\n","int32_t tactileGrasp_IDLServer::pose(const std::string& name, const std::string& hand)");
+  }
+  bool ok = yarp().write(helper,helper);
+  return ok?helper._return:_return;
+}
+std::string tactileGrasp_IDLServer::motionStatus(const int32_t id) {
+  std::string _return;
+  tactileGrasp_IDLServer_motionStatus helper;
+  helper.id = id;
+  if (!yarp().canWrite()) {
+    fprintf(stderr,"Missing server method '%s'?\n","std::string tactileGrasp_IDLServer::motionStatus(const int32_t id)");
+  }
+  bool ok = yarp().write(helper,helper);
+  return ok?helper._return:_return;
+}
+bool tactileGrasp_IDLServer::waitMotion(const int32_t id, const double timeout) {
+  bool _return = false;
+  tactileGrasp_IDLServer_waitMotion helper;
+  helper.id = id;
+  helper.timeout = timeout;
+  if (!yarp().canWrite()) {
+    fprintf(stderr,"Missing server method '%s'?\n","bool tactileGrasp_IDLServer::waitMotion(const int32_t id, const double timeout)");
+  }
+  bool ok = yarp().write(helper,helper);
+  return ok?helper._return:_return;
+}
+bool tactileGrasp_IDLServer::grasp(const std::string& hand) {
   bool _return = false;
   tactileGrasp_IDLServer_grasp helper;
+  helper.hand = hand;
   if (!yarp().canWrite()) {
-    fprintf(stderr,"Missing server method '%s'?\n","bool tactileGrasp_IDLServer::grasp()");
+    fprintf(stderr,"Missing server method '%s'?\n","bool tactileGrasp_IDLServer::grasp(const std::string& hand)");
   }
   bool ok = yarp().write(helper,helper);
   return ok?helper._return:_return;
 }
-bool tactileGrasp_IDLServer::crush() {
+bool tactileGrasp_IDLServer::crush(const std::string& hand) {
   bool _return = false;
   tactileGrasp_IDLServer_crush helper;
+  helper.hand = hand;
+  if (!yarp().canWrite()) {
+    fprintf(stderr,"Missing server method '%s'?\n","bool tactileGrasp_IDLServer::crush(const std::string& hand)");
+  }
+  bool ok = yarp().write(helper,helper);
+  return ok?helper._return:_return;
+}
+bool tactileGrasp_IDLServer::regulate(const std::string& hand) {
+  bool _return = false;
+  tactileGrasp_IDLServer_regulate helper;
+  helper.hand = hand;
   if (!yarp().canWrite()) {
-    fprintf(stderr,"Missing server method '%s'?\n","bool tactileGrasp_IDLServer::crush()");
+    fprintf(stderr,"Missing server method '%s'?\n","bool tactileGrasp_IDLServer::regulate(const std::string& hand)");
   }
   bool ok = yarp().write(helper,helper);
   return ok?helper._return:_return;
@@ -146,13 +523,104 @@ bool tactileGrasp_IDLServer::quit() {
   bool ok = yarp().write(helper,helper);
   return ok?helper._return:_return;
 }
-bool tactileGrasp_IDLServer::setThreshold(const int32_t aFinger, const double aThreshold) {
+bool tactileGrasp_IDLServer::setThreshold(const int32_t aFinger, const double aThreshold, const std::string& hand) {
   bool _return = false;
   tactileGrasp_IDLServer_setThreshold helper;
   helper.aFinger = aFinger;
   helper.aThreshold = aThreshold;
+  helper.hand = hand;
+  if (!yarp().canWrite()) {
+    fprintf(stderr,"Missing server method '%s'?\n","bool tactileGrasp_IDLServer::setThreshold(const int32_t aFinger, const double aThreshold, const std::string& hand)");
+  }
+  bool ok = yarp().write(helper,helper);
+  return ok?helper._return:_return;
+}
+yarp::os::Bottle tactileGrasp_IDLServer::getLatencyStats() {
+  yarp::os::Bottle _return;
+  tactileGrasp_IDLServer_getLatencyStats helper;
+  if (!yarp().canWrite()) {
+    fprintf(stderr,"Missing server method '%s'?\n","yarp::os::Bottle tactileGrasp_IDLServer::getLatencyStats()");
+  }
+  bool ok = yarp().write(helper,helper);
+  return ok?helper._return:_return;
+}
+bool tactileGrasp_IDLServer::resetLatencyStats() {
+  bool _return = false;
+  tactileGrasp_IDLServer_resetLatencyStats helper;
   if (!yarp().canWrite()) {
-    fprintf(stderr,"Missing server method '%s'?\n","bool tactileGrasp_IDLServer::setThreshold(const int32_t aFinger, const double aThreshold)");
+    fprintf(stderr,"Missing server method '%s'?\n","bool tactileGrasp_IDLServer::resetLatencyStats()");
+  }
+  bool ok = yarp().write(helper,helper);
+  return ok?helper._return:_return;
+}
+yarp::os::Bottle tactileGrasp_IDLServer::getLoopStats() {
+  yarp::os::Bottle _return;
+  tactileGrasp_IDLServer_getLoopStats helper;
+  if (!yarp().canWrite()) {
+    fprintf(stderr,"Missing server method '%s'?\n","yarp::os::Bottle tactileGrasp_IDLServer::getLoopStats()");
+  }
+  bool ok = yarp().write(helper,helper);
+  return ok?helper._return:_return;
+}
+bool tactileGrasp_IDLServer::resetLoopStats() {
+  bool _return = false;
+  tactileGrasp_IDLServer_resetLoopStats helper;
+  if (!yarp().canWrite()) {
+    fprintf(stderr,"Missing server method '%s'?\n","bool tactileGrasp_IDLServer::resetLoopStats()");
+  }
+  bool ok = yarp().write(helper,helper);
+  return ok?helper._return:_return;
+}
+yarp::os::Bottle tactileGrasp_IDLServer::getPoseStats() {
+  yarp::os::Bottle _return;
+  tactileGrasp_IDLServer_getPoseStats helper;
+  if (!yarp().canWrite()) {
+    fprintf(stderr,"Missing server method '%s'?\n","yarp::os::Bottle tactileGrasp_IDLServer::getPoseStats()");
+  }
+  bool ok = yarp().write(helper,helper);
+  return ok?helper._return:_return;
+}
+bool tactileGrasp_IDLServer::resetPoseStats() {
+  bool _return = false;
+  tactileGrasp_IDLServer_resetPoseStats helper;
+  if (!yarp().canWrite()) {
+    fprintf(stderr,"Missing server method '%s'?\n","bool tactileGrasp_IDLServer::resetPoseStats()");
+  }
+  bool ok = yarp().write(helper,helper);
+  return ok?helper._return:_return;
+}
+yarp::os::Bottle tactileGrasp_IDLServer::getSlipStats() {
+  yarp::os::Bottle _return;
+  tactileGrasp_IDLServer_getSlipStats helper;
+  if (!yarp().canWrite()) {
+    fprintf(stderr,"Missing server method '%s'?\n","yarp::os::Bottle tactileGrasp_IDLServer::getSlipStats()");
+  }
+  bool ok = yarp().write(helper,helper);
+  return ok?helper._return:_return;
+}
+bool tactileGrasp_IDLServer::resetSlipStats() {
+  bool _return = false;
+  tactileGrasp_IDLServer_resetSlipStats helper;
+  if (!yarp().canWrite()) {
+    fprintf(stderr,"Missing server method '%s'?\n","bool tactileGrasp_IDLServer::resetSlipStats()");
+  }
+  bool ok = yarp().write(helper,helper);
+  return ok?helper._return:_return;
+}
+yarp::os::Bottle tactileGrasp_IDLServer::getPredictionStats() {
+  yarp::os::Bottle _return;
+  tactileGrasp_IDLServer_getPredictionStats helper;
+  if (!yarp().canWrite()) {
+    fprintf(stderr,"Missing server method '%s'?\n","yarp::os::Bottle tactileGrasp_IDLServer::getPredictionStats()");
+  }
+  bool ok = yarp().write(helper,helper);
+  return ok?helper._return:_return;
+}
+bool tactileGrasp_IDLServer::resetPredictionStats() {
+  bool _return = false;
+  tactileGrasp_IDLServer_resetPredictionStats helper;
+  if (!yarp().canWrite()) {
+    fprintf(stderr,"Missing server method '%s'?\n","bool tactileGrasp_IDLServer::resetPredictionStats()");
   }
   bool ok = yarp().write(helper,helper);
   return ok?helper._return:_return;
@@ -166,8 +634,83 @@ bool tactileGrasp_IDLServer::read(yarp::os::ConnectionReader& connection) {
   while (!reader.isError()) {
     // TODO: use quick lookup, this is just a test
     if (tag == "open") {
+      std::string hand;
+      if (!reader.readString(hand)) {
+        hand = "";
+      }
+      int32_t _return;
+      _return = open(hand);
+      yarp::os::idl::WireWriter writer(reader);
+      if (!writer.isNull()) {
+        if (!writer.writeListHeader(1)) return false;
+        if (!writer.writeI32(_return)) return false;
+      }
+      reader.accept();
+      return true;
+    }
+    if (tag == "reach") {
+      std::string hand;
+      if (!reader.readString(hand)) {
+        hand = "";
+      }
+      int32_t _return;
+      _return = reach(hand);
+      yarp::os::idl::WireWriter writer(reader);
+      if (!writer.isNull()) {
+        if (!writer.writeListHeader(1)) return false;
+        if (!writer.writeI32(_return)) return false;
+      }
+      reader.accept();
+      return true;
+    }
+    if (tag == "pose") {
+      std::string name;
+      std::string hand;
+      if (!reader.readString(name)) {
+        reader.fail();
+        return false;
+      }
+      if (!reader.readString(hand)) {
+        hand = "";
+      }
+      int32_t _return;
+      _return = pose(name,hand);
+      yarp::os::idl::WireWriter writer(reader);
+      if (!writer.isNull()) {
+        if (!writer.writeListHeader(1)) return false;
+        if (!writer.writeI32(_return)) return false;
+      }
+      reader.accept();
+      return true;
+    }
+    if (tag == "motionStatus") {
+      int32_t id;
+      if (!reader.readI32(id)) {
+        reader.fail();
+        return false;
+      }
+      std::string _return;
+      _return = motionStatus(id);
+      yarp::os::idl::WireWriter writer(reader);
+      if (!writer.isNull()) {
+        if (!writer.writeListHeader(1)) return false;
+        if (!writer.writeString(_return)) return false;
+      }
+      reader.accept();
+      return true;
+    }
+    if (tag == "waitMotion") {
+      int32_t id;
+      double timeout;
+      if (!reader.readI32(id)) {
+        reader.fail();
+        return false;
+      }
+      if (!reader.readDouble(timeout)) {
+        timeout = 10.0;
+      }
       bool _return;
-      _return = open();
+      _return = waitMotion(id,timeout);
       yarp::os::idl::WireWriter writer(reader);
       if (!writer.isNull()) {
         if (!writer.writeListHeader(1)) return false;
@@ -177,8 +720,12 @@ bool tactileGrasp_IDLServer::read(yarp::os::ConnectionReader& connection) {
       return true;
     }
     if (tag == "grasp") {
+      std::string hand;
+      if (!reader.readString(hand)) {
+        hand = "";
+      }
       bool _return;
-      _return = grasp();
+      _return = grasp(hand);
       yarp::os::idl::WireWriter writer(reader);
       if (!writer.isNull()) {
         if (!writer.writeListHeader(1)) return false;
@@ -188,8 +735,27 @@ bool tactileGrasp_IDLServer::read(yarp::os::ConnectionReader& connection) {
       return true;
     }
     if (tag == "crush") {
+      std::string hand;
+      if (!reader.readString(hand)) {
+        hand = "";
+      }
       bool _return;
-      _return = crush();
+      _return = crush(hand);
+      yarp::os::idl::WireWriter writer(reader);
+      if (!writer.isNull()) {
+        if (!writer.writeListHeader(1)) return false;
+        if (!writer.writeBool(_return)) return false;
+      }
+      reader.accept();
+      return true;
+    }
+    if (tag == "regulate") {
+      std::string hand;
+      if (!reader.readString(hand)) {
+        hand = "";
+      }
+      bool _return;
+      _return = regulate(hand);
       yarp::os::idl::WireWriter writer(reader);
       if (!writer.isNull()) {
         if (!writer.writeListHeader(1)) return false;
@@ -212,6 +778,7 @@ bool tactileGrasp_IDLServer::read(yarp::os::ConnectionReader& connection) {
     if (tag == "setThreshold") {
       int32_t aFinger;
       double aThreshold;
+      std::string hand;
       if (!reader.readI32(aFinger)) {
         reader.fail();
         return false;
@@ -220,8 +787,121 @@ bool tactileGrasp_IDLServer::read(yarp::os::ConnectionReader& connection) {
         reader.fail();
         return false;
       }
+      if (!reader.readString(hand)) {
+        hand = "";
+      }
+      bool _return;
+      _return = setThreshold(aFinger,aThreshold,hand);
+      yarp::os::idl::WireWriter writer(reader);
+      if (!writer.isNull()) {
+        if (!writer.writeListHeader(1)) return false;
+        if (!writer.writeBool(_return)) return false;
+      }
+      reader.accept();
+      return true;
+    }
+    if (tag == "getLatencyStats") {
+      yarp::os::Bottle _return;
+      _return = getLatencyStats();
+      yarp::os::idl::WireWriter writer(reader);
+      if (!writer.isNull()) {
+        if (!writer.writeListHeader(1)) return false;
+        if (!writer.write(_return)) return false;
+      }
+      reader.accept();
+      return true;
+    }
+    if (tag == "resetLatencyStats") {
       bool _return;
-      _return = setThreshold(aFinger,aThreshold);
+      _return = resetLatencyStats();
+      yarp::os::idl::WireWriter writer(reader);
+      if (!writer.isNull()) {
+        if (!writer.writeListHeader(1)) return false;
+        if (!writer.writeBool(_return)) return false;
+      }
+      reader.accept();
+      return true;
+    }
+    if (tag == "getLoopStats") {
+      yarp::os::Bottle _return;
+      _return = getLoopStats();
+      yarp::os::idl::WireWriter writer(reader);
+      if (!writer.isNull()) {
+        if (!writer.writeListHeader(1)) return false;
+        if (!writer.write(_return)) return false;
+      }
+      reader.accept();
+      return true;
+    }
+    if (tag == "resetLoopStats") {
+      bool _return;
+      _return = resetLoopStats();
+      yarp::os::idl::WireWriter writer(reader);
+      if (!writer.isNull()) {
+        if (!writer.writeListHeader(1)) return false;
+        if (!writer.writeBool(_return)) return false;
+      }
+      reader.accept();
+      return true;
+    }
+    if (tag == "getPoseStats") {
+      yarp::os::Bottle _return;
+      _return = getPoseStats();
+      yarp::os::idl::WireWriter writer(reader);
+      if (!writer.isNull()) {
+        if (!writer.writeListHeader(1)) return false;
+        if (!writer.write(_return)) return false;
+      }
+      reader.accept();
+      return true;
+    }
+    if (tag == "resetPoseStats") {
+      bool _return;
+      _return = resetPoseStats();
+      yarp::os::idl::WireWriter writer(reader);
+      if (!writer.isNull()) {
+        if (!writer.writeListHeader(1)) return false;
+        if (!writer.writeBool(_return)) return false;
+      }
+      reader.accept();
+      return true;
+    }
+    if (tag == "getSlipStats") {
+      yarp::os::Bottle _return;
+      _return = getSlipStats();
+      yarp::os::idl::WireWriter writer(reader);
+      if (!writer.isNull()) {
+        if (!writer.writeListHeader(1)) return false;
+        if (!writer.write(_return)) return false;
+      }
+      reader.accept();
+      return true;
+    }
+    if (tag == "resetSlipStats") {
+      bool _return;
+      _return = resetSlipStats();
+      yarp::os::idl::WireWriter writer(reader);
+      if (!writer.isNull()) {
+        if (!writer.writeListHeader(1)) return false;
+        if (!writer.writeBool(_return)) return false;
+      }
+      reader.accept();
+      return true;
+    }
+    if (tag == "getPredictionStats") {
+      yarp::os::Bottle _return;
+      _return = getPredictionStats();
+      yarp::os::idl::WireWriter writer(reader);
+      if (!writer.isNull()) {
+        if (!writer.writeListHeader(1)) return false;
+        if (!writer.write(_return)) return false;
+      }
+      reader.accept();
+      return true;
+    }
+    if (tag == "resetPredictionStats") {
+      bool _return;
+      _return = resetPredictionStats();
       yarp::os::idl::WireWriter writer(reader);
       if (!writer.isNull()) {
         if (!writer.writeListHeader(1)) return false;
@@ -265,28 +945,86 @@ std::vector<std::string> tactileGrasp_IDLServer::help(const std::string& functio
   if(showAll) {
     helpString.push_back("*** Available commands:");
     helpString.push_back("open");
+    helpString.push_back("reach");
+    helpString.push_back("pose");
+    helpString.push_back("motionStatus");
+    helpString.push_back("waitMotion");
     helpString.push_back("grasp");
     helpString.push_back("crush");
+    helpString.push_back("regulate");
     helpString.push_back("quit");
     helpString.push_back("setThreshold");
+    helpString.push_back("getLatencyStats");
+    helpString.push_back("resetLatencyStats");
+    helpString.push_back("getLoopStats");
+    helpString.push_back("resetLoopStats");
+    helpString.push_back("getPoseStats");
+    helpString.push_back("resetPoseStats");
+    helpString.push_back("getSlipStats");
+    helpString.push_back("resetSlipStats");
+    helpString.push_back("getPredictionStats");
+    helpString.push_back("resetPredictionStats");
     helpString.push_back("help");
   }
   else {
     if (functionName=="open") {
-      helpString.push_back("bool open() ");
+      helpString.push_back("int32_t open(const std::string& hand) ");
       helpString.push_back("Opens the robot hand. ");
-      helpString.push_back("@return true/false on success/failure ");
+      helpString.push_back("The command returns as soon as the motion has started. Use motionStatus or waitMotion to follow it. ");
+      helpString.push_back("@param hand left or right, empty or both for all the hands of the module. ");
+      helpString.push_back("@return the handle of the motion, -1 on failure ");
+    }
+    if (functionName=="reach") {
+      helpString.push_back("int32_t reach(const std::string& hand) ");
+      helpString.push_back("Move the arm to the grasping position, i.e. the reach pose. ");
+      helpString.push_back("Depending on the [startup] reach option this is otherwise done at startup or before the first grasp. The command returns as soon as the motion has started. ");
+      helpString.push_back("@param hand left or right, empty or both for all the hands of the module. ");
+      helpString.push_back("@return the handle of the motion, -1 on failure ");
+    }
+    if (functionName=="pose") {
+      helpString.push_back("int32_t pose(const std::string& name, const std::string& hand) ");
+      helpString.push_back("Move the arm to a named pose of the [poses] configuration group. ");
+      helpString.push_back("The joints are given synchronised reference speeds so that they arrive together. The command returns as soon as the motion has started. ");
+      helpString.push_back("@param name the name of the pose. ");
+      helpString.push_back("@param hand left or right, empty or both for all the hands of the module. ");
+      helpString.push_back("@return the handle of the motion, -1 on failure ");
+    }
+    if (functionName=="motionStatus") {
+      helpString.push_back("std::string motionStatus(const int32_t id) ");
+      helpString.push_back("Get the status of a motion. ");
+      helpString.push_back("A motion of several hands is running until all of them are done. ");
+      helpString.push_back("@param id the handle of the motion. ");
+      helpString.push_back("@return one of running, done, timeout, preempted or unknown. ");
+    }
+    if (functionName=="waitMotion") {
+      helpString.push_back("bool waitMotion(const int32_t id, const double timeout) ");
+      helpString.push_back("Wait for a motion to end. ");
+      helpString.push_back("@param id the handle of the motion. ");
+      helpString.push_back("@param timeout the maximum waiting time in seconds. ");
+      helpString.push_back("@return true if the motion is done, false if it failed or is still running. ");
     }
     if (functionName=="grasp") {
-      helpString.push_back("bool grasp() ");
+      helpString.push_back("bool grasp(const std::string& hand) ");
       helpString.push_back("Grasp an object using feedback from the fingertips tactile sensors. ");
       helpString.push_back("The grasping movement is stopped upon contact detection. ");
+      helpString.push_back("If the arm is not in the grasping position yet, the command first waits for it to get there. ");
+      helpString.push_back("@param hand left or right, empty or both for all the hands of the module. ");
       helpString.push_back("@return true/false on success/failure. ");
     }
     if (functionName=="crush") {
-      helpString.push_back("bool crush() ");
+      helpString.push_back("bool crush(const std::string& hand) ");
       helpString.push_back("Grasp object without using the feedback from the fingertips tactile sensors. ");
       helpString.push_back("The grasping movement is not controlled and the object is therefore crushed. ");
+      helpString.push_back("If the arm is not in the grasping position yet, the command first waits for it to get there. ");
+      helpString.push_back("@param hand left or right, empty or both for all the hands of the module. ");
+      helpString.push_back("@return true/false on success/failure. ");
+    }
+    if (functionName=="regulate") {
+      helpString.push_back("bool regulate(const std::string& hand) ");
+      helpString.push_back("Grasp an object regulating the pressure of each fingertip to its target. ");
+      helpString.push_back("The fingers approach fast, slow down as the pressure builds up and stop once the target is reached. See the [regulation] group. ");
+      helpString.push_back("If the arm is not in the grasping position yet, the command first waits for it to get there. ");
+      helpString.push_back("@param hand left or right, empty or both for all the hands of the module. ");
       helpString.push_back("@return true/false on success/failure. ");
     }
     if (functionName=="quit") {
@@ -295,8 +1033,78 @@ std::vector<std::string> tactileGrasp_IDLServer::help(const std::string& functio
       helpString.push_back("@return true/false on success/failure. ");
     }
     if (functionName=="setThreshold") {
-      helpString.push_back("bool setThreshold(const int32_t aFinger, const double aThreshold) ");
+      helpString.push_back("bool setThreshold(const int32_t aFinger, const double aThreshold, const std::string& hand) ");
       helpString.push_back("Set the touch threshold. ");
+      helpString.push_back("The release threshold follows, keeping the configured difference between the touch and the release thresholds. A zero threshold disables the finger. ");
+      helpString.push_back("@param hand left or right, empty or both for all the hands of the module. ");
+      helpString.push_back("@return true/false on success/failure. ");
+    }
+    if (functionName=="getLatencyStats") {
+      helpString.push_back("yarp::os::Bottle getLatencyStats() ");
+      helpString.push_back("Get the contact-to-command latency statistics of each finger. ");
+      helpString.push_back("The latency is measured from the envelope timestamp of the compensated skin data to the velocity command reacting to the contact. ");
+      helpString.push_back("It does not include the delay of the taxel filter and of the debounce, whose bound is given in skin samples by filterDelay. ");
+      helpString.push_back("The switches are the changes of the contact state of the finger, which show the chattering of the contact decisions. ");
+      helpString.push_back("With both hands, the lists of each hand are wrapped as (left (...)) (right (...)). ");
+      helpString.push_back("@return a list per finger: (finger id) (count n) (mean ms) (p50 ms) (p99 ms) (max ms) (switches n) (filterDelay samples) ");
+    }
+    if (functionName=="resetLatencyStats") {
+      helpString.push_back("bool resetLatencyStats() ");
+      helpString.push_back("Reset the contact-to-command latency statistics. ");
+      helpString.push_back("@return true/false on success/failure. ");
+    }
+    if (functionName=="getLoopStats") {
+      helpString.push_back("yarp::os::Bottle getLoopStats() ");
+      helpString.push_back("Get the timing statistics of the grasp and gaze control loops since start or since the last reset. ");
+      helpString.push_back("Times are in ms. Overruns are ticks whose run time exceeded the period, missed are ticks skipped because the thread started late. ");
+      helpString.push_back("The grasp statistics also count the skin frames processed by the sparse and by the dense contact detection, and give the grasp phase and the number of phase changes of the adaptive control rate. ");
+      helpString.push_back("They end with the scheduling in effect, see the [realtime] group: the policy, its priority, the CPU the thread is pinned to (-1 for none) and whether the memory is locked. With the event-driven control, they are those of the skin callback thread, applied on its first call. ");
+      helpString.push_back("The gaze statistics also count the fixation points sent to the gaze controller and those suppressed by the deadband. ");
+      helpString.push_back("With both hands, there is one grasp_left and one grasp_right entry instead of grasp. ");
+      helpString.push_back("@return (grasp ((period ms) (estPeriod ms) (jitter ms) (used ms) (usedStd ms) (maxUsed ms) (iterations n) (overruns n) (missed n) (sparse n) (dense n) (phase name) (rateChanges n) (policy name) (priority n) (cpu n) (memoryLocked 0/1))) (gaze (... (sent n) (suppressed n))) ");
+    }
+    if (functionName=="resetLoopStats") {
+      helpString.push_back("bool resetLoopStats() ");
+      helpString.push_back("Reset the timing statistics of the grasp and gaze control loops. ");
+      helpString.push_back("@return true/false on success/failure. ");
+    }
+    if (functionName=="getPoseStats") {
+      helpString.push_back("yarp::os::Bottle getPoseStats() ");
+      helpString.push_back("Get the dispatch statistics of each pose. ");
+      helpString.push_back("The calls are the control board calls made to send the pose. The time to pose goes from the dispatch to the end of the motion. Times are in ms. ");
+      helpString.push_back("With both hands, the lists of each hand are wrapped as (left (...)) (right (...)). ");
+      helpString.push_back("@return a list per pose: (pose name) (mode batched|perJoint) (dispatches n) (calls n) (dispatch ms) (dispatchMax ms) (reached n) (failed n) (timeToPose ms) (timeToPoseMax ms) ");
+    }
+    if (functionName=="resetPoseStats") {
+      helpString.push_back("bool resetPoseStats() ");
+      helpString.push_back("Reset the dispatch statistics of the poses. ");
+      helpString.push_back("@return true/false on success/failure. ");
+    }
+    if (functionName=="getSlipStats") {
+      helpString.push_back("yarp::os::Bottle getSlipStats() ");
+      helpString.push_back("Get the slip statistics of each finger, see the [slip] group. ");
+      helpString.push_back("The count and the latencies are those of the tightening commands, measured from the envelope timestamp of the compensated skin data in which the slip was detected. Times are in ms. ");
+      helpString.push_back("The detection cost is the time spent tracking the slips at each skin sample, in us. ");
+      helpString.push_back("With both hands, the lists of each hand are wrapped as (left (...)) (right (...)). ");
+      helpString.push_back("@return a list per finger: (finger id) (slips n) (count n) (mean ms) (p99 ms) (max ms), then (detection (mean us) (max us) (samples n)) ");
+    }
+    if (functionName=="resetSlipStats") {
+      helpString.push_back("bool resetSlipStats() ");
+      helpString.push_back("Reset the slip statistics. ");
+      helpString.push_back("@return true/false on success/failure. ");
+    }
+    if (functionName=="getPredictionStats") {
+      helpString.push_back("yarp::os::Bottle getPredictionStats() ");
+      helpString.push_back("Get the statistics of the contact forecasts of each finger, see the [prediction] group. ");
+      helpString.push_back("A confirmed forecast was followed by the crossing of the touch threshold while the finger was stopped, an expired one was released without crossing, to creep on to the contact at the [prediction] creepScale. ");
+      helpString.push_back("The errors are the forecast minus the actual crossing times of the confirmed forecasts, positive if the crossing was forecast late. Times are in ms. ");
+      helpString.push_back("The budget is the latency compensated by the forecasts, and the latency its calibrated skin-to-command part. ");
+      helpString.push_back("With both hands, the lists of each hand are wrapped as (left (...)) (right (...)). ");
+      helpString.push_back("@return a list per finger: (finger id) (predictions n) (confirmed n) (expired n) (meanError ms) (meanAbsError ms) (maxAbsError ms), then (budget ms) (latency ms) ");
+    }
+    if (functionName=="resetPredictionStats") {
+      helpString.push_back("bool resetPredictionStats() ");
+      helpString.push_back("Reset the statistics of the contact forecasts. ");
       helpString.push_back("@return true/false on success/failure. ");
     }
     if (functionName=="help") {
@@ -0,0 +1,65 @@
+/* 
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org 
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+#ifndef __ICUB_TACTILEGRASP_ALLOCATIONCOUNTER_H__
+#define __ICUB_TACTILEGRASP_ALLOCATIONCOUNTER_H__
+
+namespace iCub {
+    namespace tactileGrasp {
+        /**
+         * Debug hook counting the heap allocations performed by the calling thread.
+         * The global operator new is only replaced when the module is built with TACTILEGRASP_CHECK_ALLOCATIONS,
+         * otherwise counting is a no-op and the count is always 0.
+         */
+        class AllocationCounter {
+            public:
+                /**
+                 * Start counting the allocations performed by the calling thread.
+                 */
+                static void start(void);
+
+                /**
+                 * Stop counting the allocations performed by the calling thread.
+                 *
+                 * \return The number of allocations performed since start()
+                 */
+                static unsigned long stop(void);
+
+                /**
+                 * \return True if the module was built with allocation counting
+                 */
+                static bool isEnabled(void);
+        };
+
+        /**
+         * Scoped allocation check.
+         * Counts the allocations performed in its scope and aborts if there were any.
+         */
+        class AllocationGuard {
+            private:
+                const char *tag;
+
+            public:
+                AllocationGuard(const char *aTag);
+                ~AllocationGuard();
+        };
+    } //namespace tactileGrasp
+} //namespace iCub
+
+#endif
@@ -0,0 +1,278 @@
+/* 
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org 
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+#ifndef __ICUB_TACTILEGRASP_ASYNCLOG_H__
+#define __ICUB_TACTILEGRASP_ASYNCLOG_H__
+
+#include <atomic>
+#include <algorithm>
+#include <string>
+#include <cstdio>
+
+#include <yarp/os/RateThread.h>
+#include <yarp/os/ResourceFinder.h>
+#include <yarp/os/Mutex.h>
+
+namespace iCub {
+    namespace tactileGrasp {
+        /**
+         * Levels of the log messages. A message is written if its level is lower or equal to the log level.
+         */
+        struct LogLevel {
+            enum Level {
+                Off = 0,
+                Error = 1,
+                Warning = 2,
+                Info = 3,
+                Debug = 4
+            };
+        };
+
+        /**
+         * Logging backend for the control loops.
+         * The messages are printf-style format strings with numeric or short string arguments. Logging a message only
+         * copies the format pointer and the arguments into a slot of a lock-free ring buffer: the formatting and the
+         * writing to the console or to the log file are done by the log thread. A full ring drops the message instead of
+         * blocking, so the control loops never wait for I/O whatever the log level.
+         * The messages of a same call site are limited to rateLimit per second, the suppressed ones being counted in the
+         * next message written.
+         * When the log thread is not running, e.g. in the tools, the messages are written synchronously.
+         */
+        class AsyncLog : public yarp::os::RateThread {
+            public:
+                /** Maximum number of arguments of a message, or of values of a vector message. */
+                static const int MaxArgs = 16;
+                /** Size of the copy of the string arguments of a message, including the terminators. */
+                static const int MaxStrings = 64;
+                /** Maximum length of the tag of a message. */
+                static const int MaxTag = 32;
+
+            private:
+                /** A message argument. */
+                struct LogArg {
+                    enum Type { Integer, Real, String };
+                    Type type;
+                    union {
+                        long long i;
+                        double d;
+                        /** Offset of the string in LogRecord::strings. */
+                        int s;
+                    };
+                };
+
+                /** A message waiting to be written. */
+                struct LogRecord {
+                    double time;
+                    int level;
+                    /** The format string. It must be a string literal. */
+                    const char *format;
+                    /** True if the arguments are the values of a vector, printed after the format. */
+                    bool vector;
+                    int nArgs;
+                    /** Number of messages of the same call site suppressed by the rate limit before this one. */
+                    unsigned long suppressed;
+                    char tag[MaxTag];
+                    LogArg args[MaxArgs];
+                    int stringsUsed;
+                    char strings[MaxStrings];
+                };
+
+                /** A slot of the ring buffer. The sequence tells whether the slot is free, being written or ready. */
+                struct Cell {
+                    std::atomic<size_t> sequence;
+                    LogRecord record;
+                };
+
+                /** Rate limit state of a call site, identified by its format string. */
+                struct RateSlot {
+                    std::atomic<const char *> format;
+                    /** Start of the current one second window (microseconds). */
+                    std::atomic<long long> windowStart;
+                    std::atomic<int> count;
+                    std::atomic<unsigned long> suppressed;
+                };
+                static const int RateSlots = 64;
+
+                /* ******* Ring buffer                                  ******* */
+                Cell *cells;
+                size_t mask;
+                std::atomic<size_t> enqueuePos;
+                /** Only touched by the writer, under flushMutex. */
+                size_t dequeuePos;
+                /** Messages dropped because the ring was full. */
+                std::atomic<unsigned long> dropped;
+                unsigned long droppedReported;
+
+                /* ******* Configuration                                ******* */
+                std::atomic<int> level;
+                int rateLimit;
+                RateSlot rateSlots[RateSlots];
+                bool console;
+                FILE *file;
+                /** True while the log thread is running. Otherwise the producers write their messages themselves. */
+                std::atomic<bool> draining;
+                /** Mutex serialising the writers of the messages. The producers never take it while the thread runs. */
+                yarp::os::Mutex flushMutex;
+
+                /** Formatting buffer of the writer. */
+                char line[1024];
+
+                std::string dbgTag;
+
+                AsyncLog();
+                AsyncLog(const AsyncLog &);
+                AsyncLog &operator=(const AsyncLog &);
+
+            public:
+                ~AsyncLog();
+
+                /** \return The process-wide log */
+                static AsyncLog &get(void);
+
+                /**
+                 * Configure the log from the [log] group. Must be called before the thread is started.
+                 *
+                 * \param rf The resource finder of the module
+                 * \return True upon success
+                 */
+                bool configure(yarp::os::ResourceFinder &rf);
+
+                virtual bool threadInit(void);
+                virtual void run(void);
+                virtual void threadRelease(void);
+
+                /**
+                 * Set the log level at run time.
+                 *
+                 * \param i_level The LogLevel
+                 */
+                void setLevel(const int &i_level) { level.store(i_level, std::memory_order_relaxed); }
+
+                /** \return The log level */
+                int getLevel(void) const { return level.load(std::memory_order_relaxed); }
+
+                /**
+                 * \param i_level A LogLevel
+                 * \return True if the messages of the given level are written
+                 */
+                bool isEnabled(const int &i_level) const { return i_level <= level.load(std::memory_order_relaxed); }
+
+                /** \return The number of messages dropped because the ring buffer was full */
+                unsigned long getDropped(void) const { return dropped.load(); }
+
+                /**
+                 * Log a message. Lock-free and allocation-free.
+                 *
+                 * \param i_level The LogLevel of the message
+                 * \param i_tag The tag printed before the message, usually the dbgTag of the caller
+                 * \param i_format A printf-style format string literal, without the final new line
+                 * \param i_args The integer, floating point or string arguments. Strings are truncated to fit in the message.
+                 */
+                template<typename... Args>
+                static void log(const int &i_level, const std::string &i_tag, const char *i_format, const Args &... i_args) {
+                    AsyncLog &logger = get();
+                    if (!logger.isEnabled(i_level)) {
+                        return;
+                    }
+                    Cell *cell = logger.claim(i_level, i_tag, i_format);
+                    if (cell) {
+                        pack(cell->record, i_args...);
+                        logger.commit(cell);
+                    }
+                }
+
+                /**
+                 * Log a message followed by the values of a vector. Lock-free and allocation-free.
+                 *
+                 * \param i_level The LogLevel of the message
+                 * \param i_tag The tag printed before the message
+                 * \param i_text The text printed before the values, a string literal
+                 * \param i_values The values
+                 * \param i_count The number of values. Only the first MaxArgs are printed.
+                 */
+                static void logVector(const int &i_level, const std::string &i_tag, const char *i_text, const double *i_values, const size_t &i_count);
+
+            private:
+                /**
+                 * Reserve a slot of the ring for a message, unless the message is rate limited or the ring is full.
+                 *
+                 * \return The slot, or NULL if the message must be dropped
+                 */
+                Cell *claim(const int &i_level, const std::string &i_tag, const char *i_format);
+
+                /**
+                 * Hand a filled slot to the writer. Writes the message at once if the log thread is not running.
+                 */
+                void commit(Cell *io_cell);
+
+                /**
+                 * Write the ready messages. flushMutex must be held.
+                 */
+                void drain(void);
+
+                /**
+                 * Format a message into line.
+                 *
+                 * \return The length of the line
+                 */
+                size_t format(const LogRecord &i_record);
+
+                /**
+                 * Append a formatted piece to line, truncating it if needed.
+                 *
+                 * \param io_length The length of the line
+                 */
+                template<typename... Args>
+                void append(size_t &io_length, const char *i_format, const Args &... i_args) {
+                    const size_t size = sizeof(line) - 2;
+                    if (io_length < size - 1) {
+                        int n = snprintf(line + io_length, size - io_length, i_format, i_args...);
+                        io_length = (n < 0) ? io_length : std::min(size - 1, io_length + n);
+                    }
+                }
+
+                /**
+                 * \return The rate limit state of a call site, or NULL if the table is full
+                 */
+                RateSlot *findRateSlot(const char *i_format);
+
+                /* ******* Argument packing                             ******* */
+                static void pack(LogRecord &) {}
+
+                template<typename T, typename... Rest>
+                static void pack(LogRecord &io_record, const T &i_first, const Rest &... i_rest) {
+                    addArg(io_record, i_first);
+                    pack(io_record, i_rest...);
+                }
+
+                static void addArg(LogRecord &io_record, const long long &i_value);
+                static void addArg(LogRecord &io_record, const int &i_value) { addArg(io_record, static_cast<long long>(i_value)); }
+                static void addArg(LogRecord &io_record, const long &i_value) { addArg(io_record, static_cast<long long>(i_value)); }
+                static void addArg(LogRecord &io_record, const unsigned int &i_value) { addArg(io_record, static_cast<long long>(i_value)); }
+                static void addArg(LogRecord &io_record, const unsigned long &i_value) { addArg(io_record, static_cast<long long>(i_value)); }
+                static void addArg(LogRecord &io_record, const bool &i_value) { addArg(io_record, static_cast<long long>(i_value)); }
+                static void addArg(LogRecord &io_record, const double &i_value);
+                static void addArg(LogRecord &io_record, const float &i_value) { addArg(io_record, static_cast<double>(i_value)); }
+                static void addArg(LogRecord &io_record, const char *i_value);
+                static void addArg(LogRecord &io_record, const std::string &i_value) { addArg(io_record, i_value.c_str()); }
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,171 @@
+/* 
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org 
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+#ifndef __ICUB_TACTILEGRASP_CONTACTPREDICTOR_H__
+#define __ICUB_TACTILEGRASP_CONTACTPREDICTOR_H__
+
+#include <vector>
+
+#include <yarp/os/Searchable.h>
+
+namespace iCub {
+    namespace tactileGrasp {
+        /**
+         * Forecast of the threshold crossings of the fingertips, to stop the fingers ahead of the contact.
+         * The fingers keep moving during the delay from the skin sample to the effect of the velocity command, so a stop
+         * issued at the crossing overshoots. The predictor fits a line to the maximum taxel of each approaching fingertip
+         * over the last window skin samples, and stops the finger when the crossing of its touch threshold is forecast
+         * within the lead time plus the latency budget. The budget is the actuation delay plus, when calibrated, a moving
+         * average of the measured skin-to-command latency. A correct forecast usually stops the finger just short of its
+         * threshold: a finger whose forecast crossing did not happen within confirmTime then creeps on to the contact at
+         * creepScale times its grasp velocities, without any further forecast, instead of going back to full speed.
+         * The forecast crossing times are compared with the actual crossings, i.e. the first skin sample over the
+         * threshold. All the buffers are allocated by configure().
+         */
+        class ContactPredictor {
+            private:
+                /** The forecast state of a fingertip. */
+                struct FingerForecast {
+                    /** Number of samples in the history, at most window. */
+                    int count;
+                    /** Index of the next sample of the history. */
+                    int head;
+                    /** True while the finger is stopped by a forecast. */
+                    bool stopping;
+                    /** True while the finger creeps on to the contact after an unconfirmed forecast. */
+                    bool creeping;
+                    /** True once the threshold has been crossed, until the taxels fall back under minRatio. */
+                    bool crossed;
+                    /** The forecast crossing time of the last prediction (s). */
+                    double predictedCross;
+                    /** Time at which the stop is released if the threshold has not been crossed (s). */
+                    double stopUntil;
+                    /** Number of forecasts, of crossings following a forecast and of forecasts released without crossing. */
+                    unsigned long predictions;
+                    unsigned long confirmed;
+                    unsigned long expired;
+                    /** Sum of the errors, sum of the absolute errors and maximum absolute error of the confirmed forecasts (s). */
+                    double errorSum;
+                    double absErrorSum;
+                    double maxAbsError;
+                };
+
+                /** True if the fingers are stopped ahead of the contact. */
+                bool enabled;
+                /** Number of skin samples of the line fit, between 2 and 16. */
+                int window;
+                /** Fraction of the touch threshold above which the crossings are forecast. */
+                double minRatio;
+                /** Time before the forecast crossing at which the stop should take effect (s). */
+                double leadTime;
+                /** Delay from the velocity command to the joints stopping (s). */
+                double actuationDelay;
+                /** True if the measured skin-to-command latency is added to the budget. */
+                bool calibrate;
+                /** Time after the forecast crossing at which an unconfirmed stop is released (s). */
+                double confirmTime;
+                /** Velocity of a released finger as a multiple of its grasp velocities, 0 to keep it stopped. */
+                double creepScale;
+
+                /** Moving average of the measured skin-to-command latency (s). */
+                double pipelineLatency;
+                /** Number of latency measures. */
+                unsigned long latencySamples;
+
+                /** The sample times and the maximum taxels of each finger, window samples per finger. */
+                std::vector<double> times;
+                std::vector<double> values;
+                /** The forecast state of each finger. */
+                std::vector<FingerForecast> fingers;
+
+            public:
+                ContactPredictor();
+
+                /**
+                 * Read the [prediction] configuration group and allocate the histories.
+                 *
+                 * \param rf The configuration of the module
+                 * \param i_nFingers The number of fingers
+                 * \return True upon success
+                 */
+                bool configure(yarp::os::Searchable &rf, const int &i_nFingers);
+
+                /** \return True if the fingers are stopped ahead of the contact */
+                bool isEnabled(void) const { return enabled; }
+
+                /**
+                 * Add a skin sample of a fingertip and forecast its threshold crossing.
+                 *
+                 * \param i_finger The finger ID
+                 * \param i_time The time of the skin sample (s)
+                 * \param i_maxTaxel The maximum taxel of the fingertip
+                 * \param i_threshold The touch threshold of the fingertip, 0 if it does not touch
+                 * \return The velocity of the finger as a multiple of its grasp velocities: 1 if it approaches freely, 0 if it
+                 * is stopped ahead of the contact, creepScale if it creeps on to the contact
+                 */
+                double update(const int &i_finger, const double &i_time, const double &i_maxTaxel, const double &i_threshold);
+
+                /**
+                 * Add a measure of the skin-to-command latency to the calibration of the budget.
+                 *
+                 * \param i_latency The latency (s)
+                 */
+                void recordLatency(const double &i_latency);
+
+                /**
+                 * Forget the histories and the pending forecasts, before a new grasp.
+                 */
+                void reset(void);
+
+                /**
+                 * Clear the forecast statistics. The latency calibration is kept.
+                 */
+                void resetStats(void);
+
+                /** \return The latency budget: the actuation delay plus the calibrated skin-to-command latency (s) */
+                double getBudget(void) const { return actuationDelay + (calibrate ? pipelineLatency : 0.0); }
+
+                /** \return The calibrated skin-to-command latency (s) */
+                double getPipelineLatency(void) const { return pipelineLatency; }
+
+                /** \return The forecast crossing time of the last prediction of the given finger (s) */
+                double getPredictedCross(const int &i_finger) const { return fingers[i_finger].predictedCross; }
+
+                /** \return The number of forecasts of the given finger */
+                unsigned long getPredictions(const int &i_finger) const { return fingers[i_finger].predictions; }
+
+                /** \return The number of forecasts of the given finger followed by a crossing */
+                unsigned long getConfirmed(const int &i_finger) const { return fingers[i_finger].confirmed; }
+
+                /** \return The number of forecasts of the given finger released without crossing */
+                unsigned long getExpired(const int &i_finger) const { return fingers[i_finger].expired; }
+
+                /** \return The mean error of the confirmed forecasts of the given finger, positive if the crossing was forecast late (s) */
+                double getMeanError(const int &i_finger) const;
+
+                /** \return The mean absolute error of the confirmed forecasts of the given finger (s) */
+                double getMeanAbsError(const int &i_finger) const;
+
+                /** \return The maximum absolute error of the confirmed forecasts of the given finger (s) */
+                double getMaxAbsError(const int &i_finger) const { return fingers[i_finger].maxAbsError; }
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,237 @@
+/* 
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org 
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+#ifndef __ICUB_TACTILEGRASP_FAKEHANDBOARD_H__
+#define __ICUB_TACTILEGRASP_FAKEHANDBOARD_H__
+
+#include <string>
+#include <vector>
+
+#include <yarp/os/RateThread.h>
+#include <yarp/os/Mutex.h>
+#include <yarp/os/Stamp.h>
+#include <yarp/os/BufferedPort.h>
+#include <yarp/os/Searchable.h>
+#include <yarp/dev/DeviceDriver.h>
+#include <yarp/dev/IEncoders.h>
+#include <yarp/dev/IPositionControl.h>
+#include <yarp/dev/IVelocityControl.h>
+#include <yarp/sig/Vector.h>
+
+namespace iCub {
+    namespace tactileGrasp {
+        /**
+         * Ground truth of a simulated grasp trial for a single finger.
+         */
+        struct SimFingerEvents {
+            /** Publication time of the first skin frame whose finger response reached the touch threshold, -1 if none. */
+            double crossTime;
+            /** Distal joint angle when the threshold was reached (deg). */
+            double crossAngle;
+            /** Reception time of the first command stopping all the finger joints after the threshold was reached, -1 if none. */
+            double stopTime;
+            /** Distal joint angle at the end of the trial (deg). */
+            double restAngle;
+        };
+
+        /**
+         * Simulated iCub arm control board with fingertip skin.
+         * Implements the encoder, position and velocity interfaces with simplified kinematics: each joint integrates
+         * the commanded velocity, or moves towards its position target at the reference speed, within its limits.
+         * Velocity commands are applied after a configurable actuation latency.
+         *
+         * A virtual object is touched by finger i when the angle of its distal joint (the last joint of the finger)
+         * exceeds contactAngles[i]. The fingertip taxels then respond proportionally to the penetration and the object
+         * blocks the finger after maxPenetration degrees. The compensated skin frames are published on the skinPort.
+         * If a rawSkinPort is given, the raw frames are published there too in the iCub convention: the raw value of a
+         * taxel drops from its rawBaseline under pressure, and the baseline drifts by rawDrift units per second.
+         *
+         * The device is registered as "fakeHandBoard" by registerDevice().
+         */
+        class FakeHandBoard : public yarp::dev::DeviceDriver, 
+                              public yarp::dev::IEncoders, public yarp::dev::IPositionControl, public yarp::dev::IVelocityControl {
+            private:
+                /** Rate thread integrating the kinematics and publishing the skin. */
+                class Updater : public yarp::os::RateThread {
+                    private:
+                        FakeHandBoard &board;
+
+                    public:
+                        Updater(FakeHandBoard &aBoard, const int aPeriod);
+                        virtual void run(void);
+                };
+
+                /** A velocity command waiting for the actuation latency to elapse. */
+                struct PendingCommand {
+                    double applyTime;
+                    std::vector<double> velocities;
+                };
+
+                /** Control mode of a joint. */
+                enum JointMode {
+                    ModeIdle,
+                    ModePosition,
+                    ModeVelocity
+                };
+
+                /* ******* Kinematics                                   ******* */
+                int nJoints;
+                std::vector<double> positions;
+                std::vector<double> velocities;
+                std::vector<double> targets;
+                std::vector<double> refSpeeds;
+                std::vector<double> refAccelerations;
+                std::vector<double> minLimits;
+                std::vector<double> maxLimits;
+                std::vector<JointMode> modes;
+                double lastUpdate;
+
+                /* ******* Actuation latency                            ******* */
+                double commandLatency;
+                std::vector<PendingCommand> pendingCommands;
+                int pendingHead;
+                int pendingCount;
+
+                /* ******* Virtual object and skin                      ******* */
+                /** Flat list of the joints of each finger, as in the grasp thread. */
+                std::vector<int> fingerJoints;
+                std::vector<int> fingerJointStart;
+                std::vector<int> fingerJointCount;
+                std::vector<int> tipOffsets;
+                std::vector<int> tipCounts;
+                std::vector<double> touchThresholds;
+                std::vector<double> contactAngles;
+                double stiffness;
+                double maxPenetration;
+                double noise;
+                double skinPeriod;
+                double lastSkin;
+                int skinSize;
+                yarp::os::Stamp skinStamp;
+                yarp::os::BufferedPort<yarp::sig::Vector> portSkinOut;
+                /** True if the raw skin is published. */
+                bool publishRaw;
+                /** Raw value of an untouched taxel at the start. */
+                double rawBaseline;
+                /** Drift of the raw baseline (units/s). */
+                double rawDrift;
+                /** Time the raw drift started from. */
+                double rawStart;
+                yarp::os::BufferedPort<yarp::sig::Vector> portRawSkinOut;
+
+                /* ******* Trial ground truth                           ******* */
+                double trialStart;
+                std::vector<SimFingerEvents> events;
+
+                yarp::os::Mutex mutex;
+                Updater *updater;
+
+                std::string dbgTag;
+
+            public:
+                FakeHandBoard();
+                virtual ~FakeHandBoard();
+
+                /**
+                 * Register the device with the YARP device factory as "fakeHandBoard".
+                 */
+                static void registerDevice(void);
+
+                /* ******* DeviceDriver                                 ******* */
+                virtual bool open(yarp::os::Searchable &config);
+                virtual bool close(void);
+
+                /* ******* Simulation                                   ******* */
+                /**
+                 * Start a new grasp trial: place the virtual object and clear the ground truth.
+                 *
+                 * \param i_contactAngles The distal joint angle at which each finger touches the object, negative for no contact (deg)
+                 */
+                void startTrial(const std::vector<double> &i_contactAngles);
+
+                /**
+                 * \return True when every finger touching the object has received a stop command and has stopped
+                 */
+                bool isTrialDone(void);
+
+                /**
+                 * Get the ground truth of the current trial.
+                 *
+                 * \param o_events The events of each finger
+                 * \return The reception time of the first grasp command of the trial, -1 if none
+                 */
+                double getTrialEvents(std::vector<SimFingerEvents> &o_events);
+
+                /* ******* IEncoders                                    ******* */
+                virtual bool getAxes(int *ax);
+                virtual bool resetEncoder(int j);
+                virtual bool resetEncoders();
+                virtual bool setEncoder(int j, double val);
+                virtual bool setEncoders(const double *vals);
+                virtual bool getEncoder(int j, double *v);
+                virtual bool getEncoders(double *encs);
+                virtual bool getEncoderSpeeds(double *spds);
+                virtual bool getEncoderSpeed(int j, double *sp);
+                virtual bool getEncoderAccelerations(double *accs);
+                virtual bool getEncoderAcceleration(int j, double *spds);
+
+                /* ******* IPositionControl                             ******* */
+                virtual bool setPositionMode();
+                virtual bool positionMove(int j, double ref);
+                virtual bool positionMove(const double *refs);
+                virtual bool relativeMove(int j, double delta);
+                virtual bool relativeMove(const double *deltas);
+                virtual bool checkMotionDone(int j, bool *flag);
+                virtual bool checkMotionDone(bool *flag);
+                virtual bool setRefSpeed(int j, double sp);
+                virtual bool setRefSpeeds(const double *spds);
+                virtual bool setRefAcceleration(int j, double acc);
+                virtual bool setRefAccelerations(const double *accs);
+                virtual bool getRefSpeed(int j, double *ref);
+                virtual bool getRefSpeeds(double *spds);
+                virtual bool getRefAcceleration(int j, double *acc);
+                virtual bool getRefAccelerations(double *accs);
+                virtual bool stop(int j);
+                virtual bool stop();
+
+                /* ******* IVelocityControl                             ******* */
+                virtual bool setVelocityMode();
+                virtual bool velocityMove(int j, double sp);
+                virtual bool velocityMove(const double *sp);
+
+            private:
+                /** Integrate the kinematics and publish the skin. Called by the updater thread. */
+                void update(void);
+
+                /** Integrate the kinematics up to the given time. The mutex must be held. */
+                void integrate(const double &i_now);
+
+                /** Synthesise and publish a skin frame. The mutex must be held. */
+                void publishSkin(const double &i_now);
+
+                /** Record the stop of the fingers whose joints are all commanded to zero velocity. The mutex must be held. */
+                void recordStops(const double *i_velocities, const double &i_now);
+
+                /** Read a list of doubles from the configuration. */
+                static bool readList(yarp::os::Searchable &config, const char *i_key, std::vector<double> &o_values);
+        };
+    } //namespace tactileGrasp
+} //namespace iCub
+
+#endif
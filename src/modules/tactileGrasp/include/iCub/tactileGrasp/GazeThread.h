@@ -21,9 +21,15 @@
 #ifndef __ICUB_TACTILEGRASP_GAZETHREAD_H__
 #define __ICUB_TACTILEGRASP_GAZETHREAD_H__
 
+#include "iCub/tactileGrasp/LoopMonitor.h"
+#include "iCub/tactileGrasp/ParallelStartup.h"
+
 #include <string>
+#include <vector>
+#include <atomic>
 
 #include <yarp/os/RateThread.h>
+#include <yarp/os/Bottle.h>
 #include <yarp/os/ResourceFinder.h>
 #include <yarp/dev/PolyDriver.h>
 #include <yarp/dev/CartesianControl.h>
@@ -32,15 +38,22 @@
 namespace iCub {
     namespace tactileGrasp {
         class GazeThread : public yarp::os::RateThread {
+            public:
+                /** Maximum number of tracked hands. */
+                static const int MaxHands = 2;
+
             private:
                 /* ******* Module attributes.               ******* */
                 int period;
                 yarp::os::ResourceFinder rf;
 
                 /* ******* Cartesian controller.                ******* */
-                yarp::dev::PolyDriver clientCart;
-                yarp::dev::ICartesianControl *iCart;
-                int startup_context_id_cart;
+                /** The tracked hands: the one given by whichHand, or left and right with whichHand both. */
+                std::vector<std::string> hands;
+                /** One cartesian controller for each tracked hand. */
+                yarp::dev::PolyDriver clientCart[MaxHands];
+                yarp::dev::ICartesianControl *iCart[MaxHands];
+                int startup_context_id_cart[MaxHands];
                 
                 /* ******* Gaze controller.                     ******* */
                 yarp::dev::PolyDriver clientGaze;
@@ -49,17 +62,72 @@ namespace iCub {
 
                 yarp::sig::Vector startGaze;
 
+                /* ******* Gaze tracking.                       ******* */
+                /** If true the fixation point is sent without waiting for the gaze to reach it. */
+                bool async;
+                /** Minimum displacement of the fixation point before a new one is sent (m). */
+                double deadband;
+                /** True once a fixation point has been sent. */
+                bool hasFixation;
+                /** The last fixation point sent to the gaze controller. */
+                yarp::sig::Vector lastFixation;
+                /** Preallocated hand pose. */
+                yarp::sig::Vector handPosition;
+                yarp::sig::Vector handOrientation;
+                /** Preallocated fixation point. */
+                yarp::sig::Vector fixation;
+                /** Number of fixation points sent to the gaze controller. */
+                std::atomic<unsigned long> commandsSent;
+                /** Number of fixation points not sent because the hand moved less than the deadband. */
+                std::atomic<unsigned long> commandsSuppressed;
+
+                /** Timing statistics of the gaze tick. */
+                LoopMonitor loopMonitor;
+
+                /* ******* Startup.                         ******* */
+                /** If true the cartesian and gaze drivers are opened concurrently. */
+                bool parallelStartup;
+                /** Durations of the startup phases. */
+                StartupTimer *startup;
+                /** Startup timer used when none is given. */
+                StartupTimer localStartup;
+
                 /* ******* Debug attributes.                ******* */
                 std::string dbgTag;
 
             public:
-                GazeThread(const int aPeriod, const yarp::os::ResourceFinder &aRf);
+                /**
+                 * \param aPeriod The thread period (ms)
+                 * \param aRf The resource finder of the module
+                 * \param aStartup The timer recording the startup phases, NULL for a private one
+                 */
+                GazeThread(const int aPeriod, const yarp::os::ResourceFinder &aRf, StartupTimer *aStartup = NULL);
                 
                 bool threadInit();     
                 void threadRelease();
                 void run();
 
+                /**
+                 * Get the timing statistics of the gaze tick.
+                 *
+                 * \param o_stats The statistics as returned by LoopMonitor::getStats(), followed by (sent n) (suppressed n): the number
+                 * of fixation points sent to the gaze controller and suppressed by the deadband
+                 */
+                void getLoopStats(yarp::os::Bottle &o_stats);
+
+                /**
+                 * Reset the timing statistics of the gaze tick and the fixation point counters.
+                 */
+                void resetLoopStats(void);
+
             private:
+                /**
+                 * Look at the grasped object, i.e. 10 cm behind the hand, or behind the middle of both hands.
+                 * The fixation point is only sent if it moved more than the deadband since the last one. In asynchronous mode
+                 * the thread does not wait for the gaze to reach it.
+                 *
+                 * \return True upon success
+                 */
                 bool lookAtObject();
         };
     } //namespace tactileGrasp
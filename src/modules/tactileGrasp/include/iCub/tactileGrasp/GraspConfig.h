@@ -0,0 +1,181 @@
+/* 
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org 
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+#ifndef __ICUB_TACTILEGRASP_GRASPCONFIG_H__
+#define __ICUB_TACTILEGRASP_GRASPCONFIG_H__
+
+#include <atomic>
+#include <vector>
+
+#include <yarp/os/Mutex.h>
+
+namespace iCub {
+    namespace tactileGrasp {
+        /**
+         * Structure containing the velocities to be used for each grasping movement.
+         */
+        struct GraspVelocity {
+            std::vector<double> grasp;
+            std::vector<double> stop;
+        };
+
+        /**
+         * The settings of the grasp controller which can be changed at run time through the RPC port.
+         * The vectors are sized once by the controller, so that copying a configuration onto another never allocates.
+         */
+        class GraspConfig {
+            public:
+                /** Version of the configuration, incremented by each change. */
+                unsigned long version;
+                /** The grasp and stop velocities of the joints from jointOffset. */
+                GraspVelocity velocities;
+                /** True once the grasp and the stop velocities have been set. */
+                bool hasGrasp;
+                bool hasStop;
+                /** The touch threshold of each finger. */
+                std::vector<double> touchThresholds;
+                /** The release threshold of each finger. */
+                std::vector<double> releaseThresholds;
+                /** The configured hysteresis of each finger, i.e. the touch minus the release threshold, kept when the touch threshold changes. */
+                std::vector<double> releaseMargins;
+                /** The grasp mode: GraspType::Grasp, GraspType::Crush or GraspType::Regulate. */
+                int mode;
+                /** Number of times the mode was selected. Each selection starts a new grasp. */
+                unsigned long modeSelections;
+                /** The joint of the first velocity. */
+                int jointOffset;
+                /** Number of joints of the velocity interface, 0 if unknown. */
+                int nJoints;
+
+                GraspConfig();
+
+                /**
+                 * Set the velocities of all the joints. Only the velocities of the controlled joints are kept.
+                 *
+                 * \param i_type The velocity type (GraspType::Grasp or GraspType::Stop)
+                 * \param i_vel The velocities of the joints from jointOffset
+                 * \return True upon success
+                 */
+                bool setVelocities(const int &i_type, const std::vector<double> &i_vel);
+
+                /**
+                 * Set the velocity of a joint.
+                 *
+                 * \param i_type The velocity type (GraspType::Grasp or GraspType::Stop)
+                 * \param i_joint The joint
+                 * \param i_vel The velocity
+                 * \return True upon success
+                 */
+                bool setVelocity(const int &i_type, const int &i_joint, const double &i_vel);
+
+                /**
+                 * Set the touch threshold of a finger. Its release threshold follows, keeping the configured hysteresis.
+                 *
+                 * \param i_finger The finger ID
+                 * \param i_threshold The touch threshold
+                 * \return True upon success
+                 */
+                bool setTouchThreshold(const int &i_finger, const double &i_threshold);
+
+                /**
+                 * Set the grasp mode.
+                 *
+                 * \param i_type GraspType::Grasp, GraspType::Crush or GraspType::Regulate
+                 * \return True upon success
+                 */
+                bool setMode(const int &i_type);
+
+                /**
+                 * Copy a configuration of the same sizes without allocating.
+                 *
+                 * \param i_config The configuration to copy
+                 */
+                void copyFrom(const GraspConfig &i_config);
+        };
+
+        /**
+         * Publication of immutable GraspConfig snapshots from the RPC thread to the control thread, RCU style.
+         * The writers copy the latest snapshot, edit the copy and publish it with an atomic pointer swap. The control
+         * thread picks up the latest snapshot at the start of a tick without ever taking a lock: it announces the
+         * snapshot it reads in a hazard pointer, so that the writers only delete the replaced snapshots it does not use.
+         * There must be a single reader at a time.
+         */
+        class GraspConfigStore {
+            private:
+                /** The latest snapshot. */
+                std::atomic<GraspConfig *> current;
+                /** The snapshot being read by the control thread, NULL if none. */
+                std::atomic<GraspConfig *> hazard;
+                /** Replaced snapshots waiting for the reader to let go of them. */
+                std::vector<GraspConfig *> retired;
+                /** Mutex serialising the writers. The reader never takes it. */
+                yarp::os::Mutex writeMutex;
+
+            public:
+                GraspConfigStore();
+                ~GraspConfigStore();
+
+                /**
+                 * Publish the initial snapshot. Must be called before the reader is started.
+                 *
+                 * \param i_config The initial configuration
+                 */
+                void reset(const GraspConfig &i_config);
+
+                /**
+                 * Start a change: lock out the other writers and copy the latest snapshot.
+                 *
+                 * \return The copy to be edited and given to publish()
+                 */
+                GraspConfig *edit(void);
+
+                /**
+                 * End a change started by edit().
+                 *
+                 * \param io_config The edited copy returned by edit()
+                 * \param i_commit True to publish the copy, false to drop it
+                 */
+                void publish(GraspConfig *io_config, const bool &i_commit);
+
+                /**
+                 * Get the latest snapshot for reading. Lock-free for the control thread.
+                 *
+                 * \return The snapshot, valid until release()
+                 */
+                const GraspConfig *acquire(void);
+
+                /**
+                 * Let go of the snapshot returned by acquire().
+                 */
+                void release(void);
+
+            private:
+                /**
+                 * Delete the retired snapshots which are not being read. The write mutex must be held.
+                 */
+                void reclaim(void);
+
+                GraspConfigStore(const GraspConfigStore &);
+                GraspConfigStore &operator=(const GraspConfigStore &);
+        };
+    } //namespace tactileGrasp
+} //namespace iCub
+
+#endif
+
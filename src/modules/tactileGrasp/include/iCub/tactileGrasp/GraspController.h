@@ -0,0 +1,426 @@
+
+/* 
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org 
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+#ifndef __ICUB_TACTILEGRASP_GRASPCONTROLLER_H__
+#define __ICUB_TACTILEGRASP_GRASPCONTROLLER_H__
+
+#include <iCub/tactileGrasp/TactileGraspEnums.h>
+#include <iCub/tactileGrasp/SkinPatchKernel.h>
+#include <iCub/tactileGrasp/HandModel.h>
+#include <iCub/tactileGrasp/TaxelFilter.h>
+#include <iCub/tactileGrasp/GraspConfig.h>
+#include <iCub/tactileGrasp/SlipDetector.h>
+#include <iCub/tactileGrasp/ContactPredictor.h>
+
+#include <string>
+#include <vector>
+
+#include <yarp/os/Searchable.h>
+#include <yarp/sig/Vector.h>
+
+namespace iCub {
+    namespace tactileGrasp {
+        /**
+         * Read the grasp velocities from the [velocity] group of the configuration.
+         * The stop velocity is only applied to the joints with a positive grasp velocity.
+         *
+         * \param rf The configuration of the module
+         * \param o_velocities The grasp and stop velocities of each joint &gt;= 8
+         * \return True upon success
+         */
+        bool readGraspVelocities(yarp::os::Searchable &rf, GraspVelocity &o_velocities);
+
+        /**
+         * Per-finger state used by the control tick.
+         * All the fields are preallocated in threadInit() so that no memory is allocated while grasping.
+         */
+        struct FingerState {
+            /** The maximum taxel value measured on the fingertip in the last skin sample. */
+            double maxTaxel;
+            /** True if the fingertip is in contact. */
+            bool contact;
+            /** True if the contact was detected in the last skin sample and the stop command has not been sent yet. */
+            bool contactOnset;
+            /** Number of consecutive skin samples disagreeing with the contact state, for the debounce. */
+            int pendingSamples;
+            /** Number of changes of the contact state. */
+            unsigned long switches;
+            /** True if a slip was detected in the last skin sample and the tightening has not started yet. */
+            bool slipPending;
+            /** True if the tightening started since the last call to takeSlipOnset(). */
+            bool slipOnset;
+            /** Time until which the finger is tightened after a slip, negative if none. */
+            double tightenUntil;
+            /** Velocity of the finger set by the contact forecasts as a multiple of its grasp velocities: 0 while it is stopped ahead of a forecast contact, less than 1 while it creeps on to the contact. */
+            double predictedScale;
+        };
+
+        /**
+         * A joint moved by a finger, with the index of its velocity in the grasp velocity vectors.
+         */
+        struct JointCommand {
+            int joint;
+            int velocity;
+        };
+
+        /**
+         * Parameters of the fingertip pressure regulation.
+         * The regulator computes for each finger a scale of its grasp velocities from the error between the target
+         * and the measured maximum taxel: scale = kp*error + ki*integral(error), saturated to [minScale, maxScale].
+         */
+        struct RegulationParams {
+            /** Proportional gain (1/taxel unit). */
+            double kp;
+            /** Integral gain (1/(taxel unit s)). */
+            double ki;
+            /** Upper saturation of the velocity scale, i.e. the approach speed relative to the grasp velocities. */
+            double maxScale;
+            /** Lower saturation of the velocity scale. Negative values let the finger back off when pressing too hard. */
+            double minScale;
+            /** Pressure error under which a finger in contact is considered settled and is stopped. */
+            double tolerance;
+        };
+
+        /**
+         * Contact detection and grasp velocity logic of the grasp thread.
+         * The controller owns no port nor device: it turns the skin data into the joint velocities to be commanded,
+         * so that the same code runs on the robot, on the simulated hand and on recorded streams.
+         */
+        class GraspController {
+            private:
+                /* ******* Contact detection configuration              ******* */
+                /** The state of each finger. The contact flags are kept between ticks to avoid herratic behaviour when clocking the grasp thread faster than the skin threads. */
+                std::vector<FingerState> fingers;
+                /** The taxel patches of the hand skin with their touch thresholds: one per finger, followed by the palm if configured. */
+                std::vector<TaxelPatch> patches;
+                /** The result of the reduction of each patch. */
+                std::vector<PatchStats> patchStats;
+                /** Minimum size of the skin vector covering all the patches. */
+                size_t skinSize;
+                /** The patch of each taxel of the skin vector, -1 for the taxels outside the patches. Used by the sparse detection. */
+                std::vector<int> taxelPatches;
+                /** True if the palm patch is configured. */
+                bool hasPalm;
+                /** True if the palm is in contact. */
+                bool palmContact;
+                /** Power grasp: if true the fingers are only closed after the palm has touched the object. */
+                bool palmTrigger;
+                /** True once the palm has touched the object. Cleared when the hand is opened. */
+                bool palmTriggered;
+                /** The maximum taxel of each finger, gathered for the debug log. */
+                std::vector<double> maxTaxels;
+                /** If true the vectorised reduction is checked against the scalar reference at every skin sample. */
+                bool validateKernel;
+                /** The result of the scalar reference reduction. */
+                std::vector<PatchStats> referenceStats;
+                /** Temporal filter of the taxels of the dense detection. */
+                TaxelFilter taxelFilter;
+                /** Number of consecutive skin samples needed to change the contact state of a finger. */
+                int debounce;
+                /** Slip detection on the fingertips in contact. */
+                SlipDetector slip;
+                /** Forecast of the contacts of the approaching fingertips. */
+                ContactPredictor predictor;
+
+                /* ******* Grasp configuration                          ******* */
+                /** The settings changed at run time: velocities, thresholds and mode. The touch thresholds are copied to the patches. */
+                GraspConfig config;
+                /** Number of fingers used for the grasping movement. */
+                int nFingers;
+                /** Total number of joints to be controlled by the velocity interface. */
+                int nJoints;
+                /** The hand model. */
+                HandModel hand;
+                /** Row offsets of each finger in the commands table, plus the end of the table. Fingers with a negative touch threshold move no joint. */
+                std::vector<int> commandOffsets;
+                /** The joints moved by all the fingers. Finger i moves commands[commandOffsets[i]] ... commands[commandOffsets[i + 1] - 1]. */
+                std::vector<JointCommand> commands;
+                /** The velocities to be commanded. This is preallocated to nJoints. */
+                std::vector<double> graspVelocities;
+
+                /* ******* Pressure regulation                          ******* */
+                /** The regulator parameters. */
+                RegulationParams regulation;
+                /** The target pressure of each finger. Fingers with no positive target are not regulated. */
+                std::vector<double> targetPressures;
+                /** The integral of the pressure error of each finger. */
+                std::vector<double> integrals;
+                /** Time of the last velocity computation, negative before the first one. */
+                double lastControlTime;
+
+
+                /* ****** Debug attributes                              ****** */
+                std::string dbgTag;
+
+            public:
+                GraspController();
+
+                /**
+                 * Configure the contact detection from the [graspTh] and [skinLayout] groups and build the finger to joint map.
+                 *
+                 * \param rf The configuration of the module
+                 * \return True upon success
+                 */
+                bool configure(yarp::os::Searchable &rf);
+
+                /**
+                 * Set the number of joints of the velocity interface and preallocate the commanded velocities.
+                 *
+                 * \param i_nJoints The number of joints
+                 * \return False if a finger joint is not controlled by the velocity interface
+                 */
+                bool setJointCount(const int &i_nJoints);
+
+                /**
+                 * Update the contact state of each finger from the compensated skin data.
+                 *
+                 * \param i_skinComp The compensated skin data
+                 * \return True upon success
+                 */
+                bool detectContact(const yarp::sig::Vector &i_skinComp);
+
+                /**
+                 * Update the contact state of each finger from the taxels reported active by the skin contact list.
+                 * Only the given taxels are visited, so the cost grows with the contacts instead of the skin size. The
+                 * patches with no active taxel are not in contact. The taxel filter runs on the active taxels, the
+                 * others are taken as zero while they are not reported, and on the whole patch of the fingers in contact
+                 * for the slip detection, so the two paths can be switched without resetting the filter.
+                 *
+                 * \param i_skinComp The compensated skin data, giving the value of the active taxels
+                 * \param i_taxels The indices of the active taxels in the skin vector. Taxels outside the patches are ignored.
+                 * \return True upon success
+                 */
+                bool detectContactSparse(const yarp::sig::Vector &i_skinComp, const std::vector<unsigned int> &i_taxels);
+
+                /**
+                 * Assemble the joint velocities from the contact state of each finger, or from the pressure error in
+                 * the regulated mode.
+                 *
+                 * \param i_time The current time, used to integrate the pressure error (s)
+                 * \return The velocities of all the joints of the velocity interface
+                 */
+                const std::vector<double> &computeVelocities(const double &i_time);
+
+                /** \return The velocities of the last call to computeVelocities() */
+                const std::vector<double> &getVelocities(void) const { return graspVelocities; }
+
+                /**
+                 * Consume the contact onset of a finger, i.e. the contact detected since the last call.
+                 *
+                 * \param i_finger The finger ID
+                 * \return True if the finger touched the object since the last call
+                 */
+                bool takeContactOnset(const int &i_finger);
+
+                /**
+                 * Forecast the contacts of the fingers from the last skin sample, and stop the fingers about to touch.
+                 * This is to be called after the contact detection, with the time of the skin sample.
+                 *
+                 * \param i_time The time of the skin sample (s)
+                 */
+                void predictContacts(const double &i_time);
+
+                /**
+                 * Add a measure of the skin-to-command latency of a stop to the calibration of the contact forecasts.
+                 *
+                 * \param i_latency The latency (s)
+                 */
+                void recordStopLatency(const double &i_latency) { predictor.recordLatency(i_latency); }
+
+                /** \return The contact predictor, for its statistics */
+                const ContactPredictor &getPredictor(void) const { return predictor; }
+
+                /**
+                 * Clear the statistics of the contact forecasts.
+                 */
+                void resetPredictionStats(void) { predictor.resetStats(); }
+
+                /**
+                 * Consume the slip onset of a finger, i.e. the tightening started since the last call.
+                 *
+                 * \param i_finger The finger ID
+                 * \return True if the finger started to be tightened after a slip since the last call
+                 */
+                bool takeSlipOnset(const int &i_finger);
+
+                /** \return The slip detector, for its statistics */
+                const SlipDetector &getSlipDetector(void) const { return slip; }
+
+                /**
+                 * Clear the slip counts and the slip detection cost statistics.
+                 */
+                void resetSlipStats(void) { slip.resetStats(); }
+
+                /**
+                 * Reset the grasp state before a new grasp, i.e. the palm trigger, the pressure regulators, the slip tracking and the
+                 * contact forecasts.
+                 */
+                void resetGrasp(void);
+
+                /**
+                 * Select the grasp mode.
+                 *
+                 * \param i_type GraspType::Grasp or GraspType::Crush to switch between the grasp and the stop velocities at
+                 * contact, GraspType::Regulate to regulate the fingertip pressure
+                 * \return True upon success
+                 */
+                bool setMode(const int &i_type);
+
+                /**
+                 * Set the touch threshold of a finger.
+                 *
+                 * \param aFinger The finger ID
+                 * \param aThreshold The touch threshold
+                 * \return True upon success
+                 */
+                bool setTouchThreshold(const int aFinger, const double aThreshold);
+
+                /**
+                 * Set velocities of all joints.
+                 *
+                 * \param i_type The velocity type (grasp or stop).
+                 * \param i_vel The vector of joint velocities
+                 * \return True upon success
+                 */
+                bool setVelocities(const int &i_type, const std::vector<double> &i_vel);
+
+                /**
+                 * Set the velocity of the given joint.
+                 *
+                 * \param i_type The velocity type (grasp or stop).
+                 * \param i_joint The join to be set
+                 * \param i_vel The vector of joint velocities
+                 * \return True upon success
+                 */
+                bool setVelocity(const int &i_type, const int &i_joint, const double &i_vel);
+
+                /** \return True once both the grasp and the stop velocities have been set */
+                bool hasVelocities(void) const { return config.hasGrasp && config.hasStop; }
+
+                /** \return The settings in use, sized for the hand model. A copy can be edited and given to applyConfig(). */
+                const GraspConfig &getConfig(void) const { return config; }
+
+                /**
+                 * Use new settings. The configuration must come from getConfig(), so that it is copied without allocating.
+                 * The pressure regulators start from scratch when the grasp mode is selected.
+                 *
+                 * \param i_config The new settings
+                 */
+                void applyConfig(const GraspConfig &i_config);
+
+                /** \return The hand model */
+                const HandModel &getHand(void) const { return hand; }
+
+                /** \return The number of fingers */
+                int getFingerCount(void) const { return nFingers; }
+
+                /** \return The state of the given finger */
+                const FingerState &getFinger(const int &i_finger) const { return fingers[i_finger]; }
+
+                /** \return The maximum delay added by the taxel filter and the debounce to the contact detection, in skin samples */
+                int getDetectionDelay(void) const { return taxelFilter.getDelay() + debounce - 1; }
+
+                /**
+                 * Clear the counts of the changes of the contact states.
+                 */
+                void resetContactSwitches(void);
+
+                /** \return The minimum size of the skin vector */
+                size_t getSkinSize(void) const { return skinSize; }
+
+                /** \return The taxel patch of the given finger */
+                const TaxelPatch &getPatch(const int &i_finger) const { return patches[i_finger]; }
+
+                /** \return The index of the first joint of the given finger in the commands table */
+                int getJointBegin(const int &i_finger) const { return commandOffsets[i_finger]; }
+
+                /** \return The index after the last joint of the given finger in the commands table */
+                int getJointEnd(const int &i_finger) const { return commandOffsets[i_finger + 1]; }
+
+                /** \return The joint at the given index of the commands table */
+                int getFingerJoint(const int &i_index) const { return commands[i_index].joint; }
+
+            private:
+                /**
+                 * Compile the commands table from the hand model. Fingers with a negative touch threshold move no joint.
+                 *
+                 * \return True upon success
+                 */
+                bool generateJointMap(void);
+
+                /**
+                 * Build the taxel patches from the [skinLayout] configuration group.
+                 * Defaults to 12 taxels per fingertip, starting from taxel 0, and no palm.
+                 *
+                 * \param rf The configuration of the module
+                 * \param i_palmThreshold The touch threshold of the palm
+                 * \return True upon success
+                 */
+                bool configureSkinLayout(yarp::os::Searchable &rf, const double &i_palmThreshold);
+
+                /**
+                 * Update the contact state of the fingers and of the palm from the patch reductions.
+                 */
+                void updateContacts(void);
+
+                /**
+                 * Track the slips of the fingertips in contact and schedule the tightening of the slipping fingers.
+                 *
+                 * \param i_skin The skin data of the contact detection
+                 */
+                void detectSlip(const double *i_skin);
+
+                /**
+                 * Check the vectorised patch reduction against the scalar reference.
+                 */
+                void validatePatchStats(const yarp::sig::Vector &i_skinComp);
+
+                /**
+                 * Read the temporal filter, the release thresholds and the debounce of the contact detection from the
+                 * [graspTh] group. The release thresholds default to the touch thresholds, i.e. no hysteresis.
+                 *
+                 * \param rf The configuration of the module
+                 * \return True upon success
+                 */
+                bool configureFiltering(yarp::os::Searchable &rf);
+
+                /**
+                 * Read the pressure regulation parameters from the [regulation] group.
+                 * The target pressures default to twice the touch thresholds.
+                 *
+                 * \param rf The configuration of the module
+                 * \return True upon success
+                 */
+                bool configureRegulation(yarp::os::Searchable &rf);
+
+                /**
+                 * Run the pressure regulator of a finger.
+                 * The error is only integrated while the output is not saturated in the direction of the error (anti-windup).
+                 *
+                 * \param i_finger The finger ID
+                 * \param i_dt Time since the last run (s)
+                 * \return The scale of the grasp velocities of the finger
+                 */
+                double regulate(const int &i_finger, const double &i_dt);
+        };
+    }
+}
+
+#endif
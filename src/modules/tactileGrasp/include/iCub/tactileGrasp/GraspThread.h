@@ -22,17 +22,33 @@
 #define __ICUB_TACTILEGRASP_GRASPTHREAD_H__
 
 #include <iCub/tactileGrasp/TactileGraspEnums.h>
+#include <iCub/tactileGrasp/GraspController.h>
+#include <iCub/tactileGrasp/LatencyHistogram.h>
+#include <iCub/tactileGrasp/LoopMonitor.h>
+#include <iCub/tactileGrasp/RateScheduler.h>
+#include <iCub/tactileGrasp/RealtimeScheduling.h>
+#include <iCub/tactileGrasp/StreamLog.h>
+#include <iCub/tactileGrasp/MotionMonitor.h>
+#include <iCub/tactileGrasp/PoseLibrary.h>
+#include <iCub/tactileGrasp/ParallelStartup.h>
+#include <iCub/tactileGrasp/SkinCompensator.h>
 
 #include <string>
 #include <vector>
-#include <deque>
+#include <atomic>
 
 #include <yarp/os/RateThread.h>
 #include <yarp/os/ResourceFinder.h>
 #include <yarp/os/BufferedPort.h>
+#include <yarp/os/TypedReaderCallback.h>
+#include <yarp/os/Mutex.h>
+#include <yarp/os/Stamp.h>
+#include <yarp/os/Bottle.h>
+#include <yarp/os/Property.h>
 #include <yarp/dev/PolyDriver.h>
 #include <yarp/dev/IEncoders.h>
 #include <yarp/dev/IPositionControl.h>
+#include <yarp/dev/IPositionControl2.h>
 #include <yarp/dev/IVelocityControl.h>
 #include <yarp/sig/Vector.h>
 
@@ -41,21 +57,37 @@
 namespace iCub {
     namespace tactileGrasp {
         /**
-         * Structure containing the velocities to be used for each grasping movement.
+         * Layout of the telemetry frames, a vector of doubles published at every control tick:
+         * the header fields below, then the maximum taxel of each finger, the contact flag (0/1) of each finger and the
+         * velocity commanded to each joint of the velocity interface.
          */
-        struct GraspVelocity {
-            std::vector<double> grasp;
-            std::vector<double> stop;
+        struct TelemetryField {
+            enum Field {
+                /** Version of the layout. */
+                Version = 0,
+                /** Sequence number of the frame, also in the envelope. */
+                Sequence = 1,
+                /** Time of the velocity command (s). */
+                TickTime = 2,
+                /** Timestamp of the envelope of the last skin data, -1 if none (s). */
+                SkinTime = 3,
+                /** Number of fingers F. */
+                Fingers = 4,
+                /** Number of joints J. */
+                Joints = 5,
+                /** Offset of the F maximum taxels, followed by the F contact flags and the J velocities. */
+                Data = 6
+            };
+            static const int LayoutVersion = 1;
         };
 
-        /** Typedef representing the mapping of each finger into the controllable joints it contains. */
-        typedef std::vector<std::vector<int> > FingerJointMap;
-
-        class GraspThread : public yarp::os::RateThread {
+        class GraspThread : public yarp::os::RateThread, public yarp::os::TypedReaderCallback<yarp::sig::Vector> {
             private:
                 /* ****** Module attributes                             ****** */
                 int period;
                 yarp::os::ResourceFinder rf;
+                /** The grasping hand (left or right). */
+                std::string whichHand;
 
 
                 /* ******* Controllers                                  ******* */
@@ -63,49 +95,250 @@ namespace iCub {
                 yarp::dev::IEncoders *iEncs;
                 yarp::dev::IPositionControl *iPos;
                 yarp::dev::IVelocityControl *iVel;
+                /** Multi-joint position interface. This is NULL if the driver only supports single-joint commands. */
+                yarp::dev::IPositionControl2 *iPos2;
 
                 /** Robot arm start position. */
                 yarp::sig::Vector startPos;
 
+                /** Completion tracking of the position motions. */
+                MotionMonitor *motionMonitor;
+                /** Time after which a position motion is considered failed (s). */
+                double motionTimeout;
+                /** The named arm and hand poses. */
+                PoseLibrary poses;
+
+
+                /* ******* Startup                                      ******* */
+                /** If true the arm is sent to the reach pose at startup, without waiting for it. */
+                bool reachOnStart;
+                /** If true the arm is sent to the reach pose before the first grasp if it is not there yet. */
+                bool reachOnGrasp;
+                /** Handle of the last reach motion, -1 if the arm has been moved away since. */
+                int reachMotion;
+                /** True once the arm is known to be in the grasping position. */
+                bool armReached;
+                /** Durations of the startup phases. */
+                StartupTimer *startup;
+                /** Startup timer used when none is given. */
+                StartupTimer localStartup;
+                /** Time from which the control ticks are phased (s). */
+                double tickOrigin;
+                /** Phase of the control ticks from tickOrigin (s), negative for no alignment. */
+                double tickOffset;
+
+
+                /* ******* Event-driven control                         ******* */
+                /** True if the control is triggered by the arrival of the compensated skin data. The periodic tick is then only used as a watchdog. */
+                bool eventDriven;
+                /** Time after which the watchdog takes over the control if no skin data has been received (seconds). */
+                double skinTimeout;
+                /** Arrival time of the last compensated skin data. */
+                double lastSkinTime;
+                /** True while the watchdog is driving the control because the skin data is late. */
+                bool watchdogActive;
+                /** Mutex serialising the control between the skin callback, the periodic tick and the motion commands. The RPC settings do not take it, see configs. */
+                yarp::os::Mutex controlMutex;
+
+
+                /* ******* Skin compensation                            ******* */
+                /** Compensation of the raw skin in the module, instead of the skinManager compensated stream. */
+                SkinCompensator compensator;
+                /** The skin compensated in the module. This is preallocated by the calibration. */
+                yarp::sig::Vector compensatedSkin;
+                /** The port of the skin data driving the control: the compensated skin, or the raw skin when compensating in the module. */
+                yarp::os::BufferedPort<yarp::sig::Vector> *portSkinIn;
+                /** True while the grasp is suspended but the periodic tick keeps following the drift of the baselines, i.e. when compensating in the module without the event-driven control. */
+                std::atomic<bool> trackingDrift;
+
+
+                /* ******* Sparse contact detection                     ******* */
+                /** True if the contacts are detected from the taxels of the skin contact list instead of the whole skin vector. */
+                bool sparseDetection;
+                /** Time after which the contact list is considered stale and the dense detection takes over (s). */
+                double contactsTimeout;
+                /** Arrival time of the last contact list. */
+                double lastContactsTime;
+                /** True while the dense detection is used because the contact list is stale. */
+                bool contactsLate;
+                /** The skin part of the grasping hand in the contact list. */
+                int handSkinPart;
+                /** The active taxels of the hand in the last contact list. This is preallocated to the skin size. */
+                std::vector<unsigned int> activeTaxels;
+                /** Number of skin frames processed by the sparse and by the dense detection. */
+                std::atomic<unsigned long> sparseFrames;
+                std::atomic<unsigned long> denseFrames;
 
-                /* ******* Contact detection configuration              ******* */
-                /** The previous skin contacts. This is stored to avoid herratic behaviour when clocking this thread faster than the skin threads. */
-                std::deque<bool> previousContacts;
-                /** The touch threshold for each fingertip. */
-                std::vector<double> touchThresholds;
 
-                /* ******* Grasp configuration                          ******* */
-                /** The grasp velocities. */
-                GraspVelocity velocities;
-                /** Number of fingers used for the grasping movement. */
-                int nFingers;
+                /* ******* Latency instrumentation                      ******* */
+                /** Envelope of the last compensated skin data. */
+                yarp::os::Stamp skinStamp;
+                /** Latency from the skin data timestamp to the stop command, for each finger. */
+                LatencyHistogram *stopLatencies;
+                /** Latency from the skin data timestamp to the tightening command after a slip, for each finger. */
+                LatencyHistogram *slipLatencies;
+                /** Timing statistics of the control tick. */
+                LoopMonitor loopMonitor;
+                /** Control period following the grasp phase. */
+                RateScheduler rateScheduler;
+                /** Real-time priority, CPU pinning and memory locking of the control thread. */
+                RealtimeScheduling scheduling;
+                /** The same options for the skin callback thread, which runs the control when it is event-driven. */
+                RealtimeScheduling callbackScheduling;
+                /** True once the options have been applied to the skin callback thread. */
+                bool callbackScheduled;
+
+
+                /* ******* Grasp control                                ******* */
+                /** Contact detection and grasp velocities. */
+                GraspController controller;
+                /** The settings published by the RPC thread. The control picks up the latest one at the start of each tick. */
+                GraspConfigStore configs;
                 /** Total number of joints to be controlled by the velocity interface. This is set by yarp::dev::IVelocityControl::getAxes(). */
                 int nJointsVel;
                 /** IDs of the joints to be used for the grasping movement. */
                 std::vector<int> graspJoints;
-                /** Mapping of each finger into the controllable joints it contains. */
-                FingerJointMap jointMap;
+
+
+                /* ******* Stream recording                             ******* */
+                /** Binary log of the consumed streams and of the commanded velocities. */
+                StreamRecorder recorder;
+                /** The recorded encoders. This is preallocated to the number of arm joints. */
+                std::vector<double> recordedEncoders;
 
                 
                 /* ****** Ports                                         ****** */
                 yarp::os::BufferedPort<yarp::sig::Vector> portGraspThreadInSkinComp;
                 yarp::os::BufferedPort<yarp::sig::Vector> portGraspThreadInSkinRaw;
                 yarp::os::BufferedPort<iCub::skinDynLib::skinContactList> portGraspThreadInSkinContacts;
+                /** The controller state at every control tick. See TelemetryField. */
+                yarp::os::BufferedPort<yarp::sig::Vector> portGraspThreadOutTelemetry;
+
+
+                /* ****** Telemetry                                     ****** */
+                /** True when a velocity command was sent and its telemetry frame is to be published. */
+                bool telemetryPending;
+                /** Time of the last velocity command. */
+                double commandTime;
+                /** Sequence number of the telemetry frames. */
+                yarp::os::Stamp telemetryStamp;
                 
 
                 /* ****** Debug attributes                              ****** */
                 std::string dbgTag;
 
             public:
-                GraspThread(const int aPeriod, const yarp::os::ResourceFinder &aRf);
+                /**
+                 * \param aPeriod The thread period (ms)
+                 * \param aRf The resource finder of the module
+                 * \param aHand The grasping hand, empty for the whichHand parameter
+                 * \param aStartup The timer recording the startup phases, NULL for a private one
+                 */
+                GraspThread(const int aPeriod, const yarp::os::ResourceFinder &aRf, const std::string &aHand = "", StartupTimer *aStartup = NULL);
                 virtual ~GraspThread();
 
                 virtual bool threadInit(void);
                 virtual void run(void);
                 virtual void threadRelease(void);
 
+                /**
+                 * Skin callback used in event-driven mode.
+                 * Detects the contacts and sends the velocity command as soon as the skin data arrives.
+                 *
+                 * \param aSkin The compensated skin data, or the raw skin data when compensating in the module
+                 */
+                virtual void onRead(yarp::sig::Vector &aSkin);
+
+                /**
+                 * Suspend the control, slowing the idle thread down to the [rate] idlePeriod when the rate is adaptive.
+                 * When the raw skin is compensated in the module and the control is not event-driven, the thread keeps
+                 * running to follow the drift of the baselines, without controlling the hand.
+                 * This hides yarp::os::RateThread::suspend().
+                 */
+                void suspend(void);
+
+                /**
+                 * Resume the control, starting from the approach period when the rate is adaptive.
+                 * This hides yarp::os::RateThread::resume().
+                 */
+                void resume(void);
+
                 bool setTouchThreshold(const int aFinger, const double aThreshold);
 
+                /**
+                 * Get the contact-to-command latency statistics of each finger.
+                 *
+                 * \param o_stats One list per finger: (finger id) (count n) (mean ms) (p50 ms) (p99 ms) (max ms) (switches n) (filterDelay samples)
+                 * \return True upon success
+                 */
+                bool getStopLatencies(yarp::os::Bottle &o_stats);
+
+                /**
+                 * Clear the contact-to-command latency statistics.
+                 */
+                void resetStopLatencies(void);
+
+                /**
+                 * Get the slip statistics of each finger and the cost of the slip detection.
+                 *
+                 * \param o_stats One list per finger: (finger id) (slips n) (count n) (mean ms) (p99 ms) (max ms), then (detection (mean us) (max us) (samples n))
+                 * \return True upon success
+                 */
+                bool getSlipStats(yarp::os::Bottle &o_stats);
+
+                /**
+                 * Clear the slip statistics.
+                 */
+                void resetSlipStats(void);
+
+                /**
+                 * Get the statistics of the contact forecasts of each finger.
+                 *
+                 * \param o_stats One list per finger: (finger id) (predictions n) (confirmed n) (expired n) (meanError ms) (meanAbsError ms) (maxAbsError ms),
+                 * then (budget ms) (latency ms)
+                 * \return True upon success
+                 */
+                bool getPredictionStats(yarp::os::Bottle &o_stats);
+
+                /**
+                 * Clear the statistics of the contact forecasts.
+                 */
+                void resetPredictionStats(void);
+
+                /**
+                 * Get the timing statistics of the control tick.
+                 *
+                 * \param o_stats The statistics as returned by LoopMonitor::getStats(), then (sparse n) (dense n) (phase name) (rateChanges n),
+                 * then the scheduling in effect as returned by RealtimeScheduling::getStats(), for the skin callback thread if the control is event-driven
+                 */
+                void getLoopStats(yarp::os::Bottle &o_stats);
+
+                /**
+                 * Reset the timing statistics of the control tick.
+                 */
+                void resetLoopStats(void);
+
+                /**
+                 * Phase the control ticks, so that the threads of several hands sharing a core tick one after the other
+                 * instead of at the same time. The first tick is delayed to i_origin + i_offset modulo the period.
+                 * This must be called before the thread is started.
+                 *
+                 * \param i_origin The time from which all the threads are phased (s)
+                 * \param i_offset The phase of this thread (s)
+                 */
+                void setTickPhase(const double &i_origin, const double &i_offset);
+
+                /** \return The grasping hand */
+                const std::string &getHand(void) const { return whichHand; }
+
+                /**
+                 * Get the driver of the controlled arm.
+                 * In simulation this is the iCub::tactileGrasp::FakeHandBoard, which can be viewed to drive grasp trials.
+                 *
+                 * \return The arm driver
+                 */
+                yarp::dev::PolyDriver &getArmDriver(void);
+
                 /**
                  * Set velocities of all joints.
                  *
@@ -124,16 +357,144 @@ namespace iCub {
                  * \return True upon success
                  */
                 bool setVelocity(const int &i_type, const int &i_joint, const double &i_vel);
-                bool openHand(void); 
+
+                /**
+                 * Select the grasp mode: stop at contact or regulate the fingertip pressure.
+                 *
+                 * \param i_type GraspType::Grasp, GraspType::Crush or GraspType::Regulate
+                 * \return True upon success
+                 */
+                bool setGraspMode(const int &i_type);
+
+                /**
+                 * Set the grasp and stop velocities and the grasp mode at once, so that the control never sees a mix
+                 * of the old and the new settings.
+                 *
+                 * \param i_grasp The grasp velocities of the joints
+                 * \param i_stop The stop velocities of the joints
+                 * \param i_type GraspType::Grasp, GraspType::Crush or GraspType::Regulate
+                 * \return True upon success
+                 */
+                bool configureGrasp(const std::vector<double> &i_grasp, const std::vector<double> &i_stop, const int &i_type);
+
+                /**
+                 * Open the hand. The position commands are sent and the method returns at once.
+                 *
+                 * \return The handle of the motion, to be queried with getMotionStatus(), or -1 upon failure
+                 */
+                int openHand(void); 
+
+                /**
+                 * Move the arm to a named pose. Any grasp is stopped first. The reference speeds are set so that all
+                 * the joints arrive together, and the commands are batched when the driver supports it. The method
+                 * returns as soon as the commands are sent.
+                 *
+                 * \param i_name The name of the pose
+                 * \return The handle of the motion, to be queried with getMotionStatus(), or -1 upon failure
+                 */
+                int moveToPose(const std::string &i_name);
+
+                /**
+                 * Make sure the arm is in the grasping position before a grasp. Depending on the [startup] reach option,
+                 * this waits for the pending reach motion or sends the reach pose and waits for it.
+                 *
+                 * \param i_wait If false the reach pose is only sent, so that several hands can reach at the same time
+                 * \return False if the arm could not reach the grasping position
+                 */
+                bool prepareGrasp(const bool &i_wait = true);
+
+                /**
+                 * Get the dispatch statistics of each pose.
+                 *
+                 * \param o_stats The statistics as returned by PoseLibrary::getStats()
+                 */
+                void getPoseStats(yarp::os::Bottle &o_stats);
+
+                /**
+                 * Reset the dispatch statistics of the poses.
+                 */
+                void resetPoseStats(void);
+
+                /**
+                 * \param i_id The handle of a motion
+                 * \return The status of the motion
+                 */
+                MotionStatus getMotionStatus(const int &i_id);
+
+                /**
+                 * Wait for a motion to end.
+                 *
+                 * \param i_id The handle of the motion
+                 * \param i_timeout Maximum waiting time (s)
+                 * \return True if the motion is done
+                 */
+                bool waitMotion(const int &i_id, const double &i_timeout);
 
             private:
-                bool generateJointMap(std::vector<double> &i_thresholds);
+                /**
+                 * Build the options of the simulated arm from the [simulation] group.
+                 * The touch thresholds, the fingertip patches and the finger joints of the simulated hand are those of this thread.
+                 *
+                 * \param o_options The options of the fakeHandBoard device
+                 * \param i_skinPort The port on which the simulated skin is published
+                 * \param i_rawSkinPort The port on which the simulated raw skin is published, empty for none
+                 * \return True upon success
+                 */
+                bool configureSimulation(yarp::os::Property &o_options, const std::string &i_skinPort, const std::string &i_rawSkinPort);
+
+                /**
+                 * Calibrate the baselines of the in-module skin compensation. The hand must not touch anything meanwhile.
+                 *
+                 * \param i_timeout Maximum time to wait for the raw skin frames (s)
+                 * \return True upon success
+                 */
+                bool calibrateSkin(const double &i_timeout);
+
+                /**
+                 * Detect the contacts in the compensated skin data, recording it if requested.
+                 * When compensating in the module, the raw skin data is compensated first.
+                 * The control mutex must be held by the caller.
+                 *
+                 * \param i_skin The skin data read from portSkinIn
+                 */
+                void processSkin(const yarp::sig::Vector &i_skin);
+
+                /**
+                 * Pick up the latest settings published by the RPC thread. Lock-free and allocation-free.
+                 * The control mutex must be held by the caller, so that there is a single reader of the settings.
+                 */
+                void applySettings(void);
+
+                /**
+                 * Record the raw skin, the contact list and the encoders, when recording.
+                 */
+                void recordStreams(void);
+
+                /**
+                 * Read the skin contact list of the sparse detection, if a new one arrived, and collect the active taxels of
+                 * the hand. Decoding the list allocates, so this is done outside of the allocation checks.
+                 * The control mutex is taken by the method.
+                 */
+                void readContacts(void);
 
-                bool detectContact(std::deque<bool> &o_contacts);
+                /**
+                 * Send the joint velocities computed by the controller to the velocity interface.
+                 * The control mutex must be held by the caller.
+                 */
+                void sendVelocities(void);
 
-                bool reachArm(void);
+                /**
+                 * Publish the controller state of the last velocity command on the telemetry port, if connected.
+                 * The frame is written in place in the port buffer. The control mutex must be held by the caller.
+                 * This is called outside of the allocation checks, the port being free to grow its buffer pool.
+                 */
+                void publishTelemetry(void);
 
-                bool waitMoveDone(const double &i_timeout, const double &i_delay);
+                /**
+                 * Set the thread period to that of the current grasp phase and log the transition.
+                 * The control mutex must be held by the caller.
+                 */
+                void applyRate(void);
         };
     }
 }
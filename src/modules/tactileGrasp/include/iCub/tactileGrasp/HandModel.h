@@ -0,0 +1,107 @@
+
+/* 
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org 
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+#ifndef __ICUB_TACTILEGRASP_HANDMODEL_H__
+#define __ICUB_TACTILEGRASP_HANDMODEL_H__
+
+#include <string>
+#include <vector>
+
+#include <yarp/os/Searchable.h>
+
+namespace iCub {
+    namespace tactileGrasp {
+        /**
+         * Kinematic and tactile description of a robot hand: the joints moved by each finger, the first joint of the
+         * grasp velocity vectors, the number of taxels of each fingertip and their positions on the fingertip.
+         *
+         * The finger to joint map is stored in compressed sparse row form: finger i moves the joints
+         * joints[offsets[i]] ... joints[offsets[i + 1] - 1].
+         */
+        class HandModel {
+            private:
+                /** Name of the built-in table the model was started from. */
+                std::string name;
+                /** Joint of the first element of the grasp velocity vectors. */
+                int jointOffset;
+                /** Default number of taxels of each fingertip. */
+                int taxelsPerFinger;
+                /** Row offsets of each finger in the joint table, plus the end of the table. */
+                std::vector<int> offsets;
+                /** The joints of all the fingers. */
+                std::vector<int> joints;
+                /** The (x y) position of each taxel of a fingertip on the unrolled pad (mm), two values per taxel. */
+                std::vector<double> taxelPositions;
+
+                std::string dbgTag;
+
+            public:
+                HandModel();
+
+                /**
+                 * Load the hand model.
+                 * The model starts from the built-in table named by handModel in the [graspTh] group (default icub).
+                 * Any of fingerJoints, taxelsPerFinger and taxelPositions in [graspTh] and jointOffset in [velocity] then
+                 * overrides the table. Without positions for the taxels of a fingertip, the taxels are laid on a line, 1 mm apart.
+                 *
+                 * \param rf The configuration of the module
+                 * \return True upon success
+                 */
+                bool configure(yarp::os::Searchable &rf);
+
+                /**
+                 * Load one of the built-in hand tables.
+                 *
+                 * \param i_name The name of the table
+                 * \return False if there is no such table
+                 */
+                bool loadBuiltIn(const std::string &i_name);
+
+                /** \return The name of the built-in table the model was started from */
+                const std::string &getName(void) const { return name; }
+
+                /** \return The number of fingers */
+                int getFingerCount(void) const { return static_cast<int>(offsets.size()) - 1; }
+
+                /** \return The index of the first joint of the given finger in the joint table */
+                int getJointBegin(const int &i_finger) const { return offsets[i_finger]; }
+
+                /** \return The index after the last joint of the given finger in the joint table */
+                int getJointEnd(const int &i_finger) const { return offsets[i_finger + 1]; }
+
+                /** \return The joint at the given index of the joint table */
+                int getJoint(const int &i_index) const { return joints[i_index]; }
+
+                /** \return The joint of the first element of the grasp velocity vectors */
+                int getJointOffset(void) const { return jointOffset; }
+
+                /** \return The default number of taxels of each fingertip */
+                int getTaxelsPerFinger(void) const { return taxelsPerFinger; }
+
+                /** \return The (x y) position of each taxel of a fingertip (mm), two values per taxel */
+                const std::vector<double> &getTaxelPositions(void) const { return taxelPositions; }
+
+                /** \return The size of the grasp velocity vectors needed to cover all the finger joints */
+                int getVelocityCount(void) const;
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,91 @@
+/* 
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org 
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+#ifndef __ICUB_TACTILEGRASP_LATENCYHISTOGRAM_H__
+#define __ICUB_TACTILEGRASP_LATENCYHISTOGRAM_H__
+
+#include <atomic>
+
+namespace iCub {
+    namespace tactileGrasp {
+        /**
+         * Lock-free histogram of latencies.
+         * The bins are logarithmically spaced from 1 us to about 10 s with a 5% relative width, so that percentiles
+         * are accurate to 5%. Recording is wait-free and can be done from the control thread while another thread
+         * reads the statistics.
+         */
+        class LatencyHistogram {
+            public:
+                /** Number of bins of the histogram. */
+                static const int NBins = 340;
+
+            private:
+                std::atomic<unsigned long> bins[NBins];
+                std::atomic<unsigned long> count;
+                /** Sum of the recorded latencies (microseconds). */
+                std::atomic<unsigned long long> sumUs;
+                /** Maximum recorded latency (microseconds). */
+                std::atomic<unsigned long long> maxUs;
+
+            public:
+                LatencyHistogram();
+
+                /**
+                 * Record a latency. Negative latencies, e.g. due to clock offsets between machines, are recorded as 0.
+                 *
+                 * \param i_latency The latency (seconds)
+                 */
+                void record(const double &i_latency);
+
+                /**
+                 * Clear all the recorded latencies.
+                 */
+                void reset(void);
+
+                /**
+                 * \return The number of recorded latencies
+                 */
+                unsigned long getCount(void) const;
+
+                /**
+                 * \return The mean latency (seconds)
+                 */
+                double getMean(void) const;
+
+                /**
+                 * \return The maximum latency (seconds)
+                 */
+                double getMax(void) const;
+
+                /**
+                 * Get the given percentile of the recorded latencies.
+                 *
+                 * \param i_percentile The percentile in [0, 100]
+                 * \return The upper edge of the bin containing the percentile (seconds), 0 if nothing was recorded
+                 */
+                double getPercentile(const double &i_percentile) const;
+
+            private:
+                LatencyHistogram(const LatencyHistogram &);
+                LatencyHistogram &operator=(const LatencyHistogram &);
+        };
+    } //namespace tactileGrasp
+} //namespace iCub
+
+#endif
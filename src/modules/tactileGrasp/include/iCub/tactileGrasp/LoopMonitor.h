@@ -0,0 +1,102 @@
+/* 
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org 
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+#ifndef __ICUB_TACTILEGRASP_LOOPMONITOR_H__
+#define __ICUB_TACTILEGRASP_LOOPMONITOR_H__
+
+#include <atomic>
+
+#include <yarp/os/RateThread.h>
+#include <yarp/os/Bottle.h>
+
+namespace iCub {
+    namespace tactileGrasp {
+        /**
+         * Timing monitor of a rate thread.
+         * Complements the period and run time estimation of yarp::os::RateThread with the maximum run time and the
+         * counts of overrun and missed ticks. The tick methods must be called from the monitored thread, while the
+         * statistics can be read and reset from any other thread.
+         */
+        class LoopMonitor {
+            private:
+                /** The nominal period (seconds). */
+                std::atomic<double> period;
+                /** The nominal period at the previous tick (seconds). */
+                double lastPeriod;
+                /** Start time of the current tick. */
+                double tickStart;
+                /** Start time of the previous tick. */
+                double lastTickStart;
+                /** Iteration of the rate thread loop at the previous tick. */
+                unsigned int lastIteration;
+
+                /** Number of ticks whose run time exceeded the period. */
+                std::atomic<unsigned long> overruns;
+                /** Number of ticks that were skipped because the thread started late. */
+                std::atomic<unsigned long> missed;
+                /** Maximum run time (microseconds). */
+                std::atomic<unsigned long long> maxUsedUs;
+                /** Set by reset() and applied by the monitored thread at the next tick. */
+                std::atomic<bool> resetRequested;
+
+            public:
+                /**
+                 * \param aPeriod The nominal period of the thread (seconds)
+                 */
+                LoopMonitor(const double &aPeriod);
+
+                /**
+                 * Set the nominal period of the thread, e.g. after yarp::os::RateThread::setRate(). The tick following
+                 * the change is checked against the longer of the two periods.
+                 *
+                 * \param i_period The nominal period (seconds)
+                 */
+                void setPeriod(const double &i_period);
+
+                /**
+                 * Mark the beginning of a tick. To be called at the start of run().
+                 *
+                 * \param i_iteration The loop iteration as returned by yarp::os::RateThread::getIterations()
+                 */
+                void tickStarted(const unsigned int &i_iteration);
+
+                /**
+                 * Mark the end of a tick. To be called at the end of run().
+                 */
+                void tickEnded(void);
+
+                /**
+                 * Reset the statistics of the monitor and of the rate thread.
+                 *
+                 * \param i_thread The monitored thread
+                 */
+                void reset(yarp::os::RateThread &i_thread);
+
+                /**
+                 * Get the timing statistics.
+                 *
+                 * \param i_thread The monitored thread
+                 * \param o_stats The statistics: (period ms) (estPeriod ms) (jitter ms) (used ms) (usedStd ms) (maxUsed ms) (iterations n) (overruns n) (missed n)
+                 */
+                void getStats(yarp::os::RateThread &i_thread, yarp::os::Bottle &o_stats);
+        };
+    } //namespace tactileGrasp
+} //namespace iCub
+
+#endif
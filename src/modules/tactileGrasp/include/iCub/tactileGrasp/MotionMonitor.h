@@ -0,0 +1,142 @@
+
+/* 
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org 
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+#ifndef __ICUB_TACTILEGRASP_MOTIONMONITOR_H__
+#define __ICUB_TACTILEGRASP_MOTIONMONITOR_H__
+
+#include <iCub/tactileGrasp/TactileGraspEnums.h>
+
+#include <string>
+#include <vector>
+
+#include <yarp/os/RateThread.h>
+#include <yarp/os/Mutex.h>
+#include <yarp/dev/IPositionControl.h>
+#include <yarp/dev/IPositionControl2.h>
+
+namespace iCub {
+    namespace tactileGrasp {
+        /**
+         * Receiver of the end of the tracked motions.
+         */
+        class MotionListener {
+            public:
+                virtual ~MotionListener() {}
+
+                /**
+                 * Called by the monitor thread when a motion is done or timed out. The monitor is locked during the call,
+                 * which must therefore be short and must not call back into the monitor.
+                 *
+                 * \param i_id The motion handle
+                 * \param i_tag The tag given when the motion was tracked
+                 * \param i_status The final status of the motion
+                 * \param i_duration Time from the start of the tracking to the end of the motion (s)
+                 */
+                virtual void onMotionEnded(const int &i_id, const int &i_tag, const MotionStatus::Status &i_status, const double &i_duration) = 0;
+        };
+
+        /**
+         * Completion tracking of asynchronous position motions.
+         * Each motion gets a handle when its position commands have been sent. The thread then checks the motion done flag
+         * of its joints at a high rate until they all reach their targets or the motion times out. The joints of a motion
+         * are checked by one grouped call if the multi-joint interface is available, otherwise all the running motions
+         * share one check of all the axes. The calls are made without holding the lock of the history.
+         * The last motions are kept in a fixed size history so that their status can be queried after completion.
+         */
+        class MotionMonitor : public yarp::os::RateThread {
+            private:
+                /** A tracked motion. */
+                struct Motion {
+                    int id;
+                    /** Caller data passed to the listener. */
+                    int tag;
+                    MotionStatus::Status status;
+                    double startTime;
+                    double timeout;
+                    std::vector<int> joints;
+                };
+
+                yarp::dev::IPositionControl *iPos;
+                /** The multi-joint position interface, or NULL. */
+                yarp::dev::IPositionControl2 *iPos2;
+                /** Receiver of the end of the motions, if any. */
+                MotionListener *listener;
+
+                /** History of the last motions, indexed by id modulo its size. */
+                std::vector<Motion> motions;
+                /** Id of the next motion. */
+                int nextId;
+                /** The running motions and their joints, copied out of the history for the checks. */
+                std::vector<int> checkIds;
+                std::vector<int> checkJoints;
+                /** Row offsets of each checked motion in checkJoints, plus the end of the table. */
+                std::vector<int> checkOffsets;
+                /** Mutex protecting the motion history. */
+                yarp::os::Mutex mutex;
+
+                std::string dbgTag;
+
+            public:
+                /**
+                 * \param aPeriod The period of the completion checks (ms)
+                 * \param aPos The position interface of the tracked joints
+                 * \param aPos2 The multi-joint position interface of the same joints, or NULL
+                 */
+                MotionMonitor(const int aPeriod, yarp::dev::IPositionControl *aPos, yarp::dev::IPositionControl2 *aPos2 = NULL);
+
+                virtual void run(void);
+
+                /**
+                 * Set the receiver of the end of the motions. This must be done before the thread is started.
+                 *
+                 * \param i_listener The listener, or NULL
+                 */
+                void setListener(MotionListener *i_listener);
+
+                /**
+                 * Start tracking a motion whose position commands have just been sent.
+                 * Running motions sharing a joint with the new one are marked as preempted.
+                 *
+                 * \param i_joints The moved joints
+                 * \param i_timeout Time after which the motion is considered failed (s)
+                 * \param i_tag Caller data passed to the listener
+                 * \return The motion handle
+                 */
+                int track(const std::vector<int> &i_joints, const double &i_timeout, const int &i_tag = -1);
+
+                /**
+                 * \param i_id The motion handle
+                 * \return The status of the motion
+                 */
+                MotionStatus getStatus(const int &i_id);
+
+                /**
+                 * Wait for a motion to end.
+                 *
+                 * \param i_id The motion handle
+                 * \param i_timeout Maximum waiting time (s)
+                 * \return True if the motion is done, false if it failed or is still running after the timeout
+                 */
+                bool wait(const int &i_id, const double &i_timeout);
+        };
+    }
+}
+
+#endif
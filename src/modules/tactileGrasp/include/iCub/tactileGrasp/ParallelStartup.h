@@ -0,0 +1,151 @@
+
+/* 
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org 
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+#ifndef __ICUB_TACTILEGRASP_PARALLELSTARTUP_H__
+#define __ICUB_TACTILEGRASP_PARALLELSTARTUP_H__
+
+#include <string>
+#include <vector>
+
+#include <yarp/os/Thread.h>
+#include <yarp/os/RateThread.h>
+#include <yarp/os/Mutex.h>
+#include <yarp/os/Property.h>
+#include <yarp/dev/PolyDriver.h>
+
+namespace iCub {
+    namespace tactileGrasp {
+        /**
+         * Durations of the module startup phases.
+         * Phases can be recorded from several threads, since the drivers and the threads are started concurrently.
+         */
+        class StartupTimer {
+            private:
+                /** A timed phase. */
+                struct Phase {
+                    std::string name;
+                    /** Start of the phase from the origin of the timer (s). */
+                    double start;
+                    double duration;
+                };
+
+                /** Time from which the phases are offset. */
+                double origin;
+                std::vector<Phase> phases;
+                yarp::os::Mutex mutex;
+
+            public:
+                StartupTimer();
+
+                /**
+                 * Clear the phases and set the origin to now.
+                 */
+                void reset(void);
+
+                /**
+                 * Record a phase ending now.
+                 *
+                 * \param i_name The name of the phase
+                 * \param i_start The start time of the phase, as returned by yarp::os::Time::now()
+                 */
+                void record(const std::string &i_name, const double &i_start);
+
+                /**
+                 * Log the phases, with their start and duration in ms.
+                 *
+                 * \param i_tag The tag prefixed to each line
+                 */
+                void print(const std::string &i_tag);
+        };
+
+
+        /**
+         * Opens a device driver in a separate thread, so that several drivers connect to their servers concurrently.
+         */
+        class DriverOpener : public yarp::os::Thread {
+            private:
+                yarp::dev::PolyDriver &driver;
+                yarp::os::Property options;
+                std::string phase;
+                StartupTimer *timer;
+                bool async;
+                bool opened;
+
+            public:
+                /**
+                 * \param aDriver The driver to be opened
+                 * \param aOptions The options of the driver
+                 * \param aPhase The name of the startup phase
+                 * \param aTimer The timer recording the phase
+                 */
+                DriverOpener(yarp::dev::PolyDriver &aDriver, const yarp::os::Property &aOptions, const std::string &aPhase, StartupTimer *aTimer);
+
+                virtual void run(void);
+
+                /**
+                 * Open the driver.
+                 *
+                 * \param i_async If true the driver is opened in the background, otherwise before returning
+                 */
+                void launch(const bool &i_async);
+
+                /**
+                 * Wait for the driver to be opened.
+                 *
+                 * \return True if the driver was opened
+                 */
+                bool wait(void);
+        };
+
+
+        /**
+         * Starts a rate thread from a separate thread, so that the initialisation of several threads runs concurrently.
+         */
+        class ThreadStarter : public yarp::os::Thread {
+            private:
+                yarp::os::RateThread *thread;
+                bool async;
+                bool started;
+
+            public:
+                /**
+                 * \param aThread The thread to be started
+                 */
+                ThreadStarter(yarp::os::RateThread *aThread);
+
+                virtual void run(void);
+
+                /**
+                 * Start the thread.
+                 *
+                 * \param i_async If true the thread is initialised in the background, otherwise before returning
+                 */
+                void launch(const bool &i_async);
+
+                /**
+                 * Wait for the initialisation of the thread to end.
+                 *
+                 * \return True if the thread was started
+                 */
+                bool wait(void);
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,156 @@
+
+/* 
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org 
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+#ifndef __ICUB_TACTILEGRASP_POSELIBRARY_H__
+#define __ICUB_TACTILEGRASP_POSELIBRARY_H__
+
+#include <iCub/tactileGrasp/LatencyHistogram.h>
+#include <iCub/tactileGrasp/MotionMonitor.h>
+
+#include <string>
+#include <vector>
+
+#include <yarp/os/ResourceFinder.h>
+#include <yarp/os/Bottle.h>
+#include <yarp/os/Mutex.h>
+
+namespace iCub {
+    namespace tactileGrasp {
+        /**
+         * A named set of joint targets.
+         */
+        struct Pose {
+            std::string name;
+            std::vector<int> joints;
+            std::vector<double> positions;
+            /** Reference speed of the joint with the longest travel (deg/s). The other joints are slowed down to arrive at the same time. */
+            double speed;
+        };
+
+        /**
+         * Library of the named arm and hand poses, with the dispatch statistics of each pose.
+         *
+         * The poses are listed by the names entry of the [poses] group, each one being described by a [pose_<name>] group
+         * holding its joints, positions and speed. The reach and open poses used by the module are built in and can be
+         * overridden by the configuration.
+         * The library also listens to the motion monitor to time the motions from their dispatch to their completion.
+         */
+        class PoseLibrary : public MotionListener {
+            private:
+                std::vector<Pose> poses;
+
+                /* ******* Dispatch statistics                          ******* */
+                /** Number of dispatches of each pose. */
+                std::vector<unsigned long> dispatches;
+                /** Number of control board calls made by the dispatches of each pose. */
+                std::vector<unsigned long> calls;
+                /** Number of motions of each pose which did not complete. */
+                std::vector<unsigned long> failures;
+                /** Time spent sending the commands of each pose. */
+                LatencyHistogram *dispatchTimes;
+                /** Time from the dispatch of each pose to the completion of the motion. */
+                LatencyHistogram *poseTimes;
+                /** True if the poses are sent as batched multi-joint commands. */
+                bool batched;
+                /** Mutex protecting the counters. */
+                yarp::os::Mutex statsMutex;
+
+                std::string dbgTag;
+
+            public:
+                PoseLibrary();
+                virtual ~PoseLibrary();
+
+                /**
+                 * Load the poses from the [poses] group and from the [pose_<name>] groups.
+                 *
+                 * \param rf The resource finder of the module
+                 * \param i_nJoints The number of joints of the arm
+                 * \return True upon success
+                 */
+                bool configure(yarp::os::ResourceFinder &rf, const int &i_nJoints);
+
+                /**
+                 * \param i_name The name of a pose
+                 * \return The index of the pose, -1 if there is no such pose
+                 */
+                int find(const std::string &i_name) const;
+
+                /** \return The number of poses */
+                int getPoseCount(void) const { return static_cast<int>(poses.size()); }
+
+                /** \return The pose at the given index */
+                const Pose &getPose(const int &i_pose) const { return poses[i_pose]; }
+
+                /**
+                 * Compute the reference speeds which make all the joints of a pose arrive at the same time.
+                 *
+                 * \param i_pose The index of the pose
+                 * \param i_encoders The current positions of all the arm joints
+                 * \param o_speeds The reference speed of each joint of the pose. This must be preallocated to the number of joints of the pose.
+                 */
+                void computeSpeeds(const int &i_pose, const double *i_encoders, std::vector<double> &o_speeds) const;
+
+                /**
+                 * Record the dispatch of a pose.
+                 *
+                 * \param i_pose The index of the pose
+                 * \param i_calls The number of control board calls made to send the pose
+                 * \param i_time The time spent sending the pose (s)
+                 * \param i_batched True if the pose was sent as batched commands
+                 */
+                void recordDispatch(const int &i_pose, const int &i_calls, const double &i_time, const bool &i_batched);
+
+                /**
+                 * Record the end of a pose motion. The tag of the motion is the index of the pose.
+                 */
+                virtual void onMotionEnded(const int &i_id, const int &i_tag, const MotionStatus::Status &i_status, const double &i_duration);
+
+                /**
+                 * Get the dispatch statistics of each pose.
+                 *
+                 * \param o_stats One list per pose: (pose name) (mode batched|perJoint) (dispatches n) (calls n) (dispatch ms) (dispatchMax ms) (reached n) (failed n) (timeToPose ms) (timeToPoseMax ms)
+                 */
+                void getStats(yarp::os::Bottle &o_stats);
+
+                /**
+                 * Clear the dispatch statistics.
+                 */
+                void resetStats(void);
+
+            private:
+                /**
+                 * Add or replace a pose.
+                 */
+                void addPose(const Pose &i_pose);
+
+                /**
+                 * Read a [pose_<name>] group over the current definition of the pose, if any.
+                 *
+                 * \return True upon success
+                 */
+                bool readPose(yarp::os::ResourceFinder &rf, const std::string &i_name);
+
+                PoseLibrary(const PoseLibrary &);
+                PoseLibrary &operator=(const PoseLibrary &);
+        };
+    }
+}
+
+#endif
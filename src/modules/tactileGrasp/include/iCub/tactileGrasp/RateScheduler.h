@@ -0,0 +1,140 @@
+/* 
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org 
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+#ifndef __ICUB_TACTILEGRASP_RATESCHEDULER_H__
+#define __ICUB_TACTILEGRASP_RATESCHEDULER_H__
+
+#include <iCub/tactileGrasp/GraspController.h>
+
+#include <vector>
+#include <atomic>
+
+#include <yarp/os/ResourceFinder.h>
+
+namespace iCub {
+    namespace tactileGrasp {
+        /**
+         * Phases of a grasp, each with its own control period.
+         */
+        struct GraspPhase {
+            enum Phase {
+                /** The grasp is suspended or not configured. */
+                Idle = 0,
+                /** The fingers close freely. */
+                Approach = 1,
+                /** A contact is imminent: the taxels of a finger are rising towards its touch threshold, or a finger is tightened after a slip. */
+                Near = 2,
+                /** All the fingers with a touch threshold are in contact. */
+                Holding = 3,
+                Count = 4
+            };
+        };
+
+        /**
+         * Choice of the control period of the grasp thread from the phase of the grasp.
+         * The control runs at the skin rate only while a contact is imminent and backs off otherwise. A finger is about
+         * to touch when its maximum taxel is above nearRatio times its touch threshold and rising. The near phase is then
+         * kept for nearHold seconds after the taxels stop rising, so that the rate does not flap with the skin noise.
+         */
+        class RateScheduler {
+            private:
+                /** True if the control period follows the grasp phase. */
+                bool enabled;
+                /** The control period of each phase (ms). */
+                int periods[GraspPhase::Count];
+                /** Fraction of the touch threshold above which rising taxels make a contact imminent. */
+                double nearRatio;
+                /** Time during which the near phase is kept after the taxels stop rising (s). */
+                double nearHold;
+                /** The maximum taxel of each finger at the previous update. */
+                std::vector<double> lastMaxTaxels;
+                /** Time until which the near phase is kept. */
+                double nearUntil;
+
+                /** The current phase. */
+                std::atomic<int> phase;
+                /** Number of phase changes. */
+                std::atomic<unsigned long> changes;
+
+            public:
+                RateScheduler();
+
+                /**
+                 * Read the [rate] configuration group.
+                 *
+                 * \param rf The resource finder of the module
+                 * \param i_nFingers The number of fingers
+                 * \param i_period The fixed control period, used as the default of the approach, near and holding periods (ms)
+                 * \param i_slipDetection True if the slips are detected: the holding period is then at most the near period,
+                 * so that the slip detector gets every skin sample
+                 * \return True upon success
+                 */
+                bool configure(yarp::os::ResourceFinder &rf, const int &i_nFingers, const int &i_period, const bool &i_slipDetection);
+
+                /** \return True if the control period follows the grasp phase */
+                bool isEnabled(void) const { return enabled; }
+
+                /**
+                 * Enable or disable the adaptive period.
+                 *
+                 * \param i_enabled True to make the control period follow the grasp phase
+                 */
+                void setEnabled(const bool &i_enabled) { enabled = i_enabled; }
+
+                /**
+                 * Update the phase from the state of the grasp after a control tick.
+                 *
+                 * \param i_controller The grasp controller
+                 * \param i_time The time of the tick (s)
+                 * \return True if the phase changed
+                 */
+                bool update(const GraspController &i_controller, const double &i_time);
+
+                /**
+                 * Force the phase, e.g. when the grasp is suspended or resumed.
+                 *
+                 * \param i_phase The new phase
+                 * \return True if the phase changed
+                 */
+                bool setPhase(const GraspPhase::Phase &i_phase);
+
+                /** \return The current phase */
+                GraspPhase::Phase getPhase(void) const { return static_cast<GraspPhase::Phase>(phase.load()); }
+
+                /** \return The control period of the current phase (ms) */
+                int getPeriod(void) const { return periods[phase.load()]; }
+
+                /** \return The number of phase changes */
+                unsigned long getChanges(void) const { return changes.load(); }
+
+                /**
+                 * Clear the count of phase changes.
+                 */
+                void resetStats(void) { changes = 0; }
+
+                /**
+                 * \param i_phase A grasp phase
+                 * \return The name of the phase
+                 */
+                static const char *getPhaseName(const GraspPhase::Phase &i_phase);
+        };
+    } //namespace tactileGrasp
+} //namespace iCub
+
+#endif
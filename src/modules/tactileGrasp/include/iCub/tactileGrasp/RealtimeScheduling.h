@@ -0,0 +1,94 @@
+/* 
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org 
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+#ifndef __ICUB_TACTILEGRASP_REALTIMESCHEDULING_H__
+#define __ICUB_TACTILEGRASP_REALTIMESCHEDULING_H__
+
+#include <string>
+
+#include <yarp/os/ResourceFinder.h>
+#include <yarp/os/Bottle.h>
+
+namespace iCub {
+    namespace tactileGrasp {
+        /**
+         * Real-time scheduling of a control thread: fixed priority policy, CPU pinning and locked, prefaulted memory.
+         * The options are read from the [realtime] group and applied by the thread to itself. Each of them falls back
+         * to the default behaviour with a warning when it is not permitted, e.g. without CAP_SYS_NICE or CAP_IPC_LOCK,
+         * or not supported by the platform. Only Linux is supported.
+         */
+        class RealtimeScheduling {
+            private:
+                /** The requested scheduling policy: other, fifo or rr. */
+                std::string policy;
+                /** The requested priority of the fifo and rr policies. */
+                int priority;
+                /** The requested CPU, negative for none. */
+                int cpu;
+                /** True if the memory of the process is to be locked. */
+                bool lockMemory;
+                /** Size of the stack prefaulted by the thread (KB). */
+                int prefaultStack;
+
+                /** The policy in effect. */
+                std::string appliedPolicy;
+                /** The priority in effect, 0 for the other policy. */
+                int appliedPriority;
+                /** The CPU the thread is pinned to, -1 for none. */
+                int appliedCpu;
+                /** True if the memory of the process is locked. */
+                bool memoryLocked;
+
+                /**
+                 * Touch the given amount of stack so that its pages are mapped before the control starts.
+                 *
+                 * \param i_size The size of the stack to prefault (KB)
+                 */
+                void prefault(const int &i_size);
+
+            public:
+                RealtimeScheduling();
+
+                /**
+                 * Read the [realtime] configuration group.
+                 *
+                 * \param rf The resource finder of the module
+                 * \return True upon success
+                 */
+                bool configure(yarp::os::ResourceFinder &rf);
+
+                /**
+                 * Apply the scheduling options to the calling thread. The options which cannot be applied are reported and
+                 * skipped.
+                 *
+                 * \param i_tag The debug tag of the thread
+                 */
+                void apply(const std::string &i_tag);
+
+                /**
+                 * Get the scheduling in effect.
+                 *
+                 * \param o_stats The lists (policy name) (priority n) (cpu n) (memoryLocked 0/1) are appended
+                 */
+                void getStats(yarp::os::Bottle &o_stats) const;
+        };
+    } //namespace tactileGrasp
+} //namespace iCub
+
+#endif
@@ -0,0 +1,108 @@
+/* 
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org 
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+#ifndef __ICUB_TACTILEGRASP_SKINCOMPENSATOR_H__
+#define __ICUB_TACTILEGRASP_SKINCOMPENSATOR_H__
+
+#include <vector>
+
+#include <yarp/os/ResourceFinder.h>
+#include <yarp/sig/Vector.h>
+
+namespace iCub {
+    namespace tactileGrasp {
+        /**
+         * In-process compensation of the raw skin data, replacing the skinManager compensated stream.
+         * The baseline of each taxel is first calibrated as the mean of a number of frames taken while the hand touches
+         * nothing. It then follows the slow drift of the sensors with an exponential moving average, which is frozen while
+         * the taxel is touched. The compensated value is the deviation from the baseline in excess of the noise
+         * threshold of the taxel, so that it is 0 when nothing is touched.
+         */
+        class SkinCompensator {
+            private:
+                /** True if the compensation is done in the module. */
+                bool enabled;
+                /** True for the iCub convention where the raw value decreases under pressure. */
+                bool inverted;
+                /** Number of frames averaged to calibrate the baselines. */
+                int calibrationSamples;
+                /** Weight of each frame in the moving average of the baselines. */
+                double driftRate;
+                /** Noise threshold of a taxel as a multiple of the standard deviation measured during the calibration. */
+                double touchMargin;
+                /** Minimum noise threshold of a taxel. */
+                double minTouch;
+
+                /** Number of frames taken for the calibration. */
+                int samples;
+                /** Baseline of each taxel. */
+                std::vector<double> baselines;
+                /** Sum of the squared raw values of each taxel during the calibration. */
+                std::vector<double> squares;
+                /** Noise threshold of each taxel. */
+                std::vector<double> thresholds;
+
+            public:
+                SkinCompensator();
+
+                /**
+                 * Read the [compensation] group.
+                 *
+                 * \param rf The resource finder of the module
+                 * \return True upon success
+                 */
+                bool configure(yarp::os::ResourceFinder &rf);
+
+                /**
+                 * \return True if the raw skin is compensated in the module
+                 */
+                bool isEnabled(void) const;
+
+                /**
+                 * \return True once the baselines are calibrated
+                 */
+                bool isCalibrated(void) const;
+
+                /**
+                 * Drop the baselines. The next frames calibrate them again, so the hand must not touch anything.
+                 */
+                void reset(void);
+
+                /**
+                 * Compensate a raw skin frame and update the baselines.
+                 * A frame of a different size than the previous ones restarts the calibration, which is the only time
+                 * memory is allocated.
+                 *
+                 * \param i_raw The raw skin data
+                 * \param o_comp The compensated skin data, of the size of the raw data
+                 * \return True if o_comp holds compensated data, false while calibrating
+                 */
+                bool compensate(const yarp::sig::Vector &i_raw, yarp::sig::Vector &o_comp);
+
+                /**
+                 * \param i_taxel The taxel index
+                 * \return The current baseline of the taxel, 0 before the calibration
+                 */
+                double getBaseline(const size_t &i_taxel) const;
+        };
+    } //namespace tactileGrasp
+} //namespace iCub
+
+#endif
+
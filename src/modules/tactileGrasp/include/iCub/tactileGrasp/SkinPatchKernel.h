@@ -0,0 +1,79 @@
+/* 
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org 
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+#ifndef __ICUB_TACTILEGRASP_SKINPATCHKERNEL_H__
+#define __ICUB_TACTILEGRASP_SKINPATCHKERNEL_H__
+
+namespace iCub {
+    namespace tactileGrasp {
+        /**
+         * A contiguous group of taxels in the hand skin vector, e.g. a fingertip or the palm.
+         */
+        struct TaxelPatch {
+            /** Index of the first taxel of the patch in the skin vector. */
+            int offset;
+            /** Number of taxels of the patch. */
+            int count;
+            /** Touch threshold of the patch. */
+            double threshold;
+        };
+
+        /**
+         * Result of the reduction of a taxel patch.
+         */
+        struct PatchStats {
+            /** Maximum taxel value, 0 for an empty patch. */
+            double max;
+            /** Sum of the taxel values. */
+            double sum;
+            /** Number of taxels greater than or equal to the patch threshold. */
+            int nActive;
+        };
+
+        /**
+         * Per-patch reduction of a whole-hand skin frame.
+         * All the patches are reduced in a single pass over the frame. The vectorised path uses AVX or SSE2 when the
+         * compiler targets them, the scalar path is kept as a reference for validation.
+         */
+        class SkinPatchKernel {
+            public:
+                /**
+                 * Reduce each patch of the skin frame using the fastest available instruction set.
+                 *
+                 * \param i_taxels The skin frame
+                 * \param i_patches The patches to be reduced
+                 * \param i_nPatches The number of patches
+                 * \param o_stats The result of each patch. Must hold i_nPatches elements.
+                 */
+                static void reduce(const double *i_taxels, const TaxelPatch *i_patches, const int &i_nPatches, PatchStats *o_stats);
+
+                /**
+                 * Reference scalar implementation of reduce().
+                 */
+                static void reduceScalar(const double *i_taxels, const TaxelPatch *i_patches, const int &i_nPatches, PatchStats *o_stats);
+
+                /**
+                 * \return The name of the instruction set used by reduce()
+                 */
+                static const char *getInstructionSet(void);
+        };
+    } //namespace tactileGrasp
+} //namespace iCub
+
+#endif
@@ -0,0 +1,156 @@
+/* 
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org 
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+#ifndef __ICUB_TACTILEGRASP_SLIPDETECTOR_H__
+#define __ICUB_TACTILEGRASP_SLIPDETECTOR_H__
+
+#include <vector>
+
+#include <yarp/os/Searchable.h>
+
+namespace iCub {
+    namespace tactileGrasp {
+        /**
+         * Detection of the slip of an object held by the fingertips, from the taxel pattern of each fingertip in contact.
+         * At every skin sample the detector follows the pressure centroid of the fingertip, i.e. the pressure weighted mean
+         * of the taxel positions given by the hand model, and the total pressure. A slip is detected when the centroid shifts faster than
+         * centroidShift, or when the derivative of the total pressure changes sign oscillations times within the last
+         * window samples, as the stick-slip vibrations do. After a slip the tracking starts afresh.
+         * All the buffers are allocated by configure().
+         */
+        class SlipDetector {
+            private:
+                /** The slip tracking state of a fingertip. */
+                struct FingerSlip {
+                    /** True once a first sample has been taken since the contact or the last slip. */
+                    bool tracking;
+                    /** The pressure centroid of the last sample (mm). */
+                    double centroidX;
+                    double centroidY;
+                    /** The total pressure of the last sample. */
+                    double pressure;
+                    /** Sign of the last significant pressure derivative, 0 if none yet. */
+                    int lastSign;
+                    /** One bit per sample of the window, set for the samples where the pressure derivative changed sign. */
+                    unsigned int signChanges;
+                    /** Number of slips detected. */
+                    unsigned long slips;
+                };
+
+                /** True if the slips are detected. */
+                bool enabled;
+                /** Number of samples over which the oscillations are counted, at most 32. */
+                int window;
+                /** Centroid shift between two samples over which the fingertip is slipping (mm). */
+                double centroidShift;
+                /** Minimum change of the total pressure between two samples to be considered in the oscillations. */
+                double derivativeThreshold;
+                /** Number of sign changes of the pressure derivative within the window over which the fingertip is slipping. */
+                int oscillations;
+                /** Minimum total pressure for the centroid to be meaningful. */
+                double minPressure;
+                /** Velocity of a slipping finger as a multiple of its grasp velocities. */
+                double tightenScale;
+                /** Time during which a slipping finger is tightened (s). */
+                double tightenTime;
+
+                std::vector<FingerSlip> fingers;
+                /** The (x y) position of each taxel of a fingertip (mm), two values per taxel. */
+                std::vector<double> positions;
+
+                /* ******* Detection cost                              ******* */
+                double costSum;
+                double costMax;
+                unsigned long costCount;
+
+            public:
+                SlipDetector();
+
+                /**
+                 * Configure the detector from the [slip] group.
+                 *
+                 * \param rf The configuration of the module
+                 * \param i_nFingers The number of fingers
+                 * \param i_positions The (x y) position of each taxel of a fingertip (mm), two values per taxel
+                 * \return True upon success
+                 */
+                bool configure(yarp::os::Searchable &rf, const int &i_nFingers, const std::vector<double> &i_positions);
+
+                /** \return True if the slips are detected */
+                bool isEnabled(void) const { return enabled; }
+
+                /** \return The number of taxels of a fingertip with a position */
+                int getTaxelCount(void) const { return static_cast<int>(positions.size()/2); }
+
+                /**
+                 * Update the slip state of a fingertip in contact.
+                 *
+                 * \param i_finger The finger ID
+                 * \param i_taxels The taxels of the fingertip
+                 * \param i_count The number of taxels, at most getTaxelCount()
+                 * \return True if the fingertip started slipping
+                 */
+                bool update(const int &i_finger, const double *i_taxels, const int &i_count);
+
+                /**
+                 * Stop tracking a fingertip which is not in contact anymore.
+                 *
+                 * \param i_finger The finger ID
+                 */
+                void release(const int &i_finger) { fingers[i_finger].tracking = false; }
+
+                /**
+                 * Stop tracking all the fingertips.
+                 */
+                void reset(void);
+
+                /**
+                 * Add the duration of a detection pass to the cost statistics.
+                 *
+                 * \param i_cost The duration (s)
+                 */
+                void recordCost(const double &i_cost);
+
+                /**
+                 * Clear the slip counts and the cost statistics.
+                 */
+                void resetStats(void);
+
+                /** \return The number of slips detected on the given finger */
+                unsigned long getSlipCount(const int &i_finger) const { return fingers[i_finger].slips; }
+
+                /** \return The mean duration of a detection pass (s) */
+                double getMeanCost(void) const { return (costCount > 0) ? costSum / costCount : 0.0; }
+
+                /** \return The maximum duration of a detection pass (s) */
+                double getMaxCost(void) const { return costMax; }
+
+                /** \return The number of detection passes */
+                unsigned long getCostCount(void) const { return costCount; }
+
+                /** \return The velocity of a slipping finger as a multiple of its grasp velocities */
+                double getTightenScale(void) const { return tightenScale; }
+
+                /** \return The time during which a slipping finger is tightened (s) */
+                double getTightenTime(void) const { return tightenTime; }
+        };
+    }
+}
+
+#endif
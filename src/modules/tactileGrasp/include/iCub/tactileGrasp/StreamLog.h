@@ -0,0 +1,211 @@
+
+/* 
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org 
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+#ifndef __ICUB_TACTILEGRASP_STREAMLOG_H__
+#define __ICUB_TACTILEGRASP_STREAMLOG_H__
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+#include <yarp/os/Stamp.h>
+#include <yarp/os/Mutex.h>
+
+#include <iCub/skinDynLib/skinContactList.h>
+
+namespace iCub {
+    namespace tactileGrasp {
+        /**
+         * Type of the frames of a stream log.
+         */
+        struct StreamFrameType {
+            enum Type {
+                /** Compensated skin vector. */
+                SkinComp = 1,
+                /** Raw skin vector. */
+                SkinRaw = 2,
+                /** Skin contact list. Each contact is stored as (bodyPart skinPart pressure nTaxels taxel...). */
+                Contacts = 3,
+                /** Arm encoders. */
+                Encoders = 4,
+                /** Joint velocities sent to the velocity interface. */
+                Command = 5
+            };
+        };
+
+        /**
+         * Header at the beginning of a stream log file.
+         */
+        struct StreamFileHeader {
+            /** "TGSTREAM" */
+            char magic[8];
+            /** Format version. */
+            uint32_t version;
+            /** Number of joints of the velocity interface. */
+            uint32_t nJoints;
+        };
+
+        /**
+         * Header of each frame of a stream log. The header is followed by count doubles.
+         */
+        struct StreamFrameHeader {
+            /** The StreamFrameType. */
+            uint32_t type;
+            /** Number of doubles following the header. */
+            uint32_t count;
+            /** Sequence number of the envelope of the data, -1 if none. */
+            int32_t sequence;
+            uint32_t reserved;
+            /** Time at which the module received the data (seconds). */
+            double arrivalTime;
+            /** Timestamp of the envelope of the data, -1 if none (seconds). */
+            double stampTime;
+        };
+
+        /**
+         * Binary recorder of the streams consumed by the grasp thread.
+         * The file is memory mapped and grown in large chunks so that writing a frame is a copy into the mapping,
+         * without system calls nor heap allocations in the control loop. The contact lists are serialised in a buffer reserved
+         * at open(), but skinContact::getTaxelList() returns a copy of the taxels of each contact.
+         * Recording needs POSIX memory mapping: on Windows open() reports that recording is not supported and fails.
+         * Frames are stored in native byte order. The frames can be written from several threads, e.g. the control tick and
+         * the skin callback: each write holds the recorder mutex, so that the mapping is not moved under another write.
+         */
+        class StreamRecorder {
+            private:
+                int fd;
+                char *map;
+                size_t mapSize;
+                size_t used;
+                /** Serialisation buffer of the contact lists. */
+                std::vector<double> contactBuffer;
+                /** Mutex serialising the writes and the growth of the mapping. */
+                yarp::os::Mutex mutex;
+
+                std::string dbgTag;
+
+            public:
+                StreamRecorder();
+                ~StreamRecorder();
+
+                /**
+                 * Create the log file. Any existing file is overwritten.
+                 *
+                 * \param i_path The path of the log file
+                 * \param i_nJoints The number of joints of the velocity interface
+                 * \return True upon success
+                 */
+                bool open(const std::string &i_path, const int &i_nJoints);
+
+                /**
+                 * Close the log file, truncating it to the recorded frames.
+                 */
+                void close(void);
+
+                /** \return True if the log file is open */
+                bool isOpen(void) const { return fd >= 0; }
+
+                /**
+                 * Append a frame.
+                 *
+                 * \param i_type The StreamFrameType
+                 * \param i_data The frame data
+                 * \param i_count The number of doubles in the frame data
+                 * \param i_arrivalTime Time at which the module received the data
+                 * \param i_stamp The envelope of the data. An invalid stamp is stored as -1.
+                 * \return True upon success
+                 */
+                bool write(const int &i_type, const double *i_data, const size_t &i_count, const double &i_arrivalTime, const yarp::os::Stamp &i_stamp);
+
+                /**
+                 * Append a contact list frame.
+                 *
+                 * \param i_contacts The contact list
+                 * \param i_arrivalTime Time at which the module received the data
+                 * \param i_stamp The envelope of the data
+                 * \return True upon success
+                 */
+                bool writeContacts(const iCub::skinDynLib::skinContactList &i_contacts, const double &i_arrivalTime, const yarp::os::Stamp &i_stamp);
+
+            private:
+                /**
+                 * Make sure the mapping can hold the given number of additional bytes. The mutex must be held by the caller.
+                 * If the file cannot be grown, it is closed and the recording stops.
+                 */
+                bool reserve(const size_t &i_bytes);
+
+                /**
+                 * Unmap and close the log file, truncating it to the recorded frames. The mutex must be held by the caller.
+                 */
+                void release(void);
+
+                /**
+                 * Append a frame. The mutex must be held by the caller.
+                 */
+                bool append(const int &i_type, const double *i_data, const size_t &i_count, const double &i_arrivalTime, const yarp::os::Stamp &i_stamp);
+        };
+
+        /**
+         * Reader of the stream logs written by StreamRecorder. The whole file is memory mapped.
+         */
+        class StreamReader {
+            private:
+                int fd;
+                const char *map;
+                size_t mapSize;
+                size_t position;
+                int nJoints;
+
+                std::string dbgTag;
+
+            public:
+                StreamReader();
+                ~StreamReader();
+
+                /**
+                 * Open and validate a log file.
+                 *
+                 * \param i_path The path of the log file
+                 * \return True upon success
+                 */
+                bool open(const std::string &i_path);
+
+                void close(void);
+
+                /**
+                 * Get the next frame. The returned pointers stay valid until the reader is closed.
+                 *
+                 * \param o_header The frame header
+                 * \param o_data The frame data
+                 * \return False at the end of the log or on a truncated frame
+                 */
+                bool next(const StreamFrameHeader *&o_header, const double *&o_data);
+
+                /**
+                 * Go back to the first frame.
+                 */
+                void rewind(void);
+
+                /** \return The number of joints of the velocity interface */
+                int getJointCount(void) const { return nJoints; }
+        };
+    }
+}
+
+#endif
@@ -31,7 +31,9 @@ namespace iCub {
             enum Type  {
                 Stop = 0,
                 Grasp = 1,
-                Crush = 2
+                Crush = 2,
+                /** Closed-loop regulation of the fingertip pressure. */
+                Regulate = 3
             };
 
             Type t_;
@@ -43,6 +45,45 @@ namespace iCub {
            template<typename T>
            operator T () const;
         };
+
+        /**
+         * Enum to provide numeric representation of the status of an asynchronous motion.
+         */
+        struct MotionStatus {
+        public:
+            enum Status  {
+                /** The motion handle is invalid or too old. */
+                Unknown = 0,
+                /** The joints are still moving. */
+                Running = 1,
+                /** All the joints reached their targets. */
+                Done = 2,
+                /** The joints did not reach their targets within the timeout. */
+                TimedOut = 3,
+                /** A later motion took over some of the joints. */
+                Preempted = 4
+            };
+
+            Status s_;
+            MotionStatus(Status s) : s_(s) {}
+            operator Status () const {return s_;}
+
+            /** \return The lower case name of the status */
+            const char *toString() const {
+                switch (s_) {
+                    case Running:   return "running";
+                    case Done:      return "done";
+                    case TimedOut:  return "timeout";
+                    case Preempted: return "preempted";
+                    default:        return "unknown";
+                }
+            }
+
+        private:
+           //prevent automatic conversion for any other built-in types such as bool, int, etc
+           template<typename T>
+           operator T () const;
+        };
     }
 }
 
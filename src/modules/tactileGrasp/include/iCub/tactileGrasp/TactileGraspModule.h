@@ -30,6 +30,7 @@
  * Available grasping modes are:
  * - Soft grasp
  * - Crush grasp
+ * - Regulated grasp
  * 
  * 
  * <b>Soft Grasp</b> <br />
@@ -41,6 +42,12 @@
  * The Crush Grasp does not use any feedback and will continue with the grasping action regardless if the fingertips are sensing anything.
  * 
  * 
+ * <b>Regulated Grasp</b> <br />
+ * The Regulated Grasp scales the grasp velocities of each finger from the error between a target pressure and its maximum taxel,
+ * with a saturated proportional-integral law. The fingers approach at up to maxScale times the grasp velocities, slow down as the
+ * pressure builds up, back off when pressing too hard and stop once within the tolerance of the target.
+ * 
+ * 
  * \section lib_sec Libraries
  * YARP
  * 
@@ -53,21 +60,145 @@
  * - -- name : The module name.
  * - -- period : The module period in seconds.
  * - -- robotName : The robot name.
- * - -- whichHand : The hand to use while grasping.
- * - -- grasp : The grasping velocity for each joint &gt;= 8.
+ * - -- whichHand : The hand to use while grasping: left, right or both. With both, each hand has its own grasp thread, skin ports and arm, and the gaze follows the middle of the hands.
+ * - -- grasp : The grasping velocity for each joint &gt;= jointOffset.
  * - -- stop : The stop velocity.
+ * - -- jointOffset : The joint of the first grasp velocity, in the [velocity] group. Overrides the hand model.
+ * - -- async : Send the gaze fixation point without waiting for the gaze to reach it (on/off), in the [gaze] group.
+ * - -- deadband : Minimum displacement of the hand before a new gaze fixation point is sent in meters, in the [gaze] group.
+ * - -- timeout : Time after which the arm and hand position motions are considered failed in seconds, in the [motion] group.
+ * - -- checkPeriod : Period of the motion completion checks in milliseconds, in the [motion] group.
+ * - -- parallel : Open the cartesian, gaze and arm drivers concurrently (on/off), in the [startup] group.
+ * - -- reach : When the arm is sent to the grasping position, in the [startup] group: lazy (before the first grasp), start (at startup, without waiting for it) or off (only on the reach command).
+ * - -- encoderTimeout : Time to wait for the first encoder data at startup in seconds, in the [startup] group.
+ * - -- names : The configured poses, in the [poses] group. Each pose is described by a [pose_&lt;name&gt;] group. The reach and open poses are built in and can be overridden.
+ * - -- joints : The joints of a pose, in its [pose_&lt;name&gt;] group.
+ * - -- positions : The target position of each joint of a pose in degrees, in its [pose_&lt;name&gt;] group.
+ * - -- speed : The reference speed of the joint of a pose with the longest travel in deg/s, in its [pose_&lt;name&gt;] group. The other joints are slowed down to arrive at the same time.
  * - -- touchThresholds : The touch threshold for each finger. Finger IDs are: 0 1 2 3 4
+ * - -- handModel : The built-in hand model giving the finger joints, the joint of the first grasp velocity and the taxels per fingertip with their positions. Available: icub.
+ * - -- fingerJoints : The list of joints moved by each finger ID, e.g. ((11 12) (13 14) (15) (15) (8 9 10)). Overrides the hand model.
+ * - -- taxelsPerFinger : The number of taxels of each fingertip, used when [skinLayout] has no fingertips. Overrides the hand model.
+ * - -- taxelPositions : The (x y) position of each taxel of a fingertip on the unrolled pad in mm, e.g. ((8.2 2.0) (3.0 2.0) ...), for the slip centroid. Overrides the hand model.
+ * - -- eventDriven : Trigger the control on the arrival of the compensated skin data (on/off). The periodic grasp thread is then only used as a watchdog.
+ * - -- skinTimeout : Time without skin data after which the watchdog takes over the control, in seconds.
+ * - -- releaseThresholds : The threshold under which each finger in contact is released. Defaults to the touch thresholds, i.e. no hysteresis. setThreshold keeps the configured touch-to-release difference.
+ * - -- filter : Temporal filter of each taxel before the contact detection: none, average or median. The sparse detection filters the reported taxels and takes the others as zero.
+ * - -- filterWindow : Number of skin samples of the taxel filter window.
+ * - -- debounce : Number of consecutive skin samples needed to change the contact state of a finger.
+ * - -- detection : How the contacts are detected: dense (every taxel of the skin vector) or sparse (only the taxels of the skinManager contact list).
+ * - -- contactsTimeout : Time without contact list after which the sparse detection falls back to the dense one, in seconds.
+ * - -- palmThreshold : The touch threshold of the palm.
+ * - -- palmTrigger : Power grasp. Only close the fingers once the palm has touched the object (on/off).
+ * - -- validateKernel : Check the vectorised contact detection against the scalar reference at every skin sample (on/off).
+ * - -- fingertips : The (offset count) taxel patch of each finger in the hand skin vector, in the [skinLayout] group. Defaults to 12 taxels per fingertip.
+ * - -- palm : The (offset count) taxel patch of the palm in the hand skin vector, in the [skinLayout] group.
+ * - -- targetPressures : The target pressure of each finger of the regulated grasp, in the [regulation] group. Defaults to twice the touch thresholds. Fingers with a zero target stop at contact.
+ * - -- kp : Proportional gain of the pressure regulator, in the [regulation] group.
+ * - -- ki : Integral gain of the pressure regulator in 1/s, in the [regulation] group. The error is not integrated while the output is saturated.
+ * - -- maxScale : Maximum finger velocity of the regulated grasp as a multiple of the grasp velocities, in the [regulation] group.
+ * - -- minScale : Minimum finger velocity of the regulated grasp as a multiple of the grasp velocities, in the [regulation] group. Negative to let the fingers back off.
+ * - -- tolerance : Pressure error under which a finger in contact is stopped, in the [regulation] group.
+ * - -- enabled : Detect the slips of the fingertips in contact and tighten the slipping fingers (on/off), in the [slip] group.
+ * - -- window : Number of skin samples over which the pressure oscillations are counted, between 2 and 32, in the [slip] group.
+ * - -- centroidShift : Shift of the pressure centroid of a fingertip between two skin samples, in mm on the taxelPositions of the hand model, above which the finger is slipping, in the [slip] group.
+ * - -- derivativeThreshold : Change of the total pressure of a fingertip between two skin samples counted as a pressure oscillation, in the [slip] group.
+ * - -- oscillations : Number of sign changes of the pressure derivative in the window above which the finger is slipping, in the [slip] group.
+ * - -- minPressure : Minimum total pressure of a fingertip for its slips to be tracked, in the [slip] group.
+ * - -- tightenScale : Velocity of a slipping finger as a multiple of its grasp velocities, in the [slip] group.
+ * - -- tightenTime : Time during which a slipping finger is tightened in seconds, in the [slip] group.
+ * - -- enabled : Stop the fingers ahead of the forecast crossings of their touch thresholds (on/off), in the [prediction] group. Not used by the regulated grasp.
+ * - -- window : Number of skin samples over which the rise of the maximum taxel of a finger is fitted, between 2 and 16, in the [prediction] group.
+ * - -- minRatio : Fraction of its touch threshold above which the crossing of a finger is forecast, in the [prediction] group.
+ * - -- leadTime : Time before the forecast crossing at which the stop should take effect in seconds, in the [prediction] group.
+ * - -- actuationDelay : Delay from the velocity command to the joints stopping in seconds, in the [prediction] group.
+ * - -- calibrate : Add the measured skin-to-command latency of the stops to the actuation delay (on/off), in the [prediction] group.
+ * - -- confirmTime : Time after the forecast crossing at which a finger which did not touch is released in seconds, in the [prediction] group.
+ * - -- creepScale : Velocity of a released finger creeping on to the contact, as a multiple of its grasp velocities, in the [prediction] group. 0 keeps it stopped until the grasp ends.
+ * - -- adaptive : Make the period of the grasp thread follow the grasp phase (on/off), in the [rate] group. Not used with the event-driven control. With both hands, the phase changes drop the interleaving of the ticks of the two threads.
+ * - -- idlePeriod : Period of the grasp thread while the grasp is suspended in milliseconds, in the [rate] group.
+ * - -- approachPeriod : Period of the grasp thread while the fingers close freely in milliseconds, in the [rate] group. Defaults to the grasp period.
+ * - -- nearPeriod : Period of the grasp thread while a contact is imminent in milliseconds, in the [rate] group. This should be the period of the skin.
+ * - -- holdPeriod : Period of the grasp thread while all the fingers with a touch threshold are in contact in milliseconds, in the [rate] group. Defaults to the grasp period, and is at most nearPeriod when the slips are detected.
+ * - -- nearRatio : Fraction of its touch threshold above which the rising maximum taxel of a finger makes a contact imminent, in the [rate] group.
+ * - -- nearHold : Time during which the near contact period is kept after the taxels stop rising in seconds, in the [rate] group.
+ * - -- policy : Scheduling policy of the grasp threads, in the [realtime] group: other (default), fifo or rr. The real-time policies need CAP_SYS_NICE, otherwise the default scheduling is kept. With the event-driven control, the [realtime] options are also applied to the skin callback thread.
+ * - -- priority : Priority of the fifo and rr policies, between 1 and 99, in the [realtime] group.
+ * - -- cpu : CPU to which the grasp threads are pinned, in the [realtime] group. Negative for none. With both hands the two threads share it, their ticks being interleaved.
+ * - -- lockMemory : Lock the memory of the module to prevent it from being paged out (on/off), in the [realtime] group. This needs CAP_IPC_LOCK or a large enough memlock limit.
+ * - -- prefaultStack : Size of the stack of the grasp threads touched before the control starts, in KB, in the [realtime] group.
+ * - -- source : Where the raw skin is compensated, in the [compensation] group: external (skinManager) or internal (in the module, from the raw skin port).
+ * - -- inverted : The raw taxel values decrease under pressure, as on the iCub (on/off), in the [compensation] group.
+ * - -- calibrationSamples : Number of raw skin frames averaged to calibrate the taxel baselines at startup, in the [compensation] group.
+ * - -- calibrationTimeout : Time to wait for the calibration frames in seconds, in the [compensation] group.
+ * - -- driftRate : Weight of each raw skin frame in the moving average of the untouched taxel baselines, in the [compensation] group. The baselines keep following the drift while the grasp is suspended.
+ * - -- touchMargin : Noise threshold of a taxel as a multiple of its standard deviation during the calibration, in the [compensation] group.
+ * - -- minTouch : Minimum noise threshold of a taxel, in the [compensation] group.
+ * - -- level : The log level, in the [log] group: off, error, warning, info or debug. The debug level prints the contacts and the velocities at every control tick.
+ * - -- file : File to which the log messages are appended with their time, in the [log] group. Empty for none.
+ * - -- console : Write the log messages to the console (on/off), in the [log] group.
+ * - -- rateLimit : Maximum number of messages per second from the same place in the code, in the [log] group. 0 for no limit.
+ * - -- bufferSize : Number of messages the log buffer holds before dropping new ones, in the [log] group.
+ * - -- flushPeriod : Period of the log thread formatting and writing the messages in milliseconds, in the [log] group.
+ * - -- record : Binary log of the compensated and raw skin, contact list, encoder and command streams of the grasp thread. Empty to disable.
+ * - -- simulation : Use the simulated hand instead of the robot (on/off). The gaze thread is not started in simulation.
+ * - -- contactAngles : Distal joint angle at which each finger touches the virtual object, in the [simulation] group. Negative for no object.
+ * - -- contactSpread : Random variation of the contact angles between benchmark trials, in the [simulation] group.
+ * - -- stiffness : Fingertip response per degree of penetration into the virtual object, in the [simulation] group.
+ * - -- maxPenetration : Penetration after which the virtual object blocks the finger, in the [simulation] group.
+ * - -- rawBaseline : Raw value of the untouched simulated taxels, in the [simulation] group.
+ * - -- rawDrift : Drift of the simulated raw taxel baselines in units per second, in the [simulation] group.
+ * - -- noise : Amplitude of the uniform noise added to each simulated taxel, in the [simulation] group.
+ * - -- skinPeriod : Period of the simulated skin in seconds, in the [simulation] group.
+ * - -- commandLatency : Delay between a velocity command and its execution on the simulated hand in seconds, in the [simulation] group.
  *  
  * 
  * \section portsa_sec Ports Accessed
  * - /icub/skin/left_hand_comp [yarp::sig::Vector]  [default carrier:tcp]: This is the compensated skin port for the selected grasping hand.
  * - /icub/skin/right_hand_comp [yarp::sig::Vector]  [default carrier:tcp]: This is the compensated skin port for the selected grasping hand.
+ * - /icub/skin/right_hand [yarp::sig::Vector]  [default carrier:tcp]: The raw skin port of the grasping hand, read when recording or when compensating the skin in the module.
+ * - /skinManager/skin_events:o [iCub::skinDynLib::skinContactList]  [default carrier:tcp]: The skin contacts, read when recording or with the sparse contact detection.
  * 
  * \section portsc_sec Ports Created
  * <b>RPC ports</b>
  * - /tactileGrasp/cmd:io [yarp::os::RpcServer]  [default carrier:rpc]: This is the RPC port used to control the grasping motion.
  *   - The documentation for the available RPC commands can be found in the thrift IDL implementation of the RPC server here: tactileGrasp_IDLServer. One can also type "help" in the rpc port to display the full list of commands.
  * 
+ * <b>Output ports</b>
+ * - /TactileGrasp/telemetry/&lt;hand&gt;:o [yarp::sig::Vector]  [default carrier:tcp]: The controller state at every control tick, only written while connected.
+ *   The vector holds (version sequence tickTime skinTime F J), the maximum taxel of the F fingers, their contact flags (0/1) and the velocities of the J joints,
+ *   as described by iCub::tactileGrasp::TelemetryField. The envelope carries the sequence number and the time of the velocity command.
+ * 
+ * 
+ * \section bimanual_sec Bimanual Grasping
+ * With whichHand both, the module runs one grasp thread for each hand, with its own skin ports (/TactileGrasp/skin/&lt;hand&gt;_hand_comp:i, ...)
+ * and arm driver, while a single gaze thread looks between the hands. The hand commands take an optional hand argument (left or right),
+ * e.g. "grasp left", and act on both hands when it is omitted. The control ticks of the two hands are offset by half a period so that
+ * they do not compete for the same core, unless the period of each hand follows its own grasp phase ([rate] adaptive). With record set, each hand writes its own log, e.g. grasp_left.tglog and grasp_right.tglog.
+ * 
+ * 
+ * \section sim_sec Simulation
+ * With simulation on, the arm is the fakeHandBoard device (iCub::tactileGrasp::FakeHandBoard) which publishes its own fingertip skin on
+ * /TactileGrasp/sim/skin/&lt;hand&gt;_hand_comp. The tactileGrasp_simBench executable runs repeated grasp trials on it, without a robot
+ * or a name server, and reports the time to contact, the threshold-crossing-to-stop latency, the overshoot and the timing of the
+ * control loop, e.g. its jitter under the [realtime] settings:
+ * tactileGrasp_simBench --from confTactileGrasp.ini --trials 20 --seed 1
+ * 
+ * 
+ * \section record_sec Recording and Replay
+ * With record set, the grasp thread writes every skin frame it consumes, the raw skin and contact lists, the encoders and the
+ * commanded velocities, with their arrival and envelope timestamps, to a memory-mapped binary log (see iCub::tactileGrasp::StreamRecorder).
+ * The tactileGrasp_replay executable feeds the recorded skin frames to the grasp controller faster than real time and prints the
+ * resulting velocity command stream, one line per skin frame, to be compared between builds:
+ * tactileGrasp_replay --from confTactileGrasp.ini --log grasp.tglog --mode grasp --out commands.txt
+ * 
+ * 
+ * \section bench_sec Microbenchmarks
+ * The tactileGrasp_bench executable times the contact detection, the taxel filters, the velocity assembly and the joint map generation
+ * of the grasp controller on synthetic skin frames, for several hand sizes and contact densities, and prints the time and the
+ * allocations per call. Build with TACTILEGRASP_CHECK_ALLOCATIONS to count the allocations:
+ * tactileGrasp_bench --iterations 100000
+ * 
  * 
  * \section conf_file_sec Configuration Files
  * - confTactileGrasp.ini : The module configuration file. 
@@ -95,8 +226,10 @@
 #include "tactileGrasp_IDLServer.h"
 #include "iCub/tactileGrasp/GazeThread.h"
 #include "iCub/tactileGrasp/GraspThread.h"
+#include "iCub/tactileGrasp/ParallelStartup.h"
 
 #include <string>
+#include <vector>
 
 #include <yarp/os/RFModule.h>
 #include <yarp/os/RpcServer.h>
@@ -124,7 +257,23 @@ namespace iCub {
 
                 /* ******* Threads                                      ******* */
                 iCub::tactileGrasp::GazeThread *gazeThread;
-                iCub::tactileGrasp::GraspThread *graspThread;
+                /** One grasp thread for each hand. */
+                std::vector<iCub::tactileGrasp::GraspThread *> graspThreads;
+                /** Durations of the startup phases of the module and of its threads. */
+                iCub::tactileGrasp::StartupTimer startupTimer;
+
+         
+                /* ******* Motions                                      ******* */
+                /** A motion of one or several hands. */
+                struct HandsMotion {
+                    int id;
+                    /** The handle of the motion of each grasp thread, -1 for the hands which do not move. */
+                    std::vector<int> motions;
+                };
+                /** History of the last motions, indexed by id modulo its size. */
+                std::vector<HandsMotion> handsMotions;
+                /** Id of the next motion. */
+                int nextHandsMotion;
 
          
                 /* ****** Debug attributes                              ****** */
@@ -144,11 +293,54 @@ namespace iCub {
                 virtual bool attach(yarp::os::RpcServer &source);
 
                 // RPC Methods
-                virtual bool open(void);
-                virtual bool grasp(void);
-                virtual bool crush(void);
+                virtual int open(const std::string &hand);
+                virtual int reach(const std::string &hand);
+                virtual int pose(const std::string &name, const std::string &hand);
+                virtual std::string motionStatus(const int id);
+                virtual bool waitMotion(const int id, const double timeout);
+                virtual bool grasp(const std::string &hand);
+                virtual bool crush(const std::string &hand);
+                virtual bool regulate(const std::string &hand);
                 virtual bool quit(void);
-                virtual bool setThreshold(const int aFinger, const double aThreshold);
+                virtual bool setThreshold(const int aFinger, const double aThreshold, const std::string &hand);
+                virtual yarp::os::Bottle getLatencyStats(void);
+                virtual bool resetLatencyStats(void);
+                virtual yarp::os::Bottle getLoopStats(void);
+                virtual bool resetLoopStats(void);
+                virtual yarp::os::Bottle getPoseStats(void);
+                virtual bool resetPoseStats(void);
+                virtual yarp::os::Bottle getSlipStats(void);
+                virtual bool resetSlipStats(void);
+                virtual yarp::os::Bottle getPredictionStats(void);
+                virtual bool resetPredictionStats(void);
+
+            private:
+                /**
+                 * Select the grasp threads of the commanded hands.
+                 *
+                 * \param i_hand The hand: left, right, or empty or both for all the hands of the module
+                 * \param o_threads The grasp threads of the selected hands
+                 * \return False if the module does not run the given hand
+                 */
+                bool selectHands(const std::string &i_hand, std::vector<GraspThread *> &o_threads);
+
+                /**
+                 * Move the selected hands to a pose.
+                 *
+                 * \param i_pose The name of the pose
+                 * \param i_hand The hand, as given to selectHands()
+                 * \return The handle of the motion of all the selected hands, -1 upon failure
+                 */
+                int moveHands(const std::string &i_pose, const std::string &i_hand);
+
+                /**
+                 * Bring the selected hands to the grasping position and start closing them.
+                 *
+                 * \param i_hand The hand, as given to selectHands()
+                 * \param i_type GraspType::Grasp, GraspType::Crush or GraspType::Regulate
+                 * \return True upon success
+                 */
+                bool startGrasp(const std::string &i_hand, const int &i_type);
         };
     }
 }
@@ -0,0 +1,146 @@
+/* 
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org 
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+#ifndef __ICUB_TACTILEGRASP_TAXELFILTER_H__
+#define __ICUB_TACTILEGRASP_TAXELFILTER_H__
+
+#include <string>
+#include <vector>
+
+#include <yarp/sig/Vector.h>
+
+namespace iCub {
+    namespace tactileGrasp {
+        /**
+         * Per-taxel temporal filter of the compensated skin.
+         * Each taxel keeps a ring buffer of its last window samples, from which either the moving average or the median
+         * is computed incrementally: the average from a running sum, the median from a sorted copy of the window in
+         * which only the oldest sample is replaced. The cost per sample does not depend on the length of the stream.
+         * The taxels can also be filtered one by one, for the sparse skin: a taxel that missed some samples catches up
+         * with zeros, i.e. the taxels that are not reported are taken as released, as the sparse contact detection does.
+         * All the buffers are allocated by configure().
+         */
+        class TaxelFilter {
+            public:
+                /** The available filters. */
+                enum Type {
+                    /** The samples are passed through. */
+                    None,
+                    /** Moving average of the window. */
+                    Average,
+                    /** Moving median of the window. */
+                    Median
+                };
+
+            private:
+                int type;
+                /** Number of samples of the window. */
+                int window;
+                /** Number of filtered taxels. */
+                size_t nTaxels;
+                /** Number of samples since the last reset. */
+                unsigned long samples;
+                /** Number of samples in the window of each taxel, the taxel is up to date when it is samples + 1. */
+                std::vector<unsigned long> stamps;
+                /** The ring buffer of each taxel, window samples per taxel. */
+                std::vector<double> history;
+                /** The sorted window of each taxel, for the median. */
+                std::vector<double> sorted;
+                /** The sum of the window of each taxel, for the average. */
+                std::vector<double> sums;
+                /** The filtered taxels. */
+                yarp::sig::Vector output;
+
+                /**
+                 * Add a sample to the window of a taxel.
+                 *
+                 * \param i_taxel The taxel
+                 * \param i_sample The sample
+                 * \param i_index The index of the sample since the last reset
+                 * \return The filtered taxel
+                 */
+                double push(const size_t &i_taxel, const double &i_sample, const unsigned long &i_index);
+
+            public:
+                TaxelFilter();
+
+                /**
+                 * Allocate the buffers of the filter.
+                 *
+                 * \param i_type The filter name: none, average or median
+                 * \param i_window The number of samples of the window, at least 1
+                 * \param i_nTaxels The number of taxels to be filtered
+                 * \return False if the filter is unknown
+                 */
+                bool configure(const std::string &i_type, const int &i_window, const size_t &i_nTaxels);
+
+                /**
+                 * Drop the samples of the window.
+                 */
+                void reset(void);
+
+                /**
+                 * Add a skin sample and filter it.
+                 *
+                 * \param i_taxels The skin sample. Only its first taxels are filtered, it must hold at least as many as configured.
+                 * \return The filtered taxels, or i_taxels if there is no filter
+                 */
+                const yarp::sig::Vector &filter(const yarp::sig::Vector &i_taxels);
+
+                /**
+                 * Add the current sample of a single taxel and filter it. The samples the taxel missed since it was
+                 * last filtered are taken as zero. A taxel that already has the current sample is not filtered again.
+                 * The skin sample is closed by next().
+                 *
+                 * \param i_taxel The taxel, lower than the configured number of taxels
+                 * \param i_sample The sample of the taxel
+                 * \return The filtered taxel, or i_sample if there is no filter
+                 */
+                double filter(const size_t &i_taxel, const double &i_sample);
+
+                /**
+                 * Close the skin sample of the taxels filtered one by one.
+                 */
+                void next(void);
+
+                /**
+                 * \return The filtered taxels. Only the taxels filtered since the last next() hold the current sample.
+                 */
+                const yarp::sig::Vector &getOutput(void) const { return output; }
+
+                /**
+                 * \return True if the samples are filtered
+                 */
+                bool isEnabled(void) const { return (type != None); }
+
+                /**
+                 * \return The maximum delay of the filter output on a step of the input, in samples
+                 */
+                int getDelay(void) const;
+
+                /**
+                 * \return The name of the filter
+                 */
+                const char *getName(void) const;
+        };
+    } //namespace tactileGrasp
+} //namespace iCub
+
+#endif
+
@@ -20,6 +20,7 @@
 
 
 #include "iCub/tactileGrasp/TactileGraspModule.h" 
+#include "iCub/tactileGrasp/FakeHandBoard.h"
 
 using yarp::os::Network;
 using yarp::os::ResourceFinder;
@@ -31,6 +32,7 @@ int main(int argc, char * argv[])
 {
     // Initialise device driver list
     YARP_REGISTER_DEVICES(icubmod);
+    iCub::tactileGrasp::FakeHandBoard::registerDevice();
     
     /* initialize yarp network */ 
     Network yarp;
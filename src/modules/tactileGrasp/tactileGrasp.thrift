@@ -1,5 +1,10 @@
 #tactileGrasp.thrift
 
+struct Bottle {
+} (
+    yarp.name = "yarp::os::Bottle"
+    yarp.includefile = "yarp/os/Bottle.h"
+)
 
 /**
  * tactileGrasp_IDLServer
@@ -10,23 +15,71 @@ service tactileGrasp_IDLServer
 {
     /**
      * Opens the robot hand.
-     * @return true/false on success/failure
+     * The command returns as soon as the motion has started. Use motionStatus or waitMotion to follow it.
+     * @param hand left or right, empty or both for all the hands of the module.
+     * @return the handle of the motion, -1 on failure
      */
-    bool open();
+    i32 open(1:string hand = "");
+
+    /**
+     * Move the arm to the grasping position, i.e. the reach pose.
+     * Depending on the [startup] reach option this is otherwise done at startup or before the first grasp. The command returns as soon as the motion has started.
+     * @param hand left or right, empty or both for all the hands of the module.
+     * @return the handle of the motion, -1 on failure
+     */
+    i32 reach(1:string hand = "");
+
+    /**
+     * Move the arm to a named pose of the [poses] configuration group.
+     * The joints are given synchronised reference speeds so that they arrive together. The command returns as soon as the motion has started.
+     * @param name the name of the pose.
+     * @param hand left or right, empty or both for all the hands of the module.
+     * @return the handle of the motion, -1 on failure
+     */
+    i32 pose(1:string name, 2:string hand = "");
+
+    /**
+     * Get the status of a motion.
+     * A motion of several hands is running until all of them are done.
+     * @param id the handle of the motion.
+     * @return one of running, done, timeout, preempted or unknown.
+     */
+    string motionStatus(1:i32 id);
+
+    /**
+     * Wait for a motion to end.
+     * @param id the handle of the motion.
+     * @param timeout the maximum waiting time in seconds.
+     * @return true if the motion is done, false if it failed or is still running.
+     */
+    bool waitMotion(1:i32 id, 2:double timeout = 10.0);
 
     /**
      * Grasp an object using feedback from the fingertips tactile sensors.
      * The grasping movement is stopped upon contact detection.
+     * If the arm is not in the grasping position yet, the command first waits for it to get there.
+     * @param hand left or right, empty or both for all the hands of the module.
      * @return true/false on success/failure.
      */
-    bool grasp();
+    bool grasp(1:string hand = "");
 
     /**
      * Grasp object without using the feedback from the fingertips tactile sensors.
      * The grasping movement is not controlled and the object is therefore crushed.
+     * If the arm is not in the grasping position yet, the command first waits for it to get there.
+     * @param hand left or right, empty or both for all the hands of the module.
+     * @return true/false on success/failure.
+     */
+    bool crush(1:string hand = "");
+
+    /**
+     * Grasp an object regulating the pressure of each fingertip to its target.
+     * The fingers approach fast, slow down as the pressure builds up and stop once the target is reached. See the [regulation] group.
+     * If the arm is not in the grasping position yet, the command first waits for it to get there.
+     * @param hand left or right, empty or both for all the hands of the module.
      * @return true/false on success/failure.
      */
-    bool crush();
+    bool regulate(1:string hand = "");
 
     /**
      * Quit the module.
@@ -36,7 +89,87 @@ service tactileGrasp_IDLServer
 
     /**
      * Set the touch threshold.
+     * The release threshold follows, keeping the configured difference between the touch and the release thresholds. A zero threshold disables the finger.
+     * @param hand left or right, empty or both for all the hands of the module.
+     * @return true/false on success/failure.
+     */
+    bool setThreshold(1:i32 aFinger, 2:double aThreshold, 3:string hand = "");
+
+    /**
+     * Get the contact-to-command latency statistics of each finger.
+     * The latency is measured from the envelope timestamp of the compensated skin data to the velocity command reacting to the contact.
+     * It does not include the delay of the taxel filter and of the debounce, whose bound is given in skin samples by filterDelay.
+     * The switches are the changes of the contact state of the finger, which show the chattering of the contact decisions.
+     * With both hands, the lists of each hand are wrapped as (left (...)) (right (...)).
+     * @return a list per finger: (finger id) (count n) (mean ms) (p50 ms) (p99 ms) (max ms) (switches n) (filterDelay samples)
+     */
+    Bottle getLatencyStats();
+
+    /**
+     * Reset the contact-to-command latency statistics.
+     * @return true/false on success/failure.
+     */
+    bool resetLatencyStats();
+
+    /**
+     * Get the timing statistics of the grasp and gaze control loops since start or since the last reset.
+     * Times are in ms. Overruns are ticks whose run time exceeded the period, missed are ticks skipped because the thread started late.
+     * The grasp statistics also count the skin frames processed by the sparse and by the dense contact detection, and give the grasp phase and the number of phase changes of the adaptive control rate.
+     * They end with the scheduling in effect, see the [realtime] group: the policy, its priority, the CPU the thread is pinned to (-1 for none) and whether the memory is locked. With the event-driven control, they are those of the skin callback thread, applied on its first call.
+     * The gaze statistics also count the fixation points sent to the gaze controller and those suppressed by the deadband.
+     * With both hands, there is one grasp_left and one grasp_right entry instead of grasp.
+     * @return (grasp ((period ms) (estPeriod ms) (jitter ms) (used ms) (usedStd ms) (maxUsed ms) (iterations n) (overruns n) (missed n) (sparse n) (dense n) (phase name) (rateChanges n) (policy name) (priority n) (cpu n) (memoryLocked 0/1))) (gaze (... (sent n) (suppressed n)))
+     */
+    Bottle getLoopStats();
+
+    /**
+     * Reset the timing statistics of the grasp and gaze control loops.
+     * @return true/false on success/failure.
+     */
+    bool resetLoopStats();
+
+    /**
+     * Get the dispatch statistics of each pose.
+     * The calls are the control board calls made to send the pose. The time to pose goes from the dispatch to the end of the motion. Times are in ms.
+     * With both hands, the lists of each hand are wrapped as (left (...)) (right (...)).
+     * @return a list per pose: (pose name) (mode batched|perJoint) (dispatches n) (calls n) (dispatch ms) (dispatchMax ms) (reached n) (failed n) (timeToPose ms) (timeToPoseMax ms)
+     */
+    Bottle getPoseStats();
+
+    /**
+     * Reset the dispatch statistics of the poses.
+     * @return true/false on success/failure.
+     */
+    bool resetPoseStats();
+
+    /**
+     * Get the slip statistics of each finger, see the [slip] group.
+     * The count and the latencies are those of the tightening commands, measured from the envelope timestamp of the compensated skin data in which the slip was detected. Times are in ms.
+     * The detection cost is the time spent tracking the slips at each skin sample, in us.
+     * With both hands, the lists of each hand are wrapped as (left (...)) (right (...)).
+     * @return a list per finger: (finger id) (slips n) (count n) (mean ms) (p99 ms) (max ms), then (detection (mean us) (max us) (samples n))
+     */
+    Bottle getSlipStats();
+
+    /**
+     * Reset the slip statistics.
+     * @return true/false on success/failure.
+     */
+    bool resetSlipStats();
+
+    /**
+     * Get the statistics of the contact forecasts of each finger, see the [prediction] group.
+     * A confirmed forecast was followed by the crossing of the touch threshold while the finger was stopped, an expired one was released without crossing, to creep on to the contact at the [prediction] creepScale.
+     * The errors are the forecast minus the actual crossing times of the confirmed forecasts, positive if the crossing was forecast late. Times are in ms.
+     * The budget is the latency compensated by the forecasts, and the latency its calibrated skin-to-command part.
+     * With both hands, the lists of each hand are wrapped as (left (...)) (right (...)).
+     * @return a list per finger: (finger id) (predictions n) (confirmed n) (expired n) (meanError ms) (meanAbsError ms) (maxAbsError ms), then (budget ms) (latency ms)
+     */
+    Bottle getPredictionStats();
+
+    /**
+     * Reset the statistics of the contact forecasts.
      * @return true/false on success/failure.
      */
-    bool setThreshold(1:i32 aFinger, 2:double aThreshold);
+    bool resetPredictionStats();
 }
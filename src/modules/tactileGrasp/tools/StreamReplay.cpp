@@ -0,0 +1,192 @@
+/* 
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org 
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+
+/*
+ * Replay of a stream log recorded by the grasp thread.
+ * Feeds the recorded compensated skin frames to the grasp controller as fast as possible and writes the resulting
+ * velocity command stream as text, so that the decisions of two builds can be compared with diff.
+ * With --detection sparse, the contacts are detected from the taxels of the recorded contact lists of the given hand,
+ * as the grasp thread does with the [graspTh] detection sparse. Until the first contact list the dense detection is used.
+ *
+ * Usage: tactileGrasp_replay --log grasp.tglog [--from confTactileGrasp.ini] [--mode grasp|crush|regulate] [--detection dense|sparse]
+ *        [--hand right] [--out commands.txt]
+ */
+
+#include "iCub/tactileGrasp/GraspController.h"
+#include "iCub/tactileGrasp/StreamLog.h"
+
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+
+#include <yarp/os/Network.h>
+#include <yarp/os/ResourceFinder.h>
+#include <yarp/os/Time.h>
+#include <yarp/sig/Vector.h>
+
+#include <iCub/skinDynLib/skinContactList.h>
+
+using std::cerr;
+using std::cout;
+using std::string;
+using std::vector;
+
+using iCub::tactileGrasp::GraspController;
+using iCub::tactileGrasp::GraspVelocity;
+using iCub::tactileGrasp::GraspType;
+using iCub::tactileGrasp::StreamReader;
+using iCub::tactileGrasp::StreamFrameHeader;
+using iCub::tactileGrasp::StreamFrameType;
+
+using yarp::os::ResourceFinder;
+using yarp::os::Value;
+using yarp::os::Time;
+
+
+int main(int argc, char * argv[])
+{
+    // The replay needs no name server
+    yarp::os::Network::setLocalMode(true);
+    yarp::os::Network yarp;
+
+    ResourceFinder rf;
+    rf.setVerbose(false);
+    rf.setDefaultConfigFile("confTactileGrasp.ini");
+    rf.setDefaultContext("tactileGrasp");
+    rf.configure("ICUB_ROOT", argc, argv);
+
+    string logFile = rf.check("log", Value("")).asString().c_str();
+    string outFile = rf.check("out", Value("")).asString().c_str();
+    string mode = rf.check("mode", Value("grasp")).asString().c_str();
+    bool sparse = (rf.check("detection", Value("dense")).asString() == "sparse");
+    int handSkinPart = ((rf.check("hand", Value("right")).asString() == "left") ? iCub::skinDynLib::SKIN_LEFT_HAND : iCub::skinDynLib::SKIN_RIGHT_HAND);
+    if (logFile.empty()) {
+        cerr << "Usage: tactileGrasp_replay --log <file> [--from <conf>] [--mode grasp|crush|regulate] [--detection dense|sparse] [--hand left|right] [--out <file>] \n";
+        return -1;
+    }
+
+
+    /* ******* Controller                                      ******* */
+    StreamReader reader;
+    if (!reader.open(logFile)) {
+        return -1;
+    }
+
+    GraspVelocity velocities;
+    GraspController controller;
+    if (!iCub::tactileGrasp::readGraspVelocities(rf, velocities) || !controller.configure(rf)) {
+        return -1;
+    }
+    if (!controller.setJointCount(reader.getJointCount())
+            || !controller.setVelocities(GraspType::Grasp, velocities.grasp)
+            || !controller.setVelocities(GraspType::Stop, (mode == "crush") ? velocities.grasp : velocities.stop)
+            || !controller.setMode((mode == "regulate") ? GraspType::Regulate : GraspType::Grasp)) {
+        return -1;
+    }
+
+    std::ofstream outStream;
+    if (!outFile.empty()) {
+        outStream.open(outFile.c_str());
+        if (!outStream) {
+            cerr << "Error: could not create " << outFile << ". \n";
+            return -1;
+        }
+    }
+    std::ostream &out = outFile.empty() ? cout : outStream;
+    out << std::fixed << std::setprecision(6);
+
+
+    /* ******* Replay                                          ******* */
+    int counts[StreamFrameType::Command + 1] = {0};
+    double firstArrival = -1.0;
+    double lastArrival = 0.0;
+    yarp::sig::Vector skinComp;
+    vector<unsigned int> activeTaxels;
+    bool hasContacts = false;
+
+    double start = Time::now();
+    const StreamFrameHeader *header;
+    const double *data;
+    while (reader.next(header, data)) {
+        if (header->type <= StreamFrameType::Command) {
+            ++counts[header->type];
+        }
+        if (firstArrival < 0) {
+            firstArrival = header->arrivalTime;
+        }
+        lastArrival = header->arrivalTime;
+
+        if (sparse && (header->type == StreamFrameType::Contacts)) {
+            // Each contact is (body part) (skin part) (pressure) (number of taxels) (taxels)
+            activeTaxels.clear();
+            size_t k = 0;
+            while (k + 4 <= header->count) {
+                int skinPart = static_cast<int>(data[k + 1]);
+                size_t nTaxels = static_cast<size_t>(data[k + 3]);
+                k += 4;
+                for (size_t t = 0; (t < nTaxels) && (k < header->count); ++t, ++k) {
+                    if (skinPart == handSkinPart) {
+                        activeTaxels.push_back(static_cast<unsigned int>(data[k]));
+                    }
+                }
+            }
+            hasContacts = true;
+        }
+
+        if (header->type == StreamFrameType::SkinComp) {
+            // Only the first frame resizes the skin vector
+            skinComp.resize(header->count);
+            for (size_t i = 0; i < header->count; ++i) {
+                skinComp[i] = data[i];
+            }
+            if (sparse && hasContacts) {
+                controller.detectContactSparse(skinComp, activeTaxels);
+            } else {
+                controller.detectContact(skinComp);
+            }
+            controller.predictContacts(header->stampTime >= 0.0 ? header->stampTime : header->arrivalTime);
+            // The regulator integrates over the recorded arrival times
+            const vector<double> &command = controller.computeVelocities(header->arrivalTime);
+
+            // One line per skin frame: (sequence) (skin timestamp) (velocities)
+            out << header->sequence << " " << header->stampTime;
+            for (size_t i = 0; i < command.size(); ++i) {
+                out << " " << command[i];
+            }
+            out << "\n";
+        }
+    }
+    double elapsed = Time::now() - start;
+
+
+    /* ******* Report                                          ******* */
+    double recorded = (firstArrival < 0) ? 0.0 : lastArrival - firstArrival;
+    cerr << "Replayed " << counts[StreamFrameType::SkinComp] << " skin frames (" << counts[StreamFrameType::SkinRaw] << " raw, "
+        << counts[StreamFrameType::Contacts] << " contact lists, " << counts[StreamFrameType::Encoders] << " encoders, "
+        << counts[StreamFrameType::Command] << " recorded commands) spanning " << recorded << " s in " << elapsed << " s";
+    if (elapsed > 0) {
+        cerr << " (" << recorded / elapsed << "x real time)";
+    }
+    cerr << ". \n";
+
+    return 0;
+}